@@ -20,12 +20,26 @@ FOUNDATION_EXPORT double VARSVersionNumber;
 //! Project version string for VARS.
 FOUNDATION_EXPORT const unsigned char VARSVersionString[];
 
+#import "VARS/vsast.h"
+#import "VARS/vscache.h"
+#import "VARS/vscol.h"
 #import "VARS/vsdebug.h"
+#import "VARS/vsdec.h"
+#import "VARS/vsexpr.h"
+#import "VARS/vsfmath.h"
+#import "VARS/vslex.h"
 #import "VARS/vsmem.h"
 #import "VARS/vsmath.h"
+#import "VARS/vsmathv.h"
+#import "VARS/vsnum.h"
 
 #import "VARS/VSArrayUtil.h"
 #import "VARS/VSCalculusUtil.h"
+#import "VARS/VSCompiledExpression.h"
+#import "VARS/VSMathLexerConfiguration.h"
+#import "VARS/VSMathParserSession.h"
 #import "VARS/VSMathUtil.h"
+#import "VARS/VSMemoizedEvaluator.h"
+#import "VARS/VSNumberFormat.h"
 #import "VARS/VSNumberUtil.h"
 #import "VARS/VSStringUtil.h"
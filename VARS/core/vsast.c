@@ -0,0 +1,157 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <stdlib.h>
+#import <string.h>
+
+#import "vsast.h"
+
+/**
+ *  Node being visited by vs_ast_postfix(), with the position of its next operand to visit.
+ */
+typedef struct {
+    size_t node;
+    int next;
+} vs_ast_visit_t;
+
+#pragma mark Life Cycle
+
+int vs_ast_init(vs_ast_t *__a, size_t __n) {
+    if (__n < 8) __n = 8;
+
+    __a->nodes = (vs_ast_node_t *)malloc(sizeof(vs_ast_node_t) * __n);
+    __a->roots = (size_t *)malloc(sizeof(size_t) * __n);
+    __a->count = 0;
+    __a->nroots = 0;
+
+    if ((__a->nodes == NULL) || (__a->roots == NULL)) {
+        free(__a->nodes);
+        free(__a->roots);
+
+        __a->nodes = NULL;
+        __a->roots = NULL;
+        __a->capacity = 0;
+
+        return 0;
+    }
+
+    __a->capacity = __n;
+
+    return 1;
+}
+
+void vs_ast_free(vs_ast_t *__a) {
+    if (__a == NULL) {
+        return;
+    }
+
+    free(__a->nodes);
+    free(__a->roots);
+
+    __a->nodes = NULL;
+    __a->roots = NULL;
+    __a->count = 0;
+    __a->capacity = 0;
+    __a->nroots = 0;
+}
+
+void vs_ast_clear(vs_ast_t *__a) {
+    __a->count = 0;
+    __a->nroots = 0;
+}
+
+#pragma mark Construction
+
+size_t vs_ast_emit(vs_ast_t *__a, const vs_lex_token_t *__t, vs_op_t __op, int __arity) {
+    if (__a->count >= __a->capacity) {
+        size_t n = (__a->capacity > 0) ? (__a->capacity * 2) : 8;
+        vs_ast_node_t *nodes = (vs_ast_node_t *)realloc(__a->nodes, sizeof(vs_ast_node_t) * n);
+
+        if (nodes == NULL) {
+            return VS_AST_NONE;
+        }
+
+        __a->nodes = nodes;
+
+        size_t *roots = (size_t *)realloc(__a->roots, sizeof(size_t) * n);
+
+        if (roots == NULL) {
+            return VS_AST_NONE;
+        }
+
+        __a->roots = roots;
+        __a->capacity = n;
+    }
+
+    if (__arity > VS_AST_MAX_ARITY) __arity = VS_AST_MAX_ARITY;
+    if (__arity < 0) __arity = 0;
+
+    // Missing operands of malformed expressions are left out.
+    if ((size_t)__arity > __a->nroots) __arity = (int)__a->nroots;
+
+    size_t index = __a->count++;
+    vs_ast_node_t *node = &__a->nodes[index];
+
+    node->token = *__t;
+    node->op = __op;
+    node->arity = __arity;
+
+    __a->nroots -= __arity;
+
+    for (int i = 0; i < VS_AST_MAX_ARITY; i++) {
+        node->operands[i] = (i < __arity) ? __a->roots[__a->nroots + i] : VS_AST_NONE;
+    }
+
+    __a->roots[__a->nroots++] = index;
+
+    return index;
+}
+
+#pragma mark Traversal
+
+size_t vs_ast_postfix(const vs_ast_t *__a, size_t *__o) {
+    if (__a->nroots == 0) {
+        return 0;
+    }
+
+    // A path from a root never visits more nodes than there are.
+    vs_ast_visit_t *path = (vs_ast_visit_t *)malloc(sizeof(vs_ast_visit_t) * __a->count);
+
+    if (path == NULL) {
+        return VS_AST_NONE;
+    }
+
+    size_t n = 0;
+
+    for (size_t r = 0; r < __a->nroots; r++) {
+        size_t depth = 0;
+
+        path[depth].node = __a->roots[r];
+        path[depth].next = 0;
+        depth++;
+
+        while (depth > 0) {
+            vs_ast_visit_t *visit = &path[depth - 1];
+            const vs_ast_node_t *node = &__a->nodes[visit->node];
+
+            if (visit->next < node->arity) {
+                path[depth].node = node->operands[visit->next++];
+                path[depth].next = 0;
+                depth++;
+            }
+            else {
+                __o[n++] = visit->node;
+                depth--;
+            }
+        }
+    }
+
+    free(path);
+
+    return n;
+}
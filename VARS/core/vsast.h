@@ -0,0 +1,107 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS expression tree tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vsast_h
+#define vsast_h
+
+#include <stddef.h>
+
+#include "vsexpr.h"
+#include "vslex.h"
+
+/**
+ *  Max number of operands of a node.
+ */
+#define VS_AST_MAX_ARITY 2
+
+/**
+ *  Index of no node.
+ */
+#define VS_AST_NONE ((size_t)-1)
+
+/**
+ *  Node of an expression tree: a lexer token with the operation it stands for and the indices of its operands. Nodes only have fewer
+ *  operands than the arity of their operation if the expression they were parsed from is malformed.
+ */
+typedef struct {
+    vs_lex_token_t token;
+    vs_op_t op;
+    int arity;
+    size_t operands[VS_AST_MAX_ARITY];
+} vs_ast_node_t;
+
+/**
+ *  Expression tree whose nodes are allocated in a single arena and linked by index, so that growing the arena does not invalidate
+ *  links. Nodes are built in postfix order by vs_ast_emit(), which attaches the topmost roots as operands of every new node, leaving
+ *  a forest of roots which is a single tree for well-formed expressions.
+ */
+typedef struct {
+    vs_ast_node_t *nodes;
+    size_t count;
+    size_t capacity;
+    size_t *roots;
+    size_t nroots;
+} vs_ast_t;
+
+#pragma mark Life Cycle
+
+/**
+ *  Initializes an empty expression tree.
+ *
+ *  @param __a
+ *  @param __n Initial node capacity.
+ *
+ *  @return 1 if initialized, 0 if out of memory.
+ */
+int vs_ast_init(vs_ast_t *__a, size_t __n);
+
+/**
+ *  Frees the memory of an expression tree.
+ *
+ *  @param __a
+ */
+void vs_ast_free(vs_ast_t *__a);
+
+/**
+ *  Removes all nodes of an expression tree, keeping its memory.
+ *
+ *  @param __a
+ */
+void vs_ast_clear(vs_ast_t *__a);
+
+#pragma mark Construction
+
+/**
+ *  Appends a node to an expression tree as the next token of its postfix notation: up to __arity roots are popped as its operands,
+ *  in order, and the node becomes the topmost root.
+ *
+ *  @param __a
+ *  @param __t
+ *  @param __op
+ *  @param __arity Number of operands of the operation, at most VS_AST_MAX_ARITY.
+ *
+ *  @return Index of the node, VS_AST_NONE if out of memory.
+ */
+size_t vs_ast_emit(vs_ast_t *__a, const vs_lex_token_t *__t, vs_op_t __op, int __arity);
+
+#pragma mark Traversal
+
+/**
+ *  Gets the postfix notation of an expression tree: the nodes of every root in post-order, from the bottommost root to the topmost
+ *  one. Runs in linear time without recursion, regardless of the depth of the tree.
+ *
+ *  @param __a
+ *  @param __o Receives the node indices, must have room for the number of nodes reachable from the roots.
+ *
+ *  @return The number of node indices, VS_AST_NONE if out of memory.
+ */
+size_t vs_ast_postfix(const vs_ast_t *__a, size_t *__o);
+
+#endif
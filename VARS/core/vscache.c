@@ -0,0 +1,361 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <sched.h>
+#import <stdatomic.h>
+#import <stdint.h>
+#import <stdlib.h>
+#import <string.h>
+
+#import "vscache.h"
+
+/**
+ *  Slot states. An empty slot is 0, a slot being written is BUSY, and a slot holding an entry is READY with the number of readers
+ *  currently pinning it in the low bits. Writers only claim READY slots with no readers, so pinned entries are never modified.
+ */
+#define VS_CACHE_READY 0x80000000u
+#define VS_CACHE_BUSY  0x40000000u
+#define VS_CACHE_PINS  0x3fffffffu
+
+typedef struct {
+    _Atomic uint32_t state;
+    _Atomic uint32_t referenced;
+    uint64_t hash;
+    size_t length;
+    void *key;
+    const void *value;
+} vs_cache_slot_t;
+
+struct vs_cache {
+    vs_cache_slot_t *slots;
+    _Atomic uint32_t *hands;
+    _Atomic uint32_t *locks;
+    size_t mask;
+    const void *(*retain)(const void *);
+    void (*release)(const void *);
+    _Atomic unsigned long long hits;
+    _Atomic unsigned long long misses;
+};
+
+#pragma mark Slots
+
+/**
+ *  FNV-1a hash of a key.
+ *
+ *  @param __key
+ *  @param __n
+ *
+ *  @return The hash.
+ */
+static uint64_t vs_cache_hash(const void *__key, size_t __n) {
+    const unsigned char *p = (const unsigned char *)__key;
+    uint64_t o = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < __n; i++) {
+        o ^= p[i];
+        o *= 0x100000001b3ULL;
+    }
+
+    return o;
+}
+
+/**
+ *  Pins an entry so that it cannot be evicted while in use.
+ *
+ *  @param __s
+ *
+ *  @return 1 if pinned, 0 if the slot holds no entry.
+ */
+static int vs_cache_pin(vs_cache_slot_t *__s) {
+    uint32_t state = atomic_load_explicit(&__s->state, memory_order_relaxed);
+
+    while ((state & VS_CACHE_READY) && ((state & VS_CACHE_PINS) < VS_CACHE_PINS)) {
+        if (atomic_compare_exchange_weak_explicit(&__s->state, &state, state + 1, memory_order_acquire, memory_order_relaxed)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void vs_cache_unpin(vs_cache_slot_t *__s) {
+    atomic_fetch_sub_explicit(&__s->state, 1, memory_order_release);
+}
+
+/**
+ *  Claims a slot for writing. Fails if the slot is pinned or being written by another thread.
+ *
+ *  @param __s
+ *
+ *  @return 1 if claimed, 0 otherwise.
+ */
+static int vs_cache_claim(vs_cache_slot_t *__s) {
+    uint32_t state = atomic_load_explicit(&__s->state, memory_order_relaxed);
+
+    if (state != 0 && state != VS_CACHE_READY) {
+        return 0;
+    }
+
+    return atomic_compare_exchange_strong_explicit(&__s->state, &state, VS_CACHE_BUSY, memory_order_acquire, memory_order_relaxed);
+}
+
+/**
+ *  Releases the entry of a claimed slot, leaving it claimed.
+ *
+ *  @param __c
+ *  @param __s
+ */
+static void vs_cache_evict(vs_cache_t *__c, vs_cache_slot_t *__s) {
+    if (__s->key != NULL) {
+        __c->release(__s->value);
+        free(__s->key);
+    }
+
+    __s->key = NULL;
+    __s->value = NULL;
+    __s->length = 0;
+    __s->hash = 0;
+}
+
+/**
+ *  Finds and pins the entry of a key within its set.
+ *
+ *  @param __c
+ *  @param __key
+ *  @param __n
+ *  @param __hash
+ *
+ *  @return The pinned slot, NULL if not found.
+ */
+static vs_cache_slot_t *vs_cache_find(vs_cache_t *__c, const void *__key, size_t __n, uint64_t __hash) {
+    vs_cache_slot_t *set = &__c->slots[(__hash & __c->mask) * VS_CACHE_WAYS];
+
+    for (int i = 0; i < VS_CACHE_WAYS; i++) {
+        vs_cache_slot_t *s = &set[i];
+
+        if (!vs_cache_pin(s)) {
+            continue;
+        }
+
+        if (s->hash == __hash && s->length == __n && memcmp(s->key, __key, __n) == 0) {
+            return s;
+        }
+
+        vs_cache_unpin(s);
+    }
+
+    return NULL;
+}
+
+/**
+ *  Locks a set against other writers. Readers never take the lock.
+ *
+ *  @param __c
+ *  @param __index
+ */
+static void vs_cache_lock(vs_cache_t *__c, size_t __index) {
+    uint32_t unlocked = 0;
+
+    while (!atomic_compare_exchange_weak_explicit(&__c->locks[__index], &unlocked, 1, memory_order_acquire, memory_order_relaxed)) {
+        unlocked = 0;
+        sched_yield();
+    }
+}
+
+static void vs_cache_unlock(vs_cache_t *__c, size_t __index) {
+    atomic_store_explicit(&__c->locks[__index], 0, memory_order_release);
+}
+
+#pragma mark Life Cycle
+
+vs_cache_t *vs_cache_alloc(size_t __capacity, const void *(*__retain)(const void *), void (*__release)(const void *)) {
+    if (__capacity == 0 || __retain == NULL || __release == NULL) {
+        return NULL;
+    }
+
+    size_t sets = 1;
+
+    while (sets * VS_CACHE_WAYS < __capacity) {
+        sets <<= 1;
+    }
+
+    vs_cache_t *o = (vs_cache_t *)calloc(1, sizeof(vs_cache_t));
+
+    if (o == NULL) {
+        return NULL;
+    }
+
+    o->slots = (vs_cache_slot_t *)calloc(sets * VS_CACHE_WAYS, sizeof(vs_cache_slot_t));
+    o->hands = (_Atomic uint32_t *)calloc(sets, sizeof(_Atomic uint32_t));
+    o->locks = (_Atomic uint32_t *)calloc(sets, sizeof(_Atomic uint32_t));
+
+    if (o->slots == NULL || o->hands == NULL || o->locks == NULL) {
+        free(o->slots);
+        free((void *)o->hands);
+        free((void *)o->locks);
+        free(o);
+
+        return NULL;
+    }
+
+    o->mask = sets - 1;
+    o->retain = __retain;
+    o->release = __release;
+
+    return o;
+}
+
+void vs_cache_free(vs_cache_t *__c) {
+    if (__c == NULL) {
+        return;
+    }
+
+    size_t n = (__c->mask + 1) * VS_CACHE_WAYS;
+
+    for (size_t i = 0; i < n; i++) {
+        vs_cache_evict(__c, &__c->slots[i]);
+    }
+
+    free(__c->slots);
+    free((void *)__c->hands);
+    free((void *)__c->locks);
+    free(__c);
+}
+
+#pragma mark Access
+
+const void *vs_cache_get(vs_cache_t *__c, const void *__key, size_t __n) {
+    if (__c == NULL || __key == NULL) {
+        return NULL;
+    }
+
+    vs_cache_slot_t *s = vs_cache_find(__c, __key, __n, vs_cache_hash(__key, __n));
+
+    if (s == NULL) {
+        atomic_fetch_add_explicit(&__c->misses, 1, memory_order_relaxed);
+
+        return NULL;
+    }
+
+    const void *o = __c->retain(s->value);
+
+    if (atomic_load_explicit(&s->referenced, memory_order_relaxed) == 0) {
+        atomic_store_explicit(&s->referenced, 1, memory_order_relaxed);
+    }
+
+    vs_cache_unpin(s);
+
+    atomic_fetch_add_explicit(&__c->hits, 1, memory_order_relaxed);
+
+    return o;
+}
+
+int vs_cache_put(vs_cache_t *__c, const void *__key, size_t __n, const void *__value) {
+    if (__c == NULL || __key == NULL || __value == NULL) {
+        return 0;
+    }
+
+    uint64_t hash = vs_cache_hash(__key, __n);
+    size_t index = hash & __c->mask;
+    vs_cache_slot_t *set = &__c->slots[index * VS_CACHE_WAYS];
+    void *key = malloc(__n > 0 ? __n : 1);
+
+    if (key == NULL) {
+        return 0;
+    }
+
+    memcpy(key, __key, __n);
+
+    // Writers of a set are serialized, so that the lookup and the insertion are atomic together and a key is never inserted twice.
+    vs_cache_lock(__c, index);
+
+    vs_cache_slot_t *s = vs_cache_find(__c, __key, __n, hash);
+
+    // Another thread inserted the same key first.
+    if (s != NULL) {
+        vs_cache_unpin(s);
+        vs_cache_unlock(__c, index);
+        free(key);
+
+        return 0;
+    }
+
+    // Sweep the clock hand at most twice around the set: the first pass clears reference bits, the second finds an entry to evict.
+    for (int i = 0; i < 2 * VS_CACHE_WAYS; i++) {
+        s = &set[atomic_fetch_add_explicit(&__c->hands[index], 1, memory_order_relaxed) % VS_CACHE_WAYS];
+
+        if (atomic_load_explicit(&s->state, memory_order_relaxed) != 0 && atomic_exchange_explicit(&s->referenced, 0, memory_order_relaxed) != 0) {
+            continue;
+        }
+
+        if (!vs_cache_claim(s)) {
+            continue;
+        }
+
+        vs_cache_evict(__c, s);
+
+        s->hash = hash;
+        s->length = __n;
+        s->key = key;
+        s->value = __c->retain(__value);
+
+        atomic_store_explicit(&s->referenced, 0, memory_order_relaxed);
+        atomic_store_explicit(&s->state, VS_CACHE_READY, memory_order_release);
+        vs_cache_unlock(__c, index);
+
+        return 1;
+    }
+
+    vs_cache_unlock(__c, index);
+    free(key);
+
+    return 0;
+}
+
+void vs_cache_clear(vs_cache_t *__c) {
+    if (__c == NULL) {
+        return;
+    }
+
+    size_t n = (__c->mask + 1) * VS_CACHE_WAYS;
+
+    for (size_t i = 0; i < n; i++) {
+        vs_cache_slot_t *s = &__c->slots[i];
+
+        // Wait for readers to unpin the entry, skipping slots which are empty or being written.
+        while (!vs_cache_claim(s)) {
+            uint32_t state = atomic_load_explicit(&s->state, memory_order_relaxed);
+
+            if (state == 0 || (state & VS_CACHE_BUSY)) {
+                s = NULL;
+                break;
+            }
+
+            sched_yield();
+        }
+
+        if (s != NULL) {
+            vs_cache_evict(__c, s);
+            atomic_store_explicit(&s->state, 0, memory_order_release);
+        }
+    }
+}
+
+#pragma mark Statistics
+
+unsigned long long vs_cache_hits(vs_cache_t *__c) {
+    return (__c == NULL) ? 0 : atomic_load_explicit(&__c->hits, memory_order_relaxed);
+}
+
+unsigned long long vs_cache_misses(vs_cache_t *__c) {
+    return (__c == NULL) ? 0 : atomic_load_explicit(&__c->misses, memory_order_relaxed);
+}
+
+size_t vs_cache_capacity(vs_cache_t *__c) {
+    return (__c == NULL) ? 0 : (__c->mask + 1) * VS_CACHE_WAYS;
+}
@@ -0,0 +1,113 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS concurrent cache tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vscache_h
+#define vscache_h
+
+#include <stddef.h>
+
+/**
+ *  Number of entries per set of vs_cache_t.
+ */
+#define VS_CACHE_WAYS 8
+
+/**
+ *  Bounded, thread-safe cache mapping byte string keys to reference counted values. Entries are grouped in sets of VS_CACHE_WAYS
+ *  entries selected by the hash of the key, and evicted with the CLOCK (second chance) policy within their set. Lookups never lock: an
+ *  entry is pinned with a single compare-and-swap while its key is compared and its value retained. Insertions lock their set against
+ *  other insertions only, so that a key is never inserted twice. Entries are immutable once inserted, so values must not be modified by
+ *  their users.
+ */
+typedef struct vs_cache vs_cache_t;
+
+#pragma mark Life Cycle
+
+/**
+ *  Creates a cache. Values are retained when inserted or returned by vs_cache_get(), and released when evicted, cleared or after use
+ *  by their users (i.e. CFRetain and CFRelease).
+ *
+ *  @param __capacity Maximum number of entries, rounded up to a power of 2 multiple of VS_CACHE_WAYS.
+ *  @param __retain
+ *  @param __release
+ *
+ *  @return The cache, NULL if __capacity is 0 or out of memory.
+ */
+vs_cache_t *vs_cache_alloc(size_t __capacity, const void *(*__retain)(const void *), void (*__release)(const void *));
+
+/**
+ *  Releases all entries and frees a cache. The cache must no longer be in use by other threads.
+ *
+ *  @param __c
+ */
+void vs_cache_free(vs_cache_t *__c);
+
+#pragma mark Access
+
+/**
+ *  Looks up the value of a key, counting a hit or a miss.
+ *
+ *  @param __c
+ *  @param __key
+ *  @param __n   Length of the key in bytes.
+ *
+ *  @return The value retained on behalf of the caller, NULL if not found.
+ */
+const void *vs_cache_get(vs_cache_t *__c, const void *__key, size_t __n);
+
+/**
+ *  Inserts the value of a key, evicting a not recently used entry of its set if needed. Nothing is inserted if the key is already
+ *  present or if all entries of its set are in use.
+ *
+ *  @param __c
+ *  @param __key
+ *  @param __n     Length of the key in bytes.
+ *  @param __value
+ *
+ *  @return 1 if inserted, 0 otherwise.
+ */
+int vs_cache_put(vs_cache_t *__c, const void *__key, size_t __n, const void *__value);
+
+/**
+ *  Removes all entries. Entries inserted concurrently may survive.
+ *
+ *  @param __c
+ */
+void vs_cache_clear(vs_cache_t *__c);
+
+#pragma mark Statistics
+
+/**
+ *  Gets the number of lookups which found their key.
+ *
+ *  @param __c
+ *
+ *  @return The hit count.
+ */
+unsigned long long vs_cache_hits(vs_cache_t *__c);
+
+/**
+ *  Gets the number of lookups which did not find their key.
+ *
+ *  @param __c
+ *
+ *  @return The miss count.
+ */
+unsigned long long vs_cache_misses(vs_cache_t *__c);
+
+/**
+ *  Gets the maximum number of entries.
+ *
+ *  @param __c
+ *
+ *  @return The capacity.
+ */
+size_t vs_cache_capacity(vs_cache_t *__c);
+
+#endif
@@ -0,0 +1,370 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <math.h>
+#import <pthread.h>
+#import <stdint.h>
+#import <string.h>
+#import <unistd.h>
+
+#import "vscol.h"
+#import "vsnum.h"
+
+/**
+ *  Max number of threads.
+ */
+#define VS_COL_THREADS_MAX 64
+
+/**
+ *  Chunk of whole rows parsed by one thread.
+ */
+typedef struct {
+    const char *c;
+    size_t n;
+    char d;
+    size_t m;
+    size_t row;
+    size_t rows;
+    double *v;
+    int64_t *l;
+    unsigned char *e;
+    size_t errors;
+} vs_col_chunk_t;
+
+#pragma mark Fields
+
+/**
+ *  Counts the occurrences of a byte in a buffer. The loop has no early exit so that compilers vectorize it.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __b
+ *
+ *  @return The number of occurrences.
+ */
+static size_t vs_col_count(const char *__c, size_t __n, char __b) {
+    size_t o = 0;
+
+    for (size_t i = 0; i < __n; i++) {
+        o += (__c[i] == __b);
+    }
+
+    return o;
+}
+
+/**
+ *  Trims the spaces and tabs around a field.
+ *
+ *  @param __c Pointer to the start of the field, moved past leading spaces and tabs.
+ *  @param __n Length of the field, shortened accordingly.
+ */
+static void vs_col_trim(const char **__c, size_t *__n) {
+    const char *c = *__c;
+    size_t n = *__n;
+
+    while ((n > 0) && ((*c == ' ') || (*c == '\t'))) {
+        c++;
+        n--;
+    }
+
+    while ((n > 0) && ((c[n - 1] == ' ') || (c[n - 1] == '\t'))) n--;
+
+    *__c = c;
+    *__n = n;
+}
+
+/**
+ *  Parses a field into a double.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __v Pointer to receive the value, NAN if the field is not a number.
+ *
+ *  @return VS_COL_OK, VS_COL_ERANGE or VS_COL_EINVAL.
+ */
+static int vs_col_field(const char *__c, size_t __n, double *__v) {
+    int r = 0;
+
+    vs_col_trim(&__c, &__n);
+
+    if ((__n == 0) || (vs_num_scan(__c, __n, VS_NUM_DECIMAL_SEPARATOR, NULL, __v, &r) != __n)) {
+        *__v = NAN;
+        return VS_COL_EINVAL;
+    }
+
+    return r ? VS_COL_ERANGE : VS_COL_OK;
+}
+
+/**
+ *  Parses a field into a 64-bit integer.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __v Pointer to receive the value, clamped if out of range, 0 if the field is not an integer.
+ *
+ *  @return VS_COL_OK, VS_COL_ERANGE or VS_COL_EINVAL.
+ */
+static int vs_col_fieldll(const char *__c, size_t __n, int64_t *__v) {
+    uint64_t o = 0;
+    int negative = 0;
+    int overflow = 0;
+    size_t i = 0;
+
+    vs_col_trim(&__c, &__n);
+
+    if ((__n > 0) && ((*__c == '-') || (*__c == '+'))) {
+        negative = (*__c == '-');
+        i++;
+    }
+
+    if (i == __n) {
+        *__v = 0;
+        return VS_COL_EINVAL;
+    }
+
+    for (; i < __n; i++) {
+        unsigned int d = (unsigned int)(unsigned char)__c[i] - '0';
+
+        if (d > 9) {
+            *__v = 0;
+            return VS_COL_EINVAL;
+        }
+
+        // Magnitudes past 2^63 are out of range either way.
+        if (o > ((UINT64_C(1) << 63) - d) / 10) {
+            overflow = 1;
+        }
+        else {
+            o = (o * 10) + d;
+        }
+    }
+
+    if (overflow || (o > (uint64_t)INT64_MAX + negative)) {
+        *__v = negative ? INT64_MIN : INT64_MAX;
+        return VS_COL_ERANGE;
+    }
+
+    *__v = negative ? (int64_t)(0 - o) : (int64_t)o;
+
+    return VS_COL_OK;
+}
+
+#pragma mark Chunks
+
+/**
+ *  Parses the rows of a chunk into doubles or 64-bit integers, whichever output array is set.
+ *
+ *  @param __k
+ *
+ *  @return NULL.
+ */
+static void *vs_col_parsechunk(void *__k) {
+    vs_col_chunk_t *k = (vs_col_chunk_t *)__k;
+    const char *c = k->c;
+    const char *end = k->c + k->n;
+
+    k->errors = 0;
+
+    for (size_t row = k->row; (c < end) && (row < k->row + k->rows); row++) {
+        const char *lf = memchr(c, '\n', (size_t)(end - c));
+        const char *le = (lf != NULL) ? lf : end;
+        size_t field = 0;
+        int error = VS_COL_OK;
+
+        if ((le > c) && (le[-1] == '\r')) le--;
+
+        // Every row has at least one field, possibly empty.
+        for (const char *f = c;; field++) {
+            const char *fe = memchr(f, k->d, (size_t)(le - f));
+            int r = VS_COL_OK;
+
+            if (fe == NULL) fe = le;
+
+            if (field < k->m) {
+                r = (k->v != NULL) ? vs_col_field(f, (size_t)(fe - f), k->v + (row * k->m) + field) :
+                                     vs_col_fieldll(f, (size_t)(fe - f), k->l + (row * k->m) + field);
+            }
+
+            if (r > error) error = r;
+            if (fe == le) break;
+
+            f = fe + 1;
+        }
+
+        if (++field != k->m) error = VS_COL_ECOUNT;
+
+        for (; field < k->m; field++) {
+            if (k->v != NULL) {
+                k->v[(row * k->m) + field] = NAN;
+            }
+            else {
+                k->l[(row * k->m) + field] = 0;
+            }
+        }
+
+        if (k->e != NULL) k->e[row] = (unsigned char)error;
+        if (error != VS_COL_OK) k->errors++;
+
+        c = (lf != NULL) ? (lf + 1) : end;
+    }
+
+    return NULL;
+}
+
+/**
+ *  Counts the rows of a chunk, which ends with a line feed unless it is the last one.
+ *
+ *  @param __k
+ *
+ *  @return NULL.
+ */
+static void *vs_col_countchunk(void *__k) {
+    vs_col_chunk_t *k = (vs_col_chunk_t *)__k;
+
+    k->rows = vs_col_count(k->c, k->n, '\n');
+
+    return NULL;
+}
+
+/**
+ *  Runs a function on every chunk, on the calling thread for the first one and on a new thread for each other one. Chunks whose
+ *  thread cannot be created run on the calling thread.
+ *
+ *  @param __k
+ *  @param __t Number of chunks.
+ *  @param __f
+ */
+static void vs_col_run(vs_col_chunk_t *__k, unsigned int __t, void *(*__f)(void *)) {
+    pthread_t threads[VS_COL_THREADS_MAX];
+    int started[VS_COL_THREADS_MAX];
+
+    for (unsigned int i = 1; i < __t; i++) {
+        started[i] = (pthread_create(&threads[i], NULL, __f, &__k[i]) == 0);
+
+        if (!started[i]) __f(&__k[i]);
+    }
+
+    __f(&__k[0]);
+
+    for (unsigned int i = 1; i < __t; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+/**
+ *  Splits a buffer in chunks of whole rows, counts their rows in parallel and parses them in parallel.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __d
+ *  @param __m
+ *  @param __r
+ *  @param __v
+ *  @param __l
+ *  @param __e
+ *  @param __t
+ *
+ *  @return The number of rows with errors.
+ */
+static size_t vs_col_split(const char *__c, size_t __n, char __d, size_t __m, size_t __r, double *__v, int64_t *__l, unsigned char *__e,
+                           unsigned int __t) {
+    vs_col_chunk_t chunks[VS_COL_THREADS_MAX];
+    unsigned int t = __t;
+
+    if ((__c == NULL) || (__m == 0) || (__r == 0)) return 0;
+
+    if (t == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        t = (cpus > 0) ? (unsigned int)cpus : 1;
+    }
+
+    if (t > VS_COL_THREADS_MAX) t = VS_COL_THREADS_MAX;
+    if (t > __n / VS_COL_CHUNK_MIN) t = (__n / VS_COL_CHUNK_MIN > 0) ? (unsigned int)(__n / VS_COL_CHUNK_MIN) : 1;
+
+    // Chunks end right after the first line feed past an even share of the buffer, the last one at the end of the buffer.
+    const char *c = __c;
+    const char *end = __c + __n;
+    unsigned int count = 0;
+
+    while ((count < t) && (c < end)) {
+        const char *ce = (count + 1 < t) ? (__c + (__n / t) * (count + 1)) : end;
+
+        if (ce < c) ce = c;
+
+        if (ce < end) {
+            const char *lf = memchr(ce, '\n', (size_t)(end - ce));
+
+            ce = (lf != NULL) ? (lf + 1) : end;
+        }
+
+        chunks[count] = (vs_col_chunk_t){ c, (size_t)(ce - c), __d, __m, 0, 0, __v, __l, __e, 0 };
+        count++;
+        c = ce;
+    }
+
+    if (count == 0) return 0;
+
+    if (count > 1) vs_col_run(chunks, count, vs_col_countchunk);
+
+    size_t row = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        chunks[i].row = row;
+        chunks[i].rows = (count > 1) ? chunks[i].rows : __r;
+
+        // Only the last chunk may end with a row without line feed.
+        if ((i == count - 1) && (count > 1) && (chunks[i].n > 0) && (chunks[i].c[chunks[i].n - 1] != '\n')) chunks[i].rows++;
+
+        if (row >= __r) {
+            chunks[i].rows = 0;
+        }
+        else if (chunks[i].rows > __r - row) {
+            chunks[i].rows = __r - row;
+        }
+
+        row += chunks[i].rows;
+    }
+
+    vs_col_run(chunks, count, vs_col_parsechunk);
+
+    size_t errors = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        errors += chunks[i].errors;
+    }
+
+    return errors;
+}
+
+#pragma mark Layout
+
+size_t vs_col_rows(const char *__c, size_t __n) {
+    if ((__c == NULL) || (__n == 0)) return 0;
+
+    return vs_col_count(__c, __n, '\n') + (__c[__n - 1] != '\n');
+}
+
+size_t vs_col_fields(const char *__c, size_t __n, char __d) {
+    if ((__c == NULL) || (__n == 0)) return 0;
+
+    const char *lf = memchr(__c, '\n', __n);
+    size_t n = (lf != NULL) ? (size_t)(lf - __c) : __n;
+
+    return vs_col_count(__c, n, __d) + 1;
+}
+
+#pragma mark Parsing
+
+size_t vs_col_parse(const char *__c, size_t __n, char __d, size_t __m, size_t __r, double *__v, unsigned char *__e, unsigned int __t) {
+    return vs_col_split(__c, __n, __d, __m, __r, __v, NULL, __e, __t);
+}
+
+size_t vs_col_parsell(const char *__c, size_t __n, char __d, size_t __m, size_t __r, int64_t *__v, unsigned char *__e, unsigned int __t) {
+    return vs_col_split(__c, __n, __d, __m, __r, NULL, __v, __e, __t);
+}
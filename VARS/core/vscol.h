@@ -0,0 +1,100 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS delimited column parsing tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vscol_h
+#define vscol_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Row errors, from least to most severe: a field is out of range (doubles rounded to 0 or infinity, integers clamped), a field is
+ *  not a number (parsed as NAN or 0), or the row does not have the expected number of fields (missing fields are NAN or 0, extra
+ *  fields are ignored). A row reports its most severe error.
+ */
+#define VS_COL_OK     0
+#define VS_COL_ERANGE 1
+#define VS_COL_EINVAL 2
+#define VS_COL_ECOUNT 3
+
+/**
+ *  Min number of bytes per thread, smaller buffers are parsed by fewer threads.
+ */
+#define VS_COL_CHUNK_MIN (1 << 20)
+
+/**
+ *  Delimiters and line endings are searched with memchr(), which the C library implements with SIMD instructions on all supported
+ *  platforms, and rows are counted with a loop written for compiler auto-vectorization. No intrinsics are used, so the throughput of
+ *  the search depends on the C library and on the optimization flags the library is built with.
+ */
+
+#pragma mark Layout
+
+/**
+ *  Gets the number of rows of a buffer of delimited text. Rows end with \n (optionally preceded by \r), and the last row may have no
+ *  line ending. Every line is a row, including empty lines.
+ *
+ *  @param __c Text, not necessarily null-terminated (i.e. a memory-mapped file).
+ *  @param __n Length of the text in bytes.
+ *
+ *  @return The number of rows.
+ */
+size_t vs_col_rows(const char *__c, size_t __n);
+
+/**
+ *  Gets the number of fields of the first row of a buffer of delimited text.
+ *
+ *  @param __c Text, not necessarily null-terminated.
+ *  @param __n Length of the text in bytes.
+ *  @param __d Field delimiter, neither \n nor \r.
+ *
+ *  @return The number of fields, 0 if the text is empty.
+ */
+size_t vs_col_fields(const char *__c, size_t __n, char __d);
+
+#pragma mark Parsing
+
+/**
+ *  Parses a buffer of delimited decimal numbers into a row-major array of doubles, without locale and without allocating memory per
+ *  value. Fields may be surrounded by spaces and tabs, and are parsed with the syntax and rounding of vs_num_parse() with the decimal
+ *  separator "." and no grouping separator. The text is split in chunks of whole rows parsed in parallel by up to __t threads, and
+ *  only ever read within its length, so a read-only memory-mapped file can be parsed in place.
+ *
+ *  @param __c Text, not necessarily null-terminated.
+ *  @param __n Length of the text in bytes.
+ *  @param __d Field delimiter, neither \n nor \r.
+ *  @param __m Number of fields per row, see vs_col_fields().
+ *  @param __r Max number of rows to parse, see vs_col_rows().
+ *  @param __v Array of at least __r * __m values to receive the fields of each row.
+ *  @param __e Optional array of at least __r row errors to receive VS_COL_OK or the most severe error of each row.
+ *  @param __t Max number of threads, including the calling thread, or 0 for the number of online processors.
+ *
+ *  @return The number of rows with errors.
+ */
+size_t vs_col_parse(const char *__c, size_t __n, char __d, size_t __m, size_t __r, double *__v, unsigned char *__e, unsigned int __t);
+
+/**
+ *  Parses a buffer of delimited decimal integers into a row-major array of 64-bit integers. Fields are optionally signed decimal
+ *  integers which may be surrounded by spaces and tabs. See vs_col_parse().
+ *
+ *  @param __c Text, not necessarily null-terminated.
+ *  @param __n Length of the text in bytes.
+ *  @param __d Field delimiter, neither \n nor \r.
+ *  @param __m Number of fields per row, see vs_col_fields().
+ *  @param __r Max number of rows to parse, see vs_col_rows().
+ *  @param __v Array of at least __r * __m values to receive the fields of each row.
+ *  @param __e Optional array of at least __r row errors to receive VS_COL_OK or the most severe error of each row.
+ *  @param __t Max number of threads, including the calling thread, or 0 for the number of online processors.
+ *
+ *  @return The number of rows with errors.
+ */
+size_t vs_col_parsell(const char *__c, size_t __n, char __d, size_t __m, size_t __r, int64_t *__v, unsigned char *__e, unsigned int __t);
+
+#endif
@@ -0,0 +1,884 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <math.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+
+#import "vsdec.h"
+#import "vsnum.h"
+
+/**
+ *  Coefficients are handled as little-endian arrays of 32-bit words so that every intermediate product fits in a uint64_t, on 32-bit
+ *  architectures too. Intermediate results (products, aligned sums, scaled dividends) need up to 8 words before rounding.
+ */
+#define VS_DEC_WORDS  4
+#define VS_DEC_XWORDS 8
+
+/**
+ *  Decimals of up to 15 significant digits always survive a round trip through double.
+ */
+#define VS_DEC_SHORT_MAX 1.0e15
+
+/**
+ *  Bound on the relative error of compensated results with respect to the exact decimal ones, including the rounding of decimal
+ *  quotients to VS_DEC_DIGITS digits. It is far below half an ulp (2^-54), so that only results that lie this close to halfway between
+ *  two doubles need decimal arithmetic to be rounded the same way.
+ */
+#define VS_DEC_FAST_ERR 0x1p-96
+
+/**
+ *  Powers of 10 from 1e0 to 1e38, as coefficient words.
+ */
+static const uint32_t VS_DEC_POW10[39][VS_DEC_WORDS] = {
+    { 0x00000001U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x0000000aU, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x00000064U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x000003e8U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x00002710U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x000186a0U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x000f4240U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x00989680U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x05f5e100U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x3b9aca00U, 0x00000000U, 0x00000000U, 0x00000000U },
+    { 0x540be400U, 0x00000002U, 0x00000000U, 0x00000000U },
+    { 0x4876e800U, 0x00000017U, 0x00000000U, 0x00000000U },
+    { 0xd4a51000U, 0x000000e8U, 0x00000000U, 0x00000000U },
+    { 0x4e72a000U, 0x00000918U, 0x00000000U, 0x00000000U },
+    { 0x107a4000U, 0x00005af3U, 0x00000000U, 0x00000000U },
+    { 0xa4c68000U, 0x00038d7eU, 0x00000000U, 0x00000000U },
+    { 0x6fc10000U, 0x002386f2U, 0x00000000U, 0x00000000U },
+    { 0x5d8a0000U, 0x01634578U, 0x00000000U, 0x00000000U },
+    { 0xa7640000U, 0x0de0b6b3U, 0x00000000U, 0x00000000U },
+    { 0x89e80000U, 0x8ac72304U, 0x00000000U, 0x00000000U },
+    { 0x63100000U, 0x6bc75e2dU, 0x00000005U, 0x00000000U },
+    { 0xdea00000U, 0x35c9adc5U, 0x00000036U, 0x00000000U },
+    { 0xb2400000U, 0x19e0c9baU, 0x0000021eU, 0x00000000U },
+    { 0xf6800000U, 0x02c7e14aU, 0x0000152dU, 0x00000000U },
+    { 0xa1000000U, 0x1bceccedU, 0x0000d3c2U, 0x00000000U },
+    { 0x4a000000U, 0x16140148U, 0x00084595U, 0x00000000U },
+    { 0xe4000000U, 0xdcc80cd2U, 0x0052b7d2U, 0x00000000U },
+    { 0xe8000000U, 0x9fd0803cU, 0x033b2e3cU, 0x00000000U },
+    { 0x10000000U, 0x3e250261U, 0x204fce5eU, 0x00000000U },
+    { 0xa0000000U, 0x6d7217caU, 0x431e0faeU, 0x00000001U },
+    { 0x40000000U, 0x4674edeaU, 0x9f2c9cd0U, 0x0000000cU },
+    { 0x80000000U, 0xc0914b26U, 0x37be2022U, 0x0000007eU },
+    { 0x00000000U, 0x85acef81U, 0x2d6d415bU, 0x000004eeU },
+    { 0x00000000U, 0x38c15b0aU, 0xc6448d93U, 0x0000314dU },
+    { 0x00000000U, 0x378d8e64U, 0xbead87c0U, 0x0001ed09U },
+    { 0x00000000U, 0x2b878fe8U, 0x72c74d82U, 0x00134261U },
+    { 0x00000000U, 0xb34b9f10U, 0x7bc90715U, 0x00c097ceU },
+    { 0x00000000U, 0x00f436a0U, 0xd5da46d9U, 0x0785ee10U },
+    { 0x00000000U, 0x098a2240U, 0x5a86c47aU, 0x4b3b4ca8U },
+};
+
+/**
+ *  Powers of 10 that are exactly representable as doubles.
+ */
+static const double VS_DEC_POW10_D[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#pragma mark Word Arithmetic
+
+/**
+ *  Gets the number of significant words.
+ *
+ *  @param __w
+ *  @param __n
+ *
+ *  @return The index of the highest non-zero word plus 1, 0 if all words are 0.
+ */
+static int vs_dec_wlen(const uint32_t *__w, int __n) {
+    while ((__n > 0) && (__w[__n-1] == 0)) __n--;
+
+    return __n;
+}
+
+/**
+ *  Compares two word arrays of the same length.
+ *
+ *  @param __a
+ *  @param __b
+ *  @param __n
+ *
+ *  @return -1, 0 or 1.
+ */
+static int vs_dec_wcmp(const uint32_t *__a, const uint32_t *__b, int __n) {
+    for (int i = __n - 1; i >= 0; i--) {
+        if (__a[i] != __b[i]) return (__a[i] < __b[i]) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ *  Counts the decimal digits of a coefficient.
+ *
+ *  @param __w
+ *
+ *  @return The number of digits, 0 if the coefficient is 0.
+ */
+static int vs_dec_wdigits(const uint32_t *__w) {
+    int n = vs_dec_wlen(__w, VS_DEC_WORDS);
+
+    if (n == 0) return 0;
+
+    int bits = (n - 1) * 32;
+
+    for (uint32_t t = __w[n-1]; t != 0; t >>= 1) bits++;
+
+    // floor(bits * log10(2)) is either the number of digits or one less.
+    int k = (bits * 1233) >> 12;
+
+    return k + (vs_dec_wcmp(__w, VS_DEC_POW10[k], VS_DEC_WORDS) >= 0);
+}
+
+/**
+ *  Multiplies a word array by a small factor in place.
+ *
+ *  @param __w
+ *  @param __n
+ *  @param __m
+ *
+ *  @return The carry out of the highest word.
+ */
+static uint32_t vs_dec_wmuls(uint32_t *__w, int __n, uint32_t __m) {
+    uint64_t carry = 0;
+
+    for (int i = 0; i < __n; i++) {
+        uint64_t t = (uint64_t)__w[i] * __m + carry;
+        __w[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+
+    return (uint32_t)carry;
+}
+
+/**
+ *  Divides a word array by a small divisor in place.
+ *
+ *  @param __w
+ *  @param __n
+ *  @param __d
+ *
+ *  @return The remainder.
+ */
+static uint32_t vs_dec_wdivs(uint32_t *__w, int __n, uint32_t __d) {
+    uint64_t r = 0;
+
+    for (int i = __n - 1; i >= 0; i--) {
+        uint64_t t = (r << 32) | __w[i];
+        __w[i] = (uint32_t)(t / __d);
+        r = t % __d;
+    }
+
+    return (uint32_t)r;
+}
+
+/**
+ *  Multiplies a word array by 10^__k in place. The caller guarantees that the result fits.
+ *
+ *  @param __w
+ *  @param __n
+ *  @param __k
+ */
+static void vs_dec_wscale(uint32_t *__w, int __n, int __k) {
+    for (; __k >= 9; __k -= 9) vs_dec_wmuls(__w, __n, 1000000000U);
+
+    if (__k > 0) vs_dec_wmuls(__w, __n, VS_DEC_POW10[__k][0]);
+}
+
+/**
+ *  Adds a word array to another in place.
+ *
+ *  @param __a
+ *  @param __b
+ *  @param __n
+ */
+static void vs_dec_wadd(uint32_t *__a, const uint32_t *__b, int __n) {
+    uint64_t carry = 0;
+
+    for (int i = 0; i < __n; i++) {
+        uint64_t t = (uint64_t)__a[i] + __b[i] + carry;
+        __a[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+}
+
+/**
+ *  Subtracts a word array from another in place. The caller guarantees that __a >= __b.
+ *
+ *  @param __a
+ *  @param __b
+ *  @param __n
+ */
+static void vs_dec_wsub(uint32_t *__a, const uint32_t *__b, int __n) {
+    uint32_t borrow = 0;
+
+    for (int i = 0; i < __n; i++) {
+        uint64_t t = (uint64_t)__a[i] - __b[i] - borrow;
+        __a[i] = (uint32_t)t;
+        borrow = (uint32_t)(t >> 63);
+    }
+}
+
+/**
+ *  Multiplies two coefficients.
+ *
+ *  @param __a
+ *  @param __b
+ *  @param __o Array of VS_DEC_XWORDS words to receive the product.
+ */
+static void vs_dec_wmul(const uint32_t *__a, const uint32_t *__b, uint32_t *__o) {
+    memset(__o, 0, sizeof(uint32_t) * VS_DEC_XWORDS);
+
+    for (int i = 0; i < VS_DEC_WORDS; i++) {
+        uint64_t carry = 0;
+
+        if (__a[i] == 0) continue;
+
+        for (int j = 0; j < VS_DEC_WORDS; j++) {
+            uint64_t t = (uint64_t)__a[i] * __b[j] + __o[i+j] + carry;
+            __o[i+j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+
+        __o[i+VS_DEC_WORDS] = (uint32_t)carry;
+    }
+}
+
+/**
+ *  Divides a word array by another (Knuth's algorithm D).
+ *
+ *  @param __u Dividend of __m significant words.
+ *  @param __m
+ *  @param __v Divisor of __n significant words, 2 <= __n <= __m.
+ *  @param __n
+ *  @param __q Array of at least __m - __n + 1 words to receive the quotient.
+ *
+ *  @return 1 if the remainder is not 0, 0 otherwise.
+ */
+static int vs_dec_wdiv(const uint32_t *__u, int __m, const uint32_t *__v, int __n, uint32_t *__q) {
+    uint32_t un[VS_DEC_XWORDS+1];
+    uint32_t vn[VS_DEC_WORDS];
+    int s = 0;
+
+    // Normalize so that the highest divisor word has its top bit set.
+    for (uint32_t t = __v[__n-1]; !(t & 0x80000000U); t <<= 1) s++;
+
+    for (int i = __n - 1; i > 0; i--) vn[i] = (__v[i] << s) | (uint32_t)((uint64_t)__v[i-1] >> (32 - s));
+    vn[0] = __v[0] << s;
+
+    un[__m] = (uint32_t)((uint64_t)__u[__m-1] >> (32 - s));
+    for (int i = __m - 1; i > 0; i--) un[i] = (__u[i] << s) | (uint32_t)((uint64_t)__u[i-1] >> (32 - s));
+    un[0] = __u[0] << s;
+
+    for (int j = __m - __n; j >= 0; j--) {
+        uint64_t num = ((uint64_t)un[j+__n] << 32) | un[j+__n-1];
+        uint64_t qhat = num / vn[__n-1];
+        uint64_t rhat = num - qhat * vn[__n-1];
+
+        while ((qhat >> 32) || (qhat * vn[__n-2] > ((rhat << 32) | un[j+__n-2]))) {
+            qhat--;
+            rhat += vn[__n-1];
+
+            if (rhat >> 32) break;
+        }
+
+        // Multiply and subtract.
+        int64_t k = 0;
+        int64_t t;
+
+        for (int i = 0; i < __n; i++) {
+            uint64_t p = qhat * vn[i];
+            t = (int64_t)un[i+j] - k - (int64_t)(p & 0xFFFFFFFFU);
+            un[i+j] = (uint32_t)t;
+            k = (int64_t)(p >> 32) - (t >> 32);
+        }
+
+        t = (int64_t)un[j+__n] - k;
+        un[j+__n] = (uint32_t)t;
+        __q[j] = (uint32_t)qhat;
+
+        // Add back if the estimate was one too large.
+        if (t < 0) {
+            uint64_t c = 0;
+
+            __q[j]--;
+
+            for (int i = 0; i < __n; i++) {
+                uint64_t a = (uint64_t)un[i+j] + vn[i] + c;
+                un[i+j] = (uint32_t)a;
+                c = a >> 32;
+            }
+
+            un[j+__n] += (uint32_t)c;
+        }
+    }
+
+    return vs_dec_wlen(un, __n) != 0;
+}
+
+#pragma mark Rounding
+
+/**
+ *  Creates a NAN decimal.
+ *
+ *  @return The NAN decimal.
+ */
+static vs_dec_t vs_dec_nan(void) {
+    vs_dec_t o = { { 0, 0, 0, 0 }, 0, VS_DEC_NAN };
+
+    return o;
+}
+
+/**
+ *  Rounds an intermediate result half to even to VS_DEC_DIGITS digits.
+ *
+ *  @param __w Array of VS_DEC_XWORDS words, modified in place.
+ *  @param __e Exponent of __w.
+ *  @param __sticky 1 if the exact result lies strictly above __w, 0 otherwise.
+ *  @param __neg
+ *
+ *  @return The rounded decimal value.
+ */
+static vs_dec_t vs_dec_pack(uint32_t *__w, int __e, int __sticky, int __neg) {
+    vs_dec_t o;
+    uint32_t last = 0;
+
+    while ((vs_dec_wlen(__w, VS_DEC_XWORDS) > VS_DEC_WORDS) || (vs_dec_wcmp(__w, VS_DEC_POW10[VS_DEC_DIGITS], VS_DEC_WORDS) >= 0)) {
+        __sticky |= (last != 0);
+        last = vs_dec_wdivs(__w, VS_DEC_XWORDS, 10);
+        __e++;
+    }
+
+    if ((last > 5) || ((last == 5) && (__sticky || (__w[0] & 1)))) {
+        uint32_t one[VS_DEC_WORDS] = { 1, 0, 0, 0 };
+
+        vs_dec_wadd(__w, one, VS_DEC_WORDS);
+
+        if (vs_dec_wcmp(__w, VS_DEC_POW10[VS_DEC_DIGITS], VS_DEC_WORDS) == 0) {
+            vs_dec_wdivs(__w, VS_DEC_WORDS, 10);
+            __e++;
+        }
+    }
+
+    memcpy(o.coefficient, __w, sizeof(o.coefficient));
+
+    if (vs_dec_wlen(__w, VS_DEC_WORDS) == 0) {
+        o.exponent = 0;
+        o.flags = 0;
+    }
+    else {
+        o.exponent = __e;
+        o.flags = __neg ? VS_DEC_NEGATIVE : 0;
+    }
+
+    return o;
+}
+
+#pragma mark Conversions
+
+vs_dec_t vs_dec_fromd(double __n) {
+    vs_dec_t o = { { 0, 0, 0, 0 }, 0, 0 };
+
+    if (!isfinite(__n)) return vs_dec_nan();
+    if (__n == 0.0) return o;
+
+    double a = fabs(__n);
+    uint64_t c = 0;
+
+    o.flags = (__n < 0.0) ? VS_DEC_NEGATIVE : 0;
+
+    // Most calculator input has few decimals: look for the smallest k such that a * 10^k rounds to an integer that converts back to a.
+    // Distinct decimals of at most 15 digits never map to the same double, so such an integer is the shortest representation.
+    for (int k = 0; k <= 22; k++) {
+        double t = a * VS_DEC_POW10_D[k];
+
+        if (t >= VS_DEC_SHORT_MAX) break;
+
+        c = (uint64_t)(t + 0.5);
+
+        if (((double)c / VS_DEC_POW10_D[k]) == a) {
+            o.coefficient[0] = (uint32_t)c;
+            o.coefficient[1] = (uint32_t)(c >> 32);
+            o.exponent = -k;
+
+            return o;
+        }
+    }
+
+    // Otherwise, take the shortest round trip decimal of vs_num_format(), which also covers subnormals (i.e. 5e-324), in fixed or
+    // scientific notation without locale. It has at most 17 digits.
+    char buf[VS_NUM_FORMAT_SIZE];
+    int fraction = -1;
+    int i = 0;
+
+    vs_num_format(a, 0, NULL, NULL, buf, sizeof(buf));
+
+    for (c = 0; (buf[i] != 0) && (buf[i] != 'e'); i++) {
+        if (buf[i] == '.') {
+            fraction = 0;
+        }
+        else {
+            c = (c * 10) + (uint64_t)(buf[i] - '0');
+
+            if (fraction >= 0) fraction++;
+        }
+    }
+
+    o.coefficient[0] = (uint32_t)c;
+    o.coefficient[1] = (uint32_t)(c >> 32);
+    o.exponent = ((buf[i] == 'e') ? (int)strtol(buf + i + 1, NULL, 10) : 0) - ((fraction > 0) ? fraction : 0);
+
+    return o;
+}
+
+double vs_dec_tod(vs_dec_t __d) {
+    if (__d.flags & VS_DEC_NAN) return NAN;
+
+    uint32_t w[VS_DEC_WORDS];
+    int e = __d.exponent;
+    double o;
+
+    memcpy(w, __d.coefficient, sizeof(w));
+
+    if (vs_dec_wlen(w, VS_DEC_WORDS) == 0) return 0.0;
+
+    // Trailing zeros only get in the way of the exact path below.
+    while ((vs_dec_wlen(w, VS_DEC_WORDS) > 2) || (w[1] >= (1U << 21)) || (e < -22)) {
+        uint32_t t[VS_DEC_WORDS];
+
+        memcpy(t, w, sizeof(t));
+
+        if (vs_dec_wdivs(t, VS_DEC_WORDS, 10) != 0) break;
+
+        memcpy(w, t, sizeof(w));
+        e++;
+    }
+
+    if ((vs_dec_wlen(w, VS_DEC_WORDS) <= 2) && (w[1] < (1U << 21)) && (e >= -22) && (e <= 22)) {
+        // Both the coefficient and the power of 10 are exact doubles, so a single rounding gives the nearest double.
+        double c = (double)(((uint64_t)w[1] << 32) | w[0]);
+
+        o = (e < 0) ? (c / VS_DEC_POW10_D[-e]) : (c * VS_DEC_POW10_D[e]);
+    }
+    else {
+        // Let vs_num_parse() round the digits correctly.
+        char buf[64];
+        char digits[VS_DEC_DIGITS + 6];
+        int n = 0;
+
+        while (vs_dec_wlen(w, VS_DEC_WORDS) > 0) {
+            digits[n++] = (char)('0' + vs_dec_wdivs(w, VS_DEC_WORDS, 10));
+        }
+
+        for (int i = 0; i < n; i++) buf[i] = digits[n-1-i];
+
+        n += snprintf(buf + n, sizeof(buf) - (size_t)n, "e%d", e);
+
+        vs_num_parse(buf, (size_t)n, NULL, NULL, &o);
+    }
+
+    return (__d.flags & VS_DEC_NEGATIVE) ? -o : o;
+}
+
+int vs_dec_isnan(vs_dec_t __d) {
+    return (__d.flags & VS_DEC_NAN) != 0;
+}
+
+#pragma mark Arithmetic
+
+vs_dec_t vs_dec_add(vs_dec_t __x, vs_dec_t __y) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return vs_dec_nan();
+
+    if (vs_dec_wlen(__x.coefficient, VS_DEC_WORDS) == 0) return __y;
+    if (vs_dec_wlen(__y.coefficient, VS_DEC_WORDS) == 0) return __x;
+
+    // Align on the smaller exponent.
+    if (__x.exponent < __y.exponent) {
+        vs_dec_t t = __x;
+        __x = __y;
+        __y = t;
+    }
+
+    int shift = __x.exponent - __y.exponent;
+
+    // __y is below half a unit in the last place of any rounded result.
+    if ((vs_dec_wdigits(__x.coefficient) + shift) > (vs_dec_wdigits(__y.coefficient) + VS_DEC_DIGITS + 2)) return __x;
+
+    uint32_t a[VS_DEC_XWORDS] = { 0 };
+    uint32_t b[VS_DEC_XWORDS] = { 0 };
+    int neg = __x.flags & VS_DEC_NEGATIVE;
+
+    memcpy(a, __x.coefficient, sizeof(__x.coefficient));
+    memcpy(b, __y.coefficient, sizeof(__y.coefficient));
+
+    vs_dec_wscale(a, VS_DEC_XWORDS, shift);
+
+    if ((__x.flags & VS_DEC_NEGATIVE) == (__y.flags & VS_DEC_NEGATIVE)) {
+        vs_dec_wadd(a, b, VS_DEC_XWORDS);
+    }
+    else if (vs_dec_wcmp(a, b, VS_DEC_XWORDS) >= 0) {
+        vs_dec_wsub(a, b, VS_DEC_XWORDS);
+    }
+    else {
+        vs_dec_wsub(b, a, VS_DEC_XWORDS);
+        memcpy(a, b, sizeof(a));
+        neg = __y.flags & VS_DEC_NEGATIVE;
+    }
+
+    return vs_dec_pack(a, __y.exponent, 0, neg);
+}
+
+vs_dec_t vs_dec_sub(vs_dec_t __x, vs_dec_t __y) {
+    __y.flags ^= VS_DEC_NEGATIVE;
+
+    return vs_dec_add(__x, __y);
+}
+
+vs_dec_t vs_dec_mul(vs_dec_t __x, vs_dec_t __y) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return vs_dec_nan();
+
+    uint32_t o[VS_DEC_XWORDS];
+
+    vs_dec_wmul(__x.coefficient, __y.coefficient, o);
+
+    return vs_dec_pack(o, __x.exponent + __y.exponent, 0, (__x.flags ^ __y.flags) & VS_DEC_NEGATIVE);
+}
+
+vs_dec_t vs_dec_div(vs_dec_t __x, vs_dec_t __y) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return vs_dec_nan();
+
+    int dx = vs_dec_wdigits(__x.coefficient);
+    int dy = vs_dec_wdigits(__y.coefficient);
+
+    if (dy == 0) return vs_dec_nan();
+
+    uint32_t u[VS_DEC_XWORDS] = { 0 };
+    uint32_t q[VS_DEC_XWORDS] = { 0 };
+    int neg = (__x.flags ^ __y.flags) & VS_DEC_NEGATIVE;
+    int sticky;
+
+    if (dx == 0) return vs_dec_pack(q, 0, 0, 0);
+
+    // Scale the dividend so that the quotient has at least one digit more than the precision, the rest goes in the sticky bit.
+    int s = (VS_DEC_DIGITS + 1) + dy - dx;
+
+    memcpy(u, __x.coefficient, sizeof(__x.coefficient));
+    vs_dec_wscale(u, VS_DEC_XWORDS, s);
+
+    int m = vs_dec_wlen(u, VS_DEC_XWORDS);
+    int n = vs_dec_wlen(__y.coefficient, VS_DEC_WORDS);
+
+    if (n == 1) {
+        memcpy(q, u, sizeof(q));
+        sticky = vs_dec_wdivs(q, m, __y.coefficient[0]) != 0;
+    }
+    else {
+        sticky = vs_dec_wdiv(u, m, __y.coefficient, n, q);
+    }
+
+    return vs_dec_pack(q, __x.exponent - __y.exponent - s, sticky, neg);
+}
+
+#pragma mark Double Arithmetic
+
+double decadd(double __x, double __y) {
+    double o = vs_dec_tod(vs_dec_add(vs_dec_fromd(__x), vs_dec_fromd(__y)));
+
+    return o;
+}
+
+double decsub(double __x, double __y) {
+    double o = vs_dec_tod(vs_dec_sub(vs_dec_fromd(__x), vs_dec_fromd(__y)));
+
+    return o;
+}
+
+double decmul(double __x, double __y) {
+    double o = vs_dec_tod(vs_dec_mul(vs_dec_fromd(__x), vs_dec_fromd(__y)));
+
+    return o;
+}
+
+double decdiv(double __x, double __y) {
+    double o = vs_dec_tod(vs_dec_div(vs_dec_fromd(__x), vs_dec_fromd(__y)));
+
+    return o;
+}
+
+#pragma mark Compensated Arithmetic
+
+/**
+ *  Computes the rounding error of a product exactly, so that __x * __y == p + error.
+ *
+ *  @param __x
+ *  @param __y
+ *  @param __p The rounded product of __x and __y.
+ *
+ *  @return The rounding error.
+ */
+static double vs_dec_twoprod(double __x, double __y, double __p) {
+#ifdef FP_FAST_FMA
+    return fma(__x, __y, -__p);
+#else
+    // Dekker's product: split each factor in two halves of 26 bits whose products are exact.
+    double cx = __x * 134217729.0;
+    double cy = __y * 134217729.0;
+    double xh = cx - (cx - __x);
+    double yh = cy - (cy - __y);
+    double xl = __x - xh;
+    double yl = __y - yh;
+
+    return (((xh * yh - __p) + xh * yl) + xl * yh) + xl * yl;
+#endif
+}
+
+/**
+ *  Gets the coefficient of a decimal converted by vs_dec_fromd(), which has at most 17 digits, as a double-double.
+ *
+ *  @param __d
+ *  @param __l Pointer to receive the low part, such that the coefficient is exactly the returned value + *__l.
+ *
+ *  @return The coefficient rounded to the nearest double.
+ */
+static double vs_dec_fastcoef(vs_dec_t __d, double *__l) {
+    uint64_t c = ((uint64_t)__d.coefficient[1] << 32) | __d.coefficient[0];
+    double h = (double)c;
+
+    *__l = (double)(int64_t)(c - (uint64_t)h);
+
+    return h;
+}
+
+/**
+ *  Rounds a double-double times a power of 10 to the nearest double. The result is the double vs_dec_tod() gives for the exact decimal,
+ *  provided that __h + __l is within a relative VS_DEC_FAST_ERR of it.
+ *
+ *  @param __h High part of the coefficient.
+ *  @param __l Low part of the coefficient, at most a few ulps of __h.
+ *  @param __e Exponent of the power of 10.
+ *  @param __o Pointer to receive the rounded result.
+ *
+ *  @return 1 on success, 0 if the result is not a normal double or lies too close to halfway between two doubles.
+ */
+static int vs_dec_fastround(double __h, double __l, int __e, double *__o) {
+    if ((__e > 22) || (__e < -22)) return 0;
+
+    double p = VS_DEC_POW10_D[(__e >= 0) ? __e : -__e];
+    double sh, sl;
+
+    if (__e >= 0) {
+        sh = __h * p;
+        sl = vs_dec_twoprod(__h, p, sh) + (__l * p);
+    }
+    else {
+        // The remainder __h - sh * p is exact.
+        sh = __h / p;
+        sl = (((__h - (sh * p)) - vs_dec_twoprod(sh, p, sh * p)) + __l) / p;
+    }
+
+    double o = sh + sl;
+    double t = (sh - o) + sl;
+    uint64_t bits;
+
+    if (!isnormal(o)) return 0;
+
+    memcpy(&bits, &o, sizeof(bits));
+
+    // Half an ulp of o, as a double. The previous double is only a quarter of an ulp away from powers of 2.
+    int exponent = (int)((bits >> 52) & 0x7FF);
+
+    if (exponent <= 53) return 0;
+
+    uint64_t halfbits = (uint64_t)(exponent - 53) << 52;
+    double half;
+
+    memcpy(&half, &halfbits, sizeof(half));
+
+    if (((bits & 0xFFFFFFFFFFFFFULL) == 0) && ((t < 0.0) != (o < 0.0))) half *= 0.5;
+
+    if (fabs(fabs(t) - half) <= (fabs(o) * VS_DEC_FAST_ERR)) return 0;
+
+    *__o = o;
+
+    return 1;
+}
+
+/**
+ *  Adds two decimals converted by vs_dec_fromd() in integer and IEEE arithmetic. The coefficients are aligned and summed exactly as
+ *  integers, so only the final conversion is rounded.
+ *
+ *  @param __x
+ *  @param __y
+ *  @param __o Pointer to receive the double value of the sum.
+ *
+ *  @return 1 on success, 0 if the sum must be computed in decimal.
+ */
+static int vs_dec_fastadd(vs_dec_t __x, vs_dec_t __y, double *__o) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return 0;
+
+    uint64_t a = ((uint64_t)__x.coefficient[1] << 32) | __x.coefficient[0];
+    uint64_t b = ((uint64_t)__y.coefficient[1] << 32) | __y.coefficient[0];
+    int e = (__x.exponent < __y.exponent) ? __x.exponent : __y.exponent;
+    int sa = __x.exponent - e;
+    int sb = __y.exponent - e;
+
+    // Aligned coefficients must stay below 2^62 so that their sum cannot overflow.
+    if ((sa > 18) || (sb > 18)) return 0;
+
+    uint64_t pa = ((uint64_t)VS_DEC_POW10[sa][1] << 32) | VS_DEC_POW10[sa][0];
+    uint64_t pb = ((uint64_t)VS_DEC_POW10[sb][1] << 32) | VS_DEC_POW10[sb][0];
+
+    if ((a > ((1ULL << 62) / pa)) || (b > ((1ULL << 62) / pb))) return 0;
+
+    uint64_t c;
+    int neg;
+
+    a *= pa;
+    b *= pb;
+
+    if ((__x.flags & VS_DEC_NEGATIVE) == (__y.flags & VS_DEC_NEGATIVE)) {
+        c = a + b;
+        neg = __x.flags & VS_DEC_NEGATIVE;
+    }
+    else if (a >= b) {
+        c = a - b;
+        neg = __x.flags & VS_DEC_NEGATIVE;
+    }
+    else {
+        c = b - a;
+        neg = __y.flags & VS_DEC_NEGATIVE;
+    }
+
+    if (c == 0) {
+        *__o = 0.0;
+        return 1;
+    }
+
+    double h = (double)c;
+    double l = (double)(int64_t)(c - (uint64_t)h);
+
+    if (!vs_dec_fastround(h, l, e, __o)) return 0;
+
+    if (neg) *__o = -*__o;
+
+    return 1;
+}
+
+/**
+ *  Multiplies two decimals converted by vs_dec_fromd() in IEEE arithmetic. The product of the coefficients is computed as a double-double
+ *  (TwoProduct).
+ *
+ *  @param __x
+ *  @param __y
+ *  @param __o Pointer to receive the double value of the product.
+ *
+ *  @return 1 on success, 0 if the product must be computed in decimal.
+ */
+static int vs_dec_fastmul(vs_dec_t __x, vs_dec_t __y, double *__o) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return 0;
+
+    double al, ah = vs_dec_fastcoef(__x, &al);
+    double bl, bh = vs_dec_fastcoef(__y, &bl);
+
+    if ((ah == 0.0) || (bh == 0.0)) {
+        *__o = 0.0;
+        return 1;
+    }
+
+    double h = ah * bh;
+    double l = vs_dec_twoprod(ah, bh, h) + (((ah * bl) + (al * bh)) + (al * bl));
+
+    if (!vs_dec_fastround(h, l, __x.exponent + __y.exponent, __o)) return 0;
+
+    if ((__x.flags ^ __y.flags) & VS_DEC_NEGATIVE) *__o = -*__o;
+
+    return 1;
+}
+
+/**
+ *  Divides a decimal converted by vs_dec_fromd() by another in IEEE arithmetic. The quotient of the coefficients is computed as a
+ *  double-double from the exact remainder of the IEEE quotient (TwoProduct).
+ *
+ *  @param __x
+ *  @param __y
+ *  @param __o Pointer to receive the double value of the quotient.
+ *
+ *  @return 1 on success, 0 if the quotient must be computed in decimal.
+ */
+static int vs_dec_fastdiv(vs_dec_t __x, vs_dec_t __y, double *__o) {
+    if ((__x.flags | __y.flags) & VS_DEC_NAN) return 0;
+
+    double al, ah = vs_dec_fastcoef(__x, &al);
+    double bl, bh = vs_dec_fastcoef(__y, &bl);
+
+    if (bh == 0.0) return 0;
+
+    if (ah == 0.0) {
+        *__o = 0.0;
+        return 1;
+    }
+
+    // The remainder ah - h * bh is exact.
+    double h = ah / bh;
+    double p = h * bh;
+    double l = ((((ah - p) - vs_dec_twoprod(h, bh, p)) + al) - (h * bl)) / bh;
+
+    if (!vs_dec_fastround(h, l, __x.exponent - __y.exponent, __o)) return 0;
+
+    if ((__x.flags ^ __y.flags) & VS_DEC_NEGATIVE) *__o = -*__o;
+
+    return 1;
+}
+
+double decfastadd(double __x, double __y) {
+    vs_dec_t x = vs_dec_fromd(__x);
+    vs_dec_t y = vs_dec_fromd(__y);
+    double o;
+
+    if (!vs_dec_fastadd(x, y, &o)) {
+        o = vs_dec_tod(vs_dec_add(x, y));
+    }
+
+    return o;
+}
+
+double decfastsub(double __x, double __y) {
+    double o = decfastadd(__x, -__y);
+
+    return o;
+}
+
+double decfastmul(double __x, double __y) {
+    vs_dec_t x = vs_dec_fromd(__x);
+    vs_dec_t y = vs_dec_fromd(__y);
+    double o;
+
+    if (!vs_dec_fastmul(x, y, &o)) {
+        o = vs_dec_tod(vs_dec_mul(x, y));
+    }
+
+    return o;
+}
+
+double decfastdiv(double __x, double __y) {
+    vs_dec_t x = vs_dec_fromd(__x);
+    vs_dec_t y = vs_dec_fromd(__y);
+    double o;
+
+    if (!vs_dec_fastdiv(x, y, &o)) {
+        o = vs_dec_tod(vs_dec_div(x, y));
+    }
+
+    return o;
+}
@@ -0,0 +1,198 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS decimal arithmetic tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vsdec_h
+#define vsdec_h
+
+#include <stdint.h>
+
+/**
+ *  Number of significant digits kept by vs_dec_t, the precision of IEEE 754 decimal128.
+ */
+#define VS_DEC_DIGITS 34
+
+#define VS_DEC_NEGATIVE 0x1
+#define VS_DEC_NAN      0x2
+
+/**
+ *  Value type decimal number: (-1)^negative * coefficient * 10^exponent, where the coefficient has at most VS_DEC_DIGITS digits.
+ *  Arithmetic results are rounded half to even. vs_dec_t never allocates memory and is meant to be passed around by value, replacing
+ *  NSDecimalNumber for the basic arithmetic operations.
+ */
+typedef struct {
+    uint32_t coefficient[4];
+    int exponent;
+    int flags;
+} vs_dec_t;
+
+#pragma mark Conversions
+
+/**
+ *  Converts a double value to decimal, using the shortest decimal representation that reads back as the same double (i.e. 0.1 is
+ *  converted to exactly 1 * 10^-1 rather than to the binary value of 0.1, and 5e-324 to 5 * 10^-324). Infinite and NAN values convert to
+ *  a NAN decimal.
+ *
+ *  @param __n
+ *
+ *  @return The decimal value.
+ */
+vs_dec_t vs_dec_fromd(double __n);
+
+/**
+ *  Converts a decimal value to the nearest double value.
+ *
+ *  @param __d
+ *
+ *  @return The double value, NAN if the decimal is NAN.
+ */
+double vs_dec_tod(vs_dec_t __d);
+
+/**
+ *  Verifies whether a decimal value is NAN.
+ *
+ *  @param __d
+ *
+ *  @return 1 if NAN, 0 otherwise.
+ */
+int vs_dec_isnan(vs_dec_t __d);
+
+#pragma mark Arithmetic
+
+/**
+ *  Adds two decimal values.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The rounded sum.
+ */
+vs_dec_t vs_dec_add(vs_dec_t __x, vs_dec_t __y);
+
+/**
+ *  Subtracts a decimal value from another.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The rounded difference.
+ */
+vs_dec_t vs_dec_sub(vs_dec_t __x, vs_dec_t __y);
+
+/**
+ *  Multiplies two decimal values.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The rounded product.
+ */
+vs_dec_t vs_dec_mul(vs_dec_t __x, vs_dec_t __y);
+
+/**
+ *  Divides a decimal value by another.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The rounded quotient, NAN if __y is 0.
+ */
+vs_dec_t vs_dec_div(vs_dec_t __x, vs_dec_t __y);
+
+#pragma mark Double Arithmetic
+
+/**
+ *  Adds two double values in decimal, so that i.e. 0.1 + 0.2 yields 0.3.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal sum.
+ */
+double decadd(double __x, double __y);
+
+/**
+ *  Subtracts a double value from another in decimal.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal difference.
+ */
+double decsub(double __x, double __y);
+
+/**
+ *  Multiplies two double values in decimal.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal product.
+ */
+double decmul(double __x, double __y);
+
+/**
+ *  Divides a double value by another in decimal.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal quotient, NAN if __y is 0.
+ */
+double decdiv(double __x, double __y);
+
+#pragma mark Compensated Arithmetic
+
+/**
+ *  Adds two double values like decadd(), without decimal arithmetic. The shortest decimals of the operands are aligned and summed
+ *  exactly as integers, then rounded once to the nearest double, so the result is the same double as the one of decadd() (i.e. 0.1 + 0.2
+ *  yields 0.3) and displays the same at any precision. Falls back to decadd() when the aligned operands do not fit in 64 bits or the
+ *  result is not a normal double.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal sum.
+ */
+double decfastadd(double __x, double __y);
+
+/**
+ *  Subtracts a double value from another like decsub(), without decimal arithmetic. See decfastadd().
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal difference.
+ */
+double decfastsub(double __x, double __y);
+
+/**
+ *  Multiplies two double values like decmul(), without decimal arithmetic. The product of the shortest decimals of the operands is
+ *  computed as a double-double (TwoProduct) and rounded to the nearest double, so the result is the same double as the one of decmul().
+ *  Falls back to decmul() when the product lies within 2^-96 of halfway between two doubles, or is not a normal double.
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal product.
+ */
+double decfastmul(double __x, double __y);
+
+/**
+ *  Divides a double value by another like decdiv(), without decimal arithmetic. The quotient of the shortest decimals of the operands is
+ *  computed as a double-double from the exact remainder of the IEEE quotient, see decfastmul().
+ *
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The double value of the decimal quotient, NAN if __y is 0.
+ */
+double decfastdiv(double __x, double __y);
+
+#endif
@@ -0,0 +1,2071 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <float.h>
+#import <math.h>
+#import <stdint.h>
+#import <stdlib.h>
+#import <string.h>
+
+#import "vsdec.h"
+#import "vsexpr.h"
+#import "vsfmath.h"
+#import "vsmath.h"
+#import "vsnum.h"
+
+/**
+ *  Character classes used to merge consecutive characters into a single token, matching +[VSMathUtil numericCharacterSet] and
+ *  +[VSMathUtil functionCharacterSet].
+ */
+#define VS_EXPR_CLASS_NONE     0
+#define VS_EXPR_CLASS_NUMERIC  1
+#define VS_EXPR_CLASS_FUNCTION 2
+
+/**
+ *  Number of stack values and temporaries vs_expr_eval() holds on the thread stack, deeper expressions are evaluated on the heap.
+ */
+#define VS_EXPR_EVAL_SIZE 128
+
+/**
+ *  Symbol table entry.
+ */
+typedef struct {
+    const char *symbol;
+    vs_token_t type;
+    vs_op_t op;
+    unsigned int slot;
+} vs_expr_symbol_t;
+
+/**
+ *  All symbols recognized by the parser, mirroring +[VSMathUtil typeOfToken:]. The equal sign is intentionally absent since the
+ *  Objective-C parser does not recognize it either.
+ */
+static const vs_expr_symbol_t vs_expr_symbols[] = {
+    { VS_M_SYMBOL_ADD,                        VS_TOKEN_OPERATOR,      VS_OP_ADD,                         0 },
+    { VS_M_SYMBOL_SUBTRACT,                   VS_TOKEN_OPERATOR,      VS_OP_SUBTRACT,                    0 },
+    { VS_M_SYMBOL_MULTIPLY,                   VS_TOKEN_OPERATOR,      VS_OP_MULTIPLY,                    0 },
+    { VS_M_SYMBOL_MULTIPLY_ALTERNATE,         VS_TOKEN_OPERATOR,      VS_OP_MULTIPLY,                    0 },
+    { VS_M_SYMBOL_DIVIDE,                     VS_TOKEN_OPERATOR,      VS_OP_DIVIDE,                      0 },
+    { VS_M_SYMBOL_DIVIDE_ALTERNATE,           VS_TOKEN_OPERATOR,      VS_OP_DIVIDE,                      0 },
+    { VS_M_SYMBOL_EXPONENT,                   VS_TOKEN_OPERATOR,      VS_OP_EXPONENT,                    0 },
+    { VS_M_SYMBOL_ROOT,                       VS_TOKEN_OPERATOR,      VS_OP_ROOT,                        0 },
+    { VS_M_SYMBOL_MODULO,                     VS_TOKEN_OPERATOR,      VS_OP_MODULO,                      0 },
+    { VS_M_SYMBOL_SCIENTIFIC_NOTATION,        VS_TOKEN_OPERATOR,      VS_OP_SCIENTIFIC_NOTATION,         0 },
+    { VS_M_SYMBOL_CHOOSE,                     VS_TOKEN_OPERATOR,      VS_OP_CHOOSE,                      0 },
+    { VS_M_SYMBOL_PICK,                       VS_TOKEN_OPERATOR,      VS_OP_PICK,                        0 },
+    { VS_M_SYMBOL_LEFT_SHIFT_BY,              VS_TOKEN_OPERATOR,      VS_OP_LEFT_SHIFT_BY,               0 },
+    { VS_M_SYMBOL_RIGHT_SHIFT_BY,             VS_TOKEN_OPERATOR,      VS_OP_RIGHT_SHIFT_BY,              0 },
+    { VS_M_SYMBOL_AND,                        VS_TOKEN_OPERATOR,      VS_OP_AND,                         0 },
+    { VS_M_SYMBOL_NAND,                       VS_TOKEN_OPERATOR,      VS_OP_NAND,                        0 },
+    { VS_M_SYMBOL_OR,                         VS_TOKEN_OPERATOR,      VS_OP_OR,                          0 },
+    { VS_M_SYMBOL_NOR,                        VS_TOKEN_OPERATOR,      VS_OP_NOR,                         0 },
+    { VS_M_SYMBOL_XOR,                        VS_TOKEN_OPERATOR,      VS_OP_XOR,                         0 },
+    { VS_M_SYMBOL_XNOR,                       VS_TOKEN_OPERATOR,      VS_OP_XNOR,                        0 },
+    { VS_M_SYMBOL_NEGATIVE,                   VS_TOKEN_UNARY_PREFIX,  VS_OP_NEGATIVE,                    0 },
+    { VS_M_SYMBOL_SQUARE_ROOT,                VS_TOKEN_UNARY_PREFIX,  VS_OP_SQUARE_ROOT,                 0 },
+    { VS_M_SYMBOL_CUBE_ROOT,                  VS_TOKEN_UNARY_PREFIX,  VS_OP_CUBE_ROOT,                   0 },
+    { VS_M_SYMBOL_SQUARE,                     VS_TOKEN_UNARY_POSTFIX, VS_OP_SQUARE,                      0 },
+    { VS_M_SYMBOL_CUBE,                       VS_TOKEN_UNARY_POSTFIX, VS_OP_CUBE,                        0 },
+    { VS_M_SYMBOL_FACTORIAL,                  VS_TOKEN_UNARY_POSTFIX, VS_OP_FACTORIAL,                   0 },
+    { VS_M_SYMBOL_SINE,                       VS_TOKEN_FUNCTION,      VS_OP_SINE,                        0 },
+    { VS_M_SYMBOL_COSINE,                     VS_TOKEN_FUNCTION,      VS_OP_COSINE,                      0 },
+    { VS_M_SYMBOL_TANGENT,                    VS_TOKEN_FUNCTION,      VS_OP_TANGENT,                     0 },
+    { VS_M_SYMBOL_INVERSE_SINE,               VS_TOKEN_FUNCTION,      VS_OP_INVERSE_SINE,                0 },
+    { VS_M_SYMBOL_INVERSE_COSINE,             VS_TOKEN_FUNCTION,      VS_OP_INVERSE_COSINE,              0 },
+    { VS_M_SYMBOL_INVERSE_TANGENT,            VS_TOKEN_FUNCTION,      VS_OP_INVERSE_TANGENT,             0 },
+    { VS_M_SYMBOL_HYPERBOLIC_SINE,            VS_TOKEN_FUNCTION,      VS_OP_HYPERBOLIC_SINE,             0 },
+    { VS_M_SYMBOL_HYPERBOLIC_COSINE,          VS_TOKEN_FUNCTION,      VS_OP_HYPERBOLIC_COSINE,           0 },
+    { VS_M_SYMBOL_HYPERBOLIC_TANGENT,         VS_TOKEN_FUNCTION,      VS_OP_HYPERBOLIC_TANGENT,          0 },
+    { VS_M_SYMBOL_INVERSE_HYPERBOLIC_SINE,    VS_TOKEN_FUNCTION,      VS_OP_INVERSE_HYPERBOLIC_SINE,     0 },
+    { VS_M_SYMBOL_INVERSE_HYPERBOLIC_COSINE,  VS_TOKEN_FUNCTION,      VS_OP_INVERSE_HYPERBOLIC_COSINE,   0 },
+    { VS_M_SYMBOL_INVERSE_HYPERBOLIC_TANGENT, VS_TOKEN_FUNCTION,      VS_OP_INVERSE_HYPERBOLIC_TANGENT,  0 },
+    { VS_M_SYMBOL_NATURAL_LOGARITHM,          VS_TOKEN_FUNCTION,      VS_OP_NATURAL_LOGARITHM,           0 },
+    { VS_M_SYMBOL_LOGARITHM_10,               VS_TOKEN_FUNCTION,      VS_OP_LOGARITHM_10,                0 },
+    { VS_M_SYMBOL_LOGARITHM_2,                VS_TOKEN_FUNCTION,      VS_OP_LOGARITHM_2,                 0 },
+    { VS_M_SYMBOL_ABSOLUTE_VALUE,             VS_TOKEN_FUNCTION,      VS_OP_ABSOLUTE_VALUE,              0 },
+    { VS_M_SYMBOL_PERCENT,                    VS_TOKEN_FUNCTION,      VS_OP_PERCENT,                     0 },
+    { VS_M_SYMBOL_LEFT_SHIFT,                 VS_TOKEN_FUNCTION,      VS_OP_LEFT_SHIFT,                  0 },
+    { VS_M_SYMBOL_RIGHT_SHIFT,                VS_TOKEN_FUNCTION,      VS_OP_RIGHT_SHIFT,                 0 },
+    { VS_M_SYMBOL_LEFT_ROTATE,                VS_TOKEN_FUNCTION,      VS_OP_ROL,                         0 },
+    { VS_M_SYMBOL_RIGHT_ROTATE,               VS_TOKEN_FUNCTION,      VS_OP_ROR,                         0 },
+    { VS_M_SYMBOL_ONES_COMPLEMENT,            VS_TOKEN_FUNCTION,      VS_OP_ONES_COMPLEMENT,             0 },
+    { VS_M_SYMBOL_TWOS_COMPLEMENT,            VS_TOKEN_FUNCTION,      VS_OP_TWOS_COMPLEMENT,             0 },
+    { VS_M_SYMBOL_FLIP_WORD,                  VS_TOKEN_FUNCTION,      VS_OP_FLIP_WORD,                   0 },
+    { VS_M_SYMBOL_FLIP_BYTE,                  VS_TOKEN_FUNCTION,      VS_OP_FLIP_BYTE,                   0 },
+    { VS_M_SYMBOL_LEFT_PARENTHESIS,           VS_TOKEN_PARENTHESIS,   VS_OP_LEFT_PARENTHESIS,            0 },
+    { VS_M_SYMBOL_RIGHT_PARENTHESIS,          VS_TOKEN_PARENTHESIS,   VS_OP_RIGHT_PARENTHESIS,           0 },
+    { VS_M_SYMBOL_PI,                         VS_TOKEN_CONSTANT,      VS_OP_PI,                          0 },
+    { VS_M_SYMBOL_RANDOM_NUMBER,              VS_TOKEN_CONSTANT,      VS_OP_RANDOM_NUMBER,               0 },
+    { VS_M_SYMBOL_EULER,                      VS_TOKEN_CONSTANT,      VS_OP_EULER,                       0 },
+    { VS_M_SYMBOL_X_VARIABLE,                 VS_TOKEN_VARIABLE,      VS_OP_UNKNOWN,                     VS_EXPR_SLOT_X },
+    { VS_M_SYMBOL_Y_VARIABLE,                 VS_TOKEN_VARIABLE,      VS_OP_UNKNOWN,                     VS_EXPR_SLOT_Y }
+};
+
+/**
+ *  A classified token, or an entry of the shunting-yard operator stack.
+ */
+typedef struct {
+    vs_token_t type;
+    vs_op_t op;
+    unsigned int slot;
+    double value;
+} vs_expr_token_t;
+
+/**
+ *  Shunting-yard state.
+ */
+typedef struct {
+    vs_expr_t *output;
+    vs_expr_token_t *stack;
+    size_t count;
+} vs_expr_yard_t;
+
+#pragma mark Operations
+
+/**
+ *  Applies the result rules of +[VSMathUtil evaluateOperation:angleMode:operandX:operandY:]: infinite results yield NAN and results
+ *  smaller than DBL_EPSILON snap to 0.
+ *
+ *  @param __o
+ *
+ *  @return The moderated double value.
+ */
+static double vs_op_snap(double __o) {
+    if (__o == INFINITY || __o == -INFINITY) {
+        return NAN;
+    }
+    else if (fabs(__o) < DBL_EPSILON) {
+        return 0.0;
+    }
+    else {
+        return __o;
+    }
+}
+
+/**
+ *  Converts an angle to radians for the fast math approximations, reducing degrees and gradians modulo a full turn first.
+ *
+ *  @param __a
+ *  @param __x
+ *
+ *  @return The angle in radians.
+ */
+static double vs_op_torad(vs_angle_t __a, double __x) {
+    switch (__a) {
+        case VS_ANGLE_DEGREE:  return fdtor(fmod(__x, 360.0));
+        case VS_ANGLE_RADIAN:  return __x;
+        case VS_ANGLE_GRADIAN: return fgtor(fmod(__x, 400.0));
+        default:               return NAN;
+    }
+}
+
+/**
+ *  Applies the rounding rules of fsinr() to an approximated sine. Degrees and gradians are left as is, as their exact counterparts
+ *  do not round either.
+ *
+ *  @param __a
+ *  @param __o
+ *
+ *  @return The moderated double value.
+ */
+static double vs_op_snapsin(vs_angle_t __a, double __o) {
+    if (__a != VS_ANGLE_RADIAN) {
+        return __o;
+    }
+    else if ((1.0 - fabs(__o)) < FLT_EPSILON) {
+        return round(__o);
+    }
+    else if (fabs(__o) < FLT_EPSILON) {
+        return 0.0;
+    }
+    else {
+        return __o;
+    }
+}
+
+/**
+ *  Applies the rounding rules of fcosr() to an approximated cosine. Degrees and gradians are left as is, as their exact counterparts
+ *  do not round either.
+ *
+ *  @param __a
+ *  @param __o
+ *
+ *  @return The moderated double value.
+ */
+static double vs_op_snapcos(vs_angle_t __a, double __o) {
+    if (__a != VS_ANGLE_RADIAN) {
+        return __o;
+    }
+    else if (fabs(__o) < FLT_EPSILON) {
+        return 0.0;
+    }
+    else {
+        return __o;
+    }
+}
+
+/**
+ *  Evaluates an operation with its vsfmath approximation. Only valid for operations where vs_op_isapprox() is 1.
+ *
+ *  @param __op
+ *  @param __a
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The approximated double value, before snapping.
+ */
+static double vs_op_approx(vs_op_t __op, vs_angle_t __a, double __x, double __y) {
+    if (isnan(__x)) return NAN;
+
+    switch (__op) {
+        case VS_OP_SINE:                      return vs_op_snapsin(__a, fastsin(vs_op_torad(__a, __x)));
+        case VS_OP_COSINE:                    return vs_op_snapcos(__a, fastcos(vs_op_torad(__a, __x)));
+        case VS_OP_HYPERBOLIC_SINE:           return fastsinh(__x);
+        case VS_OP_HYPERBOLIC_COSINE:         return fastcosh(__x);
+        case VS_OP_HYPERBOLIC_TANGENT:        return fasttanh(__x);
+        case VS_OP_NATURAL_LOGARITHM:         return fastlog(__x);
+        case VS_OP_INVERSE_NATURAL_LOGARITHM: return fastexp(__x);
+        case VS_OP_EXPONENT:                  return isnan(__y) ? NAN : fastpow(__x, __y);
+        default:                              return NAN;
+    }
+}
+
+int vs_op_isapprox(vs_op_t __op) {
+    switch (__op) {
+        case VS_OP_SINE:
+        case VS_OP_COSINE:
+        case VS_OP_HYPERBOLIC_SINE:
+        case VS_OP_HYPERBOLIC_COSINE:
+        case VS_OP_HYPERBOLIC_TANGENT:
+        case VS_OP_NATURAL_LOGARITHM:
+        case VS_OP_INVERSE_NATURAL_LOGARITHM:
+        case VS_OP_EXPONENT:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+int vs_op_isarith(vs_op_t __op) {
+    switch (__op) {
+        case VS_OP_ADD:
+        case VS_OP_SUBTRACT:
+        case VS_OP_MULTIPLY:
+        case VS_OP_DIVIDE:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+double vs_op_eval(vs_op_t __op, vs_angle_t __a, double __x, double __y) {
+    return vs_op_evalm(__op, __a, VS_EXPR_MODE_DEFAULT, __x, __y);
+}
+
+double vs_op_evalm(vs_op_t __op, vs_angle_t __a, int __m, double __x, double __y) {
+    double o;
+
+    if ((__m & VS_EXPR_MODE_FAST_MATH) && vs_op_isapprox(__op)) {
+        return vs_op_snap(vs_op_approx(__op, __a, __x, __y));
+    }
+
+    if ((__m & VS_EXPR_MODE_FAST_ARITHMETIC) && vs_op_isarith(__op)) {
+        if (isnan(__x) || isnan(__y)) return NAN;
+
+        switch (__op) {
+            case VS_OP_ADD:      return vs_op_snap(decfastadd(__x, __y));
+            case VS_OP_SUBTRACT: return vs_op_snap(decfastsub(__x, __y));
+            case VS_OP_MULTIPLY: return vs_op_snap(decfastmul(__x, __y));
+            default:             return vs_op_snap(decfastdiv(__x, __y));
+        }
+    }
+
+    switch (__op) {
+        case VS_OP_ADD:                       if (isnan(__x) || isnan(__y)) return NAN; o = decadd(__x, __y); break;
+        case VS_OP_SUBTRACT:                  if (isnan(__x) || isnan(__y)) return NAN; o = decsub(__x, __y); break;
+        case VS_OP_MULTIPLY:                  if (isnan(__x) || isnan(__y)) return NAN; o = decmul(__x, __y); break;
+        case VS_OP_DIVIDE:                    if (isnan(__x) || isnan(__y)) return NAN; o = decdiv(__x, __y); break;
+        case VS_OP_MODULO:                    if (isnan(__x) || isnan(__y)) return NAN; o = fmod(__x, __y); break;
+        case VS_OP_EXPONENT:                  if (isnan(__x) || isnan(__y)) return NAN; o = fpow(__x, __y); break;
+        case VS_OP_ROOT:                      if (isnan(__x) || isnan(__y)) return NAN; o = froot(__x, __y); break;
+        case VS_OP_SCIENTIFIC_NOTATION:       if (isnan(__x) || isnan(__y)) return NAN; o = __x * fpow(10.0, __y); break;
+        case VS_OP_CHOOSE:                    if (isnan(__x) || isnan(__y)) return NAN; o = fncr(__x, __y); break;
+        case VS_OP_PICK:                      if (isnan(__x) || isnan(__y)) return NAN; o = fnpr(__x, __y); break;
+
+        case VS_OP_SINE: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = fsind(__x); break;
+                case VS_ANGLE_RADIAN:  o = fsinr(__x); break;
+                case VS_ANGLE_GRADIAN: o = fsing(__x); break;
+                default:               o = NAN;        break;
+            }
+
+            break;
+        }
+
+        case VS_OP_COSINE: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = fcosd(__x); break;
+                case VS_ANGLE_RADIAN:  o = fcosr(__x); break;
+                case VS_ANGLE_GRADIAN: o = fcosg(__x); break;
+                default:               o = NAN;        break;
+            }
+
+            break;
+        }
+
+        case VS_OP_TANGENT: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = ftand(__x); break;
+                case VS_ANGLE_RADIAN:  o = ftanr(__x); break;
+                case VS_ANGLE_GRADIAN: o = ftang(__x); break;
+                default:               o = NAN;        break;
+            }
+
+            break;
+        }
+
+        case VS_OP_INVERSE_SINE: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = frtod(asin(__x)); break;
+                case VS_ANGLE_RADIAN:  o = asin(__x);        break;
+                case VS_ANGLE_GRADIAN: o = frtog(asin(__x)); break;
+                default:               o = NAN;              break;
+            }
+
+            break;
+        }
+
+        case VS_OP_INVERSE_COSINE: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = frtod(acos(__x)); break;
+                case VS_ANGLE_RADIAN:  o = acos(__x);        break;
+                case VS_ANGLE_GRADIAN: o = frtog(acos(__x)); break;
+                default:               o = NAN;              break;
+            }
+
+            break;
+        }
+
+        case VS_OP_INVERSE_TANGENT: {
+            if (isnan(__x)) return NAN;
+
+            switch (__a) {
+                case VS_ANGLE_DEGREE:  o = frtod(atan(__x)); break;
+                case VS_ANGLE_RADIAN:  o = atan(__x);        break;
+                case VS_ANGLE_GRADIAN: o = frtog(atan(__x)); break;
+                default:               o = NAN;              break;
+            }
+
+            break;
+        }
+
+        case VS_OP_HYPERBOLIC_SINE:           if (isnan(__x)) return NAN; o = sinh(__x);          break;
+        case VS_OP_HYPERBOLIC_COSINE:         if (isnan(__x)) return NAN; o = cosh(__x);          break;
+        case VS_OP_HYPERBOLIC_TANGENT:        if (isnan(__x)) return NAN; o = tanh(__x);          break;
+        case VS_OP_INVERSE_HYPERBOLIC_SINE:   if (isnan(__x)) return NAN; o = asinh(__x);         break;
+        case VS_OP_INVERSE_HYPERBOLIC_COSINE: if (isnan(__x)) return NAN; o = acosh(__x);         break;
+        case VS_OP_INVERSE_HYPERBOLIC_TANGENT:if (isnan(__x)) return NAN; o = atanh(__x);         break;
+        case VS_OP_LOGARITHM_10:              if (isnan(__x)) return NAN; o = log10(__x);         break;
+        case VS_OP_INVERSE_LOGARITHM_10:      if (isnan(__x)) return NAN; o = fpow(10.0, __x);    break;
+        case VS_OP_LOGARITHM_2:               if (isnan(__x)) return NAN; o = log2(__x);          break;
+        case VS_OP_INVERSE_LOGARITHM_2:       if (isnan(__x)) return NAN; o = fpow(2.0, __x);     break;
+        case VS_OP_NATURAL_LOGARITHM:         if (isnan(__x)) return NAN; o = fln(__x);           break;
+        case VS_OP_INVERSE_NATURAL_LOGARITHM: if (isnan(__x)) return NAN; o = exp(__x);           break;
+        case VS_OP_ABSOLUTE_VALUE:            if (isnan(__x)) return NAN; o = fabs(__x);          break;
+        case VS_OP_SQUARE:                    if (isnan(__x)) return NAN; o = fpow(__x, 2.0);     break;
+        case VS_OP_SQUARE_ROOT:               if (isnan(__x)) return NAN; o = sqrt(__x);          break;
+        case VS_OP_CUBE:                      if (isnan(__x)) return NAN; o = fpow(__x, 3.0);     break;
+        case VS_OP_CUBE_ROOT:                 if (isnan(__x)) return NAN; o = cbrt(__x);          break;
+        case VS_OP_NEGATIVE:                  if (isnan(__x)) return NAN; o = __x * -1;           break;
+        case VS_OP_FACTORIAL:                 if (isnan(__x)) return NAN; o = ffact(__x);         break;
+        case VS_OP_PERCENT:                   if (isnan(__x)) return NAN; o = __x / 100.0;        break;
+        case VS_OP_INVERSE:                   if (isnan(__x)) return NAN; o = 1.0 / __x;          break;
+        case VS_OP_PI:                        o = M_PI;                                           break;
+        case VS_OP_EULER:                     o = M_E;                                            break;
+        case VS_OP_RANDOM_NUMBER:             o = ((double)arc4random()/VS_M_ARC4RANDOM_MAX);     break;
+        default:                              return NAN;
+    }
+
+    return vs_op_snap(o);
+}
+
+int vs_op_prec(vs_op_t __op) {
+    switch (__op) {
+        case VS_OP_EQUAL:
+            return 1;
+
+        case VS_OP_OR:
+        case VS_OP_NOR:
+            return 2;
+
+        case VS_OP_XOR:
+        case VS_OP_XNOR:
+            return 3;
+
+        case VS_OP_AND:
+        case VS_OP_NAND:
+            return 4;
+
+        case VS_OP_LEFT_SHIFT_BY:
+        case VS_OP_RIGHT_SHIFT_BY:
+            return 5;
+
+        case VS_OP_ADD:
+        case VS_OP_SUBTRACT:
+            return 6;
+
+        case VS_OP_MULTIPLY:
+        case VS_OP_DIVIDE:
+        case VS_OP_MODULO:
+            return 7;
+
+        case VS_OP_EXPONENT:
+        case VS_OP_ROOT:
+        case VS_OP_SCIENTIFIC_NOTATION:
+        case VS_OP_CHOOSE:
+        case VS_OP_PICK:
+        case VS_OP_NEGATIVE:
+            return 8;
+
+        case VS_OP_SQUARE_ROOT:
+        case VS_OP_CUBE_ROOT:
+            return 9;
+
+        default:
+            return -1;
+    }
+}
+
+int vs_op_israssoc(vs_op_t __op) {
+    switch (__op) {
+        case VS_OP_EQUAL:
+        case VS_OP_EXPONENT:
+        case VS_OP_ROOT:
+        case VS_OP_SCIENTIFIC_NOTATION:
+        case VS_OP_NEGATIVE:
+        case VS_OP_SQUARE_ROOT:
+        case VS_OP_CUBE_ROOT:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+#pragma mark Compiled Expressions
+
+vs_expr_t *vs_expr_alloc(unsigned int __n) {
+    vs_expr_t *e = (vs_expr_t *)calloc(1, sizeof(vs_expr_t));
+
+    if (e == NULL) {
+        return NULL;
+    }
+
+    if (__n < 8) __n = 8;
+
+    e->instrs = (vs_instr_t *)malloc(sizeof(vs_instr_t) * __n);
+
+    if (e->instrs == NULL) {
+        free(e);
+        return NULL;
+    }
+
+    e->capacity = __n;
+    e->nslots = 2;
+
+    return e;
+}
+
+void vs_expr_free(vs_expr_t *__e) {
+    if (__e == NULL) {
+        return;
+    }
+
+    free(__e->instrs);
+    free(__e);
+}
+
+/**
+ *  Appends an instruction, growing the instruction array and tracking the operand stack depth.
+ *
+ *  @param __e
+ *  @param __i
+ *  @param __pops Number of operands consumed by the instruction.
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+static int vs_expr_push(vs_expr_t *__e, vs_instr_t __i, unsigned int __pops) {
+    if (__e == NULL) {
+        return VS_EXPR_ENOMEM;
+    }
+
+    if (__e->depth < __pops) {
+        return VS_EXPR_ESYNTAX;
+    }
+
+    if (__e->count >= __e->capacity) {
+        unsigned int n = __e->capacity * 2;
+        vs_instr_t *instrs = (vs_instr_t *)realloc(__e->instrs, sizeof(vs_instr_t) * n);
+
+        if (instrs == NULL) {
+            return VS_EXPR_ENOMEM;
+        }
+
+        __e->instrs = instrs;
+        __e->capacity = n;
+    }
+
+    __e->instrs[__e->count++] = __i;
+    __e->depth = __e->depth - __pops + 1;
+
+    if (__e->depth > __e->maxdepth) {
+        __e->maxdepth = __e->depth;
+    }
+
+    return VS_EXPR_OK;
+}
+
+int vs_expr_pushconst(vs_expr_t *__e, double __v) {
+    vs_instr_t i = { VS_INSTR_CONSTANT, VS_OP_UNKNOWN, 0, __v };
+
+    return vs_expr_push(__e, i, 0);
+}
+
+int vs_expr_pushvar(vs_expr_t *__e, unsigned int __slot) {
+    vs_instr_t i = { VS_INSTR_VARIABLE, VS_OP_UNKNOWN, __slot, NAN };
+
+    int s = vs_expr_push(__e, i, 0);
+
+    if ((s == VS_EXPR_OK) && (__slot >= __e->nslots)) {
+        __e->nslots = __slot + 1;
+    }
+
+    return s;
+}
+
+int vs_expr_pushop(vs_expr_t *__e, vs_op_t __op, int __arity) {
+    vs_instr_t i = { VS_INSTR_NULLARY, __op, 0, NAN };
+
+    switch (__arity) {
+        case 0: {
+            // Random numbers must be drawn on every evaluation, all other constants are resolved now.
+            if (__op == VS_OP_RANDOM_NUMBER) {
+                return vs_expr_push(__e, i, 0);
+            }
+            else {
+                return vs_expr_pushconst(__e, vs_op_eval(__op, VS_ANGLE_UNKNOWN, NAN, NAN));
+            }
+        }
+
+        case 1: {
+            i.kind = VS_INSTR_UNARY;
+            return vs_expr_push(__e, i, 1);
+        }
+
+        case 2: {
+            i.kind = VS_INSTR_BINARY;
+            return vs_expr_push(__e, i, 2);
+        }
+
+        default: {
+            return VS_EXPR_ESYNTAX;
+        }
+    }
+}
+
+int vs_expr_iscomplete(const vs_expr_t *__e) {
+    return ((__e != NULL) && (__e->count > 0) && (__e->depth == 1));
+}
+
+/**
+ *  Gets the number of operands an instruction pops. Every instruction pushes exactly one value.
+ *
+ *  @param __i
+ *
+ *  @return The number of operands.
+ */
+static unsigned int vs_expr_arity(const vs_instr_t *__i) {
+    switch (__i->kind) {
+        case VS_INSTR_UNARY:
+        case VS_INSTR_POWI:
+        case VS_INSTR_SCALE:
+        case VS_INSTR_STORE:  return 1;
+        case VS_INSTR_BINARY: return 2;
+        case VS_INSTR_FMA:    return 3;
+        default:              return 0;
+    }
+}
+
+/**
+ *  Recomputes the depth and max depth of a compiled expression whose instructions were rewritten.
+ *
+ *  @param __e
+ */
+static void vs_expr_measure(vs_expr_t *__e) {
+    unsigned int depth = 0;
+
+    __e->maxdepth = 0;
+
+    for (unsigned int k = 0; k < __e->count; k++) {
+        depth = depth + 1 - vs_expr_arity(&__e->instrs[k]);
+
+        if (depth > __e->maxdepth) {
+            __e->maxdepth = depth;
+        }
+    }
+
+    __e->depth = depth;
+}
+
+/**
+ *  Raises a value to a positive integer power by repeated squaring.
+ *
+ *  @param __x
+ *  @param __n
+ *
+ *  @return The moderated double value.
+ */
+static double vs_expr_powi(double __x, unsigned int __n) {
+    double o = 1.0;
+
+    if (isnan(__x)) return NAN;
+
+    while (__n > 0) {
+        if (__n & 1) o *= __x;
+
+        __x *= __x;
+        __n >>= 1;
+    }
+
+    return vs_op_snap(o);
+}
+
+/**
+ *  Computes the fused multiply-add of the operands of a VS_INSTR_FMA instruction.
+ *
+ *  @param __layout VS_EXPR_FMA_* operand layout.
+ *  @param __p      Bottommost operand.
+ *  @param __q
+ *  @param __r      Topmost operand.
+ *
+ *  @return The moderated double value.
+ */
+static double vs_expr_fma(unsigned int __layout, double __p, double __q, double __r) {
+    if (isnan(__p) || isnan(__q) || isnan(__r)) return NAN;
+
+    switch (__layout) {
+        case VS_EXPR_FMA_ADD:       return vs_op_snap(fma(__p, __q, __r));
+        case VS_EXPR_FMA_RADD:      return vs_op_snap(fma(__q, __r, __p));
+        case VS_EXPR_FMA_SUBTRACT:  return vs_op_snap(fma(__p, __q, -__r));
+        default:                    return vs_op_snap(fma(-__q, __r, __p));
+    }
+}
+
+/**
+ *  Applies an instruction other than a variable to an evaluation stack.
+ *
+ *  @param __i
+ *  @param __a
+ *  @param __m     VS_EXPR_MODE_DEFAULT or a combination of VS_EXPR_MODE_* flags.
+ *  @param __stack
+ *  @param __top   Pointer to the number of values on the stack.
+ *  @param __temps Temporaries of the expression.
+ */
+static inline void vs_expr_apply(const vs_instr_t *__i, vs_angle_t __a, int __m, double *__stack, unsigned int *__top, double *__temps) {
+    unsigned int top = *__top;
+
+    switch (__i->kind) {
+        case VS_INSTR_CONSTANT: {
+            __stack[top++] = __i->value;
+            break;
+        }
+
+        case VS_INSTR_NULLARY: {
+            __stack[top++] = vs_op_evalm(__i->op, __a, __m, NAN, NAN);
+            break;
+        }
+
+        case VS_INSTR_UNARY: {
+            __stack[top-1] = vs_op_evalm(__i->op, __a, __m, __stack[top-1], NAN);
+            break;
+        }
+
+        case VS_INSTR_BINARY: {
+            top--;
+            __stack[top-1] = vs_op_evalm(__i->op, __a, __m, __stack[top-1], __stack[top]);
+            break;
+        }
+
+        case VS_INSTR_POWI: {
+            __stack[top-1] = vs_expr_powi(__stack[top-1], __i->slot);
+            break;
+        }
+
+        case VS_INSTR_SCALE: {
+            __stack[top-1] = vs_op_snap(__stack[top-1] * __i->value);
+            break;
+        }
+
+        case VS_INSTR_FMA: {
+            top -= 2;
+            __stack[top-1] = vs_expr_fma(__i->slot, __stack[top-1], __stack[top], __stack[top+1]);
+            break;
+        }
+
+        case VS_INSTR_STORE: {
+            __temps[__i->slot] = __stack[top-1];
+            break;
+        }
+
+        case VS_INSTR_LOAD: {
+            __stack[top++] = __temps[__i->slot];
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    *__top = top;
+}
+
+double vs_expr_eval(const vs_expr_t *__e, vs_angle_t __a, int __m, const double *__v, size_t __n, int *__s) {
+    if (!vs_expr_iscomplete(__e)) {
+        if (__s != NULL) *__s = VS_EXPR_ESYNTAX;
+        return NAN;
+    }
+
+    if (__v == NULL) __n = 0;
+
+    // The size of the stack depends on the expression, which may come from user input, so it is only bounded on the thread stack.
+    double buffer[VS_EXPR_EVAL_SIZE];
+    size_t size = (size_t)__e->maxdepth + __e->ntemps;
+    double *stack = (size <= VS_EXPR_EVAL_SIZE) ? buffer : (double *)malloc(sizeof(double) * size);
+    unsigned int top = 0;
+
+    if (stack == NULL) {
+        if (__s != NULL) *__s = VS_EXPR_ENOMEM;
+        return NAN;
+    }
+
+    double *temps = stack + __e->maxdepth;
+
+    for (unsigned int k = 0; k < __e->count; k++) {
+        const vs_instr_t *i = &__e->instrs[k];
+
+        if (i->kind != VS_INSTR_VARIABLE) {
+            vs_expr_apply(i, __a, __m, stack, &top, temps);
+        }
+        else if (i->slot < __n) {
+            stack[top++] = __v[i->slot];
+        }
+        else if ((i->slot == VS_EXPR_SLOT_X) || (i->slot == VS_EXPR_SLOT_Y)) {
+            stack[top++] = NAN;
+        }
+        else {
+            if (stack != buffer) free(stack);
+            if (__s != NULL) *__s = VS_EXPR_EUNBOUND;
+            return NAN;
+        }
+    }
+
+    double o = stack[0];
+
+    if (stack != buffer) free(stack);
+    if (__s != NULL) *__s = VS_EXPR_OK;
+
+    return o;
+}
+
+#pragma mark Strength Reduction
+
+/**
+ *  Verifies whether an instruction yields a moderated operation result (see vs_op_snap()), which is never infinite, subnormal or -0.
+ *
+ *  @param __i
+ *
+ *  @return 1 if moderated, 0 otherwise.
+ */
+static int vs_expr_ismoderated(const vs_instr_t *__i) {
+    return ((__i->kind != VS_INSTR_CONSTANT) && (__i->kind != VS_INSTR_VARIABLE));
+}
+
+/**
+ *  Verifies whether an instruction is a constant of a given value.
+ *
+ *  @param __i
+ *  @param __v
+ *
+ *  @return 1 if so, 0 otherwise.
+ */
+static int vs_expr_isconst(const vs_instr_t *__i, double __v) {
+    return ((__i->kind == VS_INSTR_CONSTANT) && (__i->value == __v));
+}
+
+/**
+ *  Removes an instruction of a compiled expression being reduced.
+ *
+ *  @param __i Instructions.
+ *  @param __w Number of instructions.
+ *  @param __k Index of the instruction to remove.
+ */
+static void vs_expr_remove(vs_instr_t *__i, unsigned int *__w, unsigned int __k) {
+    memmove(&__i[__k], &__i[__k + 1], sizeof(vs_instr_t) * (*__w - __k - 1));
+    (*__w)--;
+}
+
+int vs_expr_reduce(vs_expr_t *__e) {
+    if (__e == NULL) {
+        return VS_EXPR_ENOMEM;
+    }
+
+    if (__e->count == 0) {
+        return VS_EXPR_OK;
+    }
+
+    // Index of the first instruction of every operand on the stack.
+    unsigned int *starts = (unsigned int *)malloc(sizeof(unsigned int) * __e->count);
+
+    if (starts == NULL) {
+        return VS_EXPR_ENOMEM;
+    }
+
+    vs_instr_t *o = __e->instrs;
+    unsigned int w = 0;
+    unsigned int top = 0;
+
+    // Every instruction is rewritten into at most one instruction, so the program is rewritten in place.
+    for (unsigned int k = 0; k < __e->count; k++) {
+        vs_instr_t i = __e->instrs[k];
+
+        switch (i.kind) {
+            case VS_INSTR_UNARY: {
+                unsigned int a = starts[top - 1];
+
+                if ((i.op == VS_OP_SQUARE) || (i.op == VS_OP_CUBE)) {
+                    i.kind = VS_INSTR_POWI;
+                    i.slot = (i.op == VS_OP_SQUARE) ? 2 : 3;
+                }
+                else if ((i.op == VS_OP_NEGATIVE) && (w - a >= 2) && (o[w - 1].kind == VS_INSTR_UNARY) && (o[w - 1].op == VS_OP_NEGATIVE) && vs_expr_ismoderated(&o[w - 2])) {
+                    w--;
+                    continue;
+                }
+
+                o[w++] = i;
+                continue;
+            }
+
+            case VS_INSTR_BINARY: {
+                unsigned int a = starts[top - 2];
+                unsigned int b = starts[top - 1];
+                const vs_instr_t *x = &o[b - 1];
+                const vs_instr_t *y = &o[w - 1];
+                int isyconst = ((w - b == 1) && (y->kind == VS_INSTR_CONSTANT));
+
+                top--;
+
+                switch (i.op) {
+                    case VS_OP_MULTIPLY: {
+                        if (isyconst && (y->value == 1.0) && vs_expr_ismoderated(x)) {
+                            w--;
+                            continue;
+                        }
+
+                        if ((b - a == 1) && vs_expr_isconst(x, 1.0) && vs_expr_ismoderated(y)) {
+                            vs_expr_remove(o, &w, a);
+                            continue;
+                        }
+
+                        break;
+                    }
+
+                    case VS_OP_DIVIDE: {
+                        if (isyconst && (y->value == 1.0) && vs_expr_ismoderated(x)) {
+                            w--;
+                            continue;
+                        }
+
+                        // Reciprocals which overflow (i.e. of 5e-324) or are subnormal would not scale like the division.
+                        if (isyconst && isnormal(1.0 / y->value)) {
+                            i.kind = VS_INSTR_SCALE;
+                            i.value = 1.0 / y->value;
+                            w--;
+                        }
+
+                        break;
+                    }
+
+                    case VS_OP_EXPONENT: {
+                        if (isyconst && (y->value >= 2.0) && (y->value <= VS_EXPR_POWI_MAX) && (y->value == floor(y->value))) {
+                            i.kind = VS_INSTR_POWI;
+                            i.slot = (unsigned int)y->value;
+                            w--;
+                        }
+
+                        break;
+                    }
+
+                    case VS_OP_ADD:
+                    case VS_OP_SUBTRACT: {
+                        if (isyconst && (y->value == 0.0) && vs_expr_ismoderated(x)) {
+                            w--;
+                            continue;
+                        }
+
+                        if ((i.op == VS_OP_ADD) && (b - a == 1) && vs_expr_isconst(x, 0.0) && vs_expr_ismoderated(y)) {
+                            vs_expr_remove(o, &w, a);
+                            continue;
+                        }
+
+                        // Fuse with the product on top, then with the product below.
+                        if ((y->kind == VS_INSTR_BINARY) && (y->op == VS_OP_MULTIPLY)) {
+                            i.kind = VS_INSTR_FMA;
+                            i.slot = (i.op == VS_OP_ADD) ? VS_EXPR_FMA_RADD : VS_EXPR_FMA_RSUBTRACT;
+                            w--;
+                        }
+                        else if ((x->kind == VS_INSTR_BINARY) && (x->op == VS_OP_MULTIPLY)) {
+                            i.kind = VS_INSTR_FMA;
+                            i.slot = (i.op == VS_OP_ADD) ? VS_EXPR_FMA_ADD : VS_EXPR_FMA_SUBTRACT;
+                            vs_expr_remove(o, &w, b - 1);
+                        }
+
+                        break;
+                    }
+
+                    default: {
+                        break;
+                    }
+                }
+
+                o[w++] = i;
+                continue;
+            }
+
+            default: {
+                // Constants, variables, nullary operations and instructions which are already reduced.
+                if ((i.kind == VS_INSTR_CONSTANT) || (i.kind == VS_INSTR_VARIABLE) || (i.kind == VS_INSTR_NULLARY) || (i.kind == VS_INSTR_LOAD)) {
+                    starts[top++] = w;
+                }
+                else if (i.kind == VS_INSTR_FMA) {
+                    top -= 2;
+                }
+
+                o[w++] = i;
+                continue;
+            }
+        }
+    }
+
+    free(starts);
+
+    // Fused operands stay on the stack longer, so the max depth is recomputed.
+    __e->count = w;
+
+    vs_expr_measure(__e);
+
+    return VS_EXPR_OK;
+}
+
+#pragma mark Common Subexpression Elimination
+
+/**
+ *  No instruction, node or temporary.
+ */
+#define VS_EXPR_NONE ((unsigned int)-1)
+
+/**
+ *  Distinct subexpression of a compiled expression being shared: the root instruction of its first occurrence, the distinct
+ *  subexpressions of its operands, the number of references to it from distinct subexpressions and its temporary, if shared.
+ */
+typedef struct {
+    unsigned int instr;
+    unsigned int arity;
+    unsigned int operands[3];
+    unsigned int refs;
+    unsigned int temp;
+} vs_expr_node_t;
+
+/**
+ *  Hashes an instruction along with the distinct subexpressions of its operands (FNV-1a over their words).
+ *
+ *  @param __i
+ *  @param __o Nodes of the operands.
+ *  @param __n Number of operands.
+ *
+ *  @return The hash.
+ */
+static uint64_t vs_expr_hash(const vs_instr_t *__i, const unsigned int *__o, unsigned int __n) {
+    uint64_t bits;
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    memcpy(&bits, &__i->value, sizeof(bits));
+
+    h = (h ^ (uint64_t)__i->kind) * 0x100000001b3ULL;
+    h = (h ^ (uint64_t)__i->op) * 0x100000001b3ULL;
+    h = (h ^ (uint64_t)__i->slot) * 0x100000001b3ULL;
+    h = (h ^ bits) * 0x100000001b3ULL;
+
+    for (unsigned int j = 0; j < __n; j++) {
+        h = (h ^ (uint64_t)__o[j]) * 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+/**
+ *  Verifies whether a node stands for an instruction applied to the given operand nodes.
+ *
+ *  @param __e
+ *  @param __node
+ *  @param __i
+ *  @param __o Nodes of the operands.
+ *  @param __n Number of operands.
+ *
+ *  @return 1 if identical, 0 otherwise.
+ */
+static int vs_expr_isnode(const vs_expr_t *__e, const vs_expr_node_t *__node, const vs_instr_t *__i, const unsigned int *__o, unsigned int __n) {
+    const vs_instr_t *i = &__e->instrs[__node->instr];
+
+    if ((i->kind != __i->kind) || (i->op != __i->op) || (i->slot != __i->slot) || (memcmp(&i->value, &__i->value, sizeof(double)) != 0)) {
+        return 0;
+    }
+
+    return ((__node->arity == __n) && (memcmp(__node->operands, __o, sizeof(unsigned int) * __n) == 0));
+}
+
+int vs_expr_share(vs_expr_t *__e) {
+    if (__e == NULL) {
+        return VS_EXPR_ENOMEM;
+    }
+
+    // Already shared expressions have nothing left to share.
+    if ((__e->count == 0) || (__e->ntemps > 0)) {
+        return VS_EXPR_OK;
+    }
+
+    unsigned int n = __e->count;
+    unsigned int size = 16;
+
+    while (size < n * 2) size <<= 1;
+
+    vs_expr_node_t *nodes = (vs_expr_node_t *)malloc(sizeof(vs_expr_node_t) * n);
+    unsigned int *ids = (unsigned int *)malloc(sizeof(unsigned int) * n);
+    unsigned int *starts = (unsigned int *)malloc(sizeof(unsigned int) * n);
+    unsigned int *stack = (unsigned int *)malloc(sizeof(unsigned int) * n);
+    unsigned int *table = (unsigned int *)malloc(sizeof(unsigned int) * size);
+
+    if ((nodes == NULL) || (ids == NULL) || (starts == NULL) || (stack == NULL) || (table == NULL)) {
+        free(nodes);
+        free(ids);
+        free(starts);
+        free(stack);
+        free(table);
+
+        return VS_EXPR_ENOMEM;
+    }
+
+    memset(table, 0xFF, sizeof(unsigned int) * size);
+
+    unsigned int count = 0;
+    unsigned int top = 0;
+
+    // Hash-cons every subtree into its distinct node, recording where each subtree starts.
+    for (unsigned int k = 0; k < n; k++) {
+        const vs_instr_t *i = &__e->instrs[k];
+        unsigned int arity = vs_expr_arity(i);
+        unsigned int operands[3];
+
+        top -= arity;
+
+        for (unsigned int j = 0; j < arity; j++) {
+            operands[j] = ids[stack[top + j]];
+        }
+
+        starts[k] = (arity > 0) ? starts[stack[top]] : k;
+
+        unsigned int id = VS_EXPR_NONE;
+        unsigned int slot = VS_EXPR_NONE;
+
+        // Random numbers are drawn anew for every occurrence.
+        if (!((i->kind == VS_INSTR_NULLARY) && (i->op == VS_OP_RANDOM_NUMBER))) {
+            slot = (unsigned int)vs_expr_hash(i, operands, arity) & (size - 1);
+
+            while ((table[slot] != VS_EXPR_NONE) && !vs_expr_isnode(__e, &nodes[table[slot]], i, operands, arity)) {
+                slot = (slot + 1) & (size - 1);
+            }
+
+            id = table[slot];
+        }
+
+        if (id == VS_EXPR_NONE) {
+            id = count++;
+
+            nodes[id].instr = k;
+            nodes[id].arity = arity;
+            nodes[id].refs = 0;
+            nodes[id].temp = VS_EXPR_NONE;
+
+            for (unsigned int j = 0; j < arity; j++) {
+                nodes[id].operands[j] = operands[j];
+                nodes[operands[j]].refs++;
+            }
+
+            if (slot != VS_EXPR_NONE) {
+                table[slot] = id;
+            }
+        }
+
+        ids[k] = id;
+        stack[top++] = k;
+    }
+
+    free(table);
+
+    // Share every operation result referenced more than once, in the order they are first computed.
+    unsigned int ntemps = 0;
+
+    for (unsigned int id = 0; id < count; id++) {
+        if ((nodes[id].arity > 0) && (nodes[id].refs > 1)) {
+            nodes[id].temp = ntemps++;
+        }
+    }
+
+    vs_instr_t *instrs = (ntemps > 0) ? (vs_instr_t *)malloc(sizeof(vs_instr_t) * (n + ntemps)) : NULL;
+
+    if (instrs == NULL) {
+        free(nodes);
+        free(ids);
+        free(starts);
+        free(stack);
+
+        return (ntemps > 0) ? VS_EXPR_ENOMEM : VS_EXPR_OK;
+    }
+
+    // Every later occurrence of a shared node is loaded instead, the outermost one wherever several start at the same instruction.
+    unsigned int *skips = stack;
+
+    memset(skips, 0xFF, sizeof(unsigned int) * n);
+
+    for (unsigned int k = 0; k < n; k++) {
+        const vs_expr_node_t *node = &nodes[ids[k]];
+
+        if ((node->temp != VS_EXPR_NONE) && (node->instr != k) && ((skips[starts[k]] == VS_EXPR_NONE) || (skips[starts[k]] < k))) {
+            skips[starts[k]] = k;
+        }
+    }
+
+    // First occurrences always precede later ones and are never skipped themselves, so every load follows its store.
+    unsigned int w = 0;
+    unsigned int k = 0;
+
+    while (k < n) {
+        if (skips[k] != VS_EXPR_NONE) {
+            vs_instr_t i = { VS_INSTR_LOAD, VS_OP_UNKNOWN, nodes[ids[skips[k]]].temp, NAN };
+
+            instrs[w++] = i;
+            k = skips[k] + 1;
+            continue;
+        }
+
+        const vs_expr_node_t *node = &nodes[ids[k]];
+
+        instrs[w++] = __e->instrs[k];
+
+        if ((node->temp != VS_EXPR_NONE) && (node->instr == k)) {
+            vs_instr_t i = { VS_INSTR_STORE, VS_OP_UNKNOWN, node->temp, NAN };
+
+            instrs[w++] = i;
+        }
+
+        k++;
+    }
+
+    free(nodes);
+    free(ids);
+    free(starts);
+    free(stack);
+    free(__e->instrs);
+
+    __e->instrs = instrs;
+    __e->count = w;
+    __e->capacity = n + ntemps;
+    __e->ntemps = ntemps;
+
+    vs_expr_measure(__e);
+
+    return VS_EXPR_OK;
+}
+
+#pragma mark Batch Evaluation
+
+/**
+ *  Number of samples evaluated per instruction before moving on to the next instruction. A column stack of this many doubles per level
+ *  stays well within L1 for typical expression depths.
+ */
+#define VS_EXPR_BLOCK 256
+
+/**
+ *  Applies the result rules of vs_op_eval() to a column: infinite results become NAN and results smaller than DBL_EPSILON snap to 0.
+ *  NAN operands need no special treatment as IEEE arithmetic already propagates them.
+ *
+ *  @param __o
+ *  @param __n
+ */
+static void vs_expr_snap_v(double *__o, size_t __n) {
+    for (size_t j = 0; j < __n; j++) {
+        double o = __o[j];
+        __o[j] = isinf(o) ? NAN : ((fabs(o) < DBL_EPSILON) ? 0.0 : o);
+    }
+}
+
+/**
+ *  Applies a unary operation to a column in place.
+ *
+ *  @param __op
+ *  @param __a
+ *  @param __m
+ *  @param __x
+ *  @param __n
+ */
+static void vs_expr_unary_v(vs_op_t __op, vs_angle_t __a, int __m, double *__x, size_t __n) {
+    if ((__m & VS_EXPR_MODE_FAST_MATH) && ((__op == VS_OP_SINE) || (__op == VS_OP_COSINE))) {
+        for (size_t j = 0; j < __n; j++) __x[j] = vs_op_torad(__a, __x[j]);
+
+        if (__op == VS_OP_SINE) {
+            fastsin_v(__x, __x, __n);
+            for (size_t j = 0; j < __n; j++) __x[j] = vs_op_snapsin(__a, __x[j]);
+        }
+        else {
+            fastcos_v(__x, __x, __n);
+            for (size_t j = 0; j < __n; j++) __x[j] = vs_op_snapcos(__a, __x[j]);
+        }
+
+        vs_expr_snap_v(__x, __n);
+        return;
+    }
+
+    if ((__m & VS_EXPR_MODE_FAST_MATH) && ((__op == VS_OP_NATURAL_LOGARITHM) || (__op == VS_OP_INVERSE_NATURAL_LOGARITHM))) {
+        if (__op == VS_OP_NATURAL_LOGARITHM) {
+            fastlog_v(__x, __x, __n);
+        }
+        else {
+            fastexp_v(__x, __x, __n);
+        }
+
+        vs_expr_snap_v(__x, __n);
+        return;
+    }
+
+    switch (__op) {
+        case VS_OP_NEGATIVE: for (size_t j = 0; j < __n; j++) __x[j] = __x[j] * -1;     break;
+        case VS_OP_PERCENT:  for (size_t j = 0; j < __n; j++) __x[j] = __x[j] / 100.0;  break;
+        case VS_OP_INVERSE:  for (size_t j = 0; j < __n; j++) __x[j] = 1.0 / __x[j];    break;
+        default: {
+            for (size_t j = 0; j < __n; j++) __x[j] = vs_op_evalm(__op, __a, __m, __x[j], NAN);
+            return;
+        }
+    }
+
+    vs_expr_snap_v(__x, __n);
+}
+
+/**
+ *  Applies a binary operation to two columns, storing the result in the first.
+ *
+ *  @param __op
+ *  @param __a
+ *  @param __m
+ *  @param __x
+ *  @param __y
+ *  @param __n
+ */
+static void vs_expr_binary_v(vs_op_t __op, vs_angle_t __a, int __m, double *restrict __x, const double *restrict __y, size_t __n) {
+    if ((__m & VS_EXPR_MODE_FAST_ARITHMETIC) && vs_op_isarith(__op)) {
+        switch (__op) {
+            case VS_OP_ADD:      for (size_t j = 0; j < __n; j++) __x[j] = decfastadd(__x[j], __y[j]); break;
+            case VS_OP_SUBTRACT: for (size_t j = 0; j < __n; j++) __x[j] = decfastsub(__x[j], __y[j]); break;
+            case VS_OP_MULTIPLY: for (size_t j = 0; j < __n; j++) __x[j] = decfastmul(__x[j], __y[j]); break;
+            default:             for (size_t j = 0; j < __n; j++) __x[j] = decfastdiv(__x[j], __y[j]); break;
+        }
+
+        vs_expr_snap_v(__x, __n);
+        return;
+    }
+
+    switch (__op) {
+        case VS_OP_ADD:      for (size_t j = 0; j < __n; j++) __x[j] = decadd(__x[j], __y[j]); break;
+        case VS_OP_SUBTRACT: for (size_t j = 0; j < __n; j++) __x[j] = decsub(__x[j], __y[j]); break;
+        case VS_OP_MULTIPLY: for (size_t j = 0; j < __n; j++) __x[j] = decmul(__x[j], __y[j]); break;
+        case VS_OP_DIVIDE:   for (size_t j = 0; j < __n; j++) __x[j] = decdiv(__x[j], __y[j]); break;
+        default: {
+            for (size_t j = 0; j < __n; j++) __x[j] = vs_op_evalm(__op, __a, __m, __x[j], __y[j]);
+            return;
+        }
+    }
+
+    vs_expr_snap_v(__x, __n);
+}
+
+int vs_expr_eval_v(const vs_expr_t *__e, vs_angle_t __a, int __m, const double *__xs, double *__ys, size_t __n) {
+    if (!vs_expr_iscomplete(__e)) return VS_EXPR_ESYNTAX;
+
+    for (unsigned int k = 0; k < __e->count; k++) {
+        if ((__e->instrs[k].kind == VS_INSTR_VARIABLE) && (__e->instrs[k].slot > VS_EXPR_SLOT_Y)) return VS_EXPR_EUNBOUND;
+    }
+
+    if (__n == 0) return VS_EXPR_OK;
+
+    // Temporaries are laid out after the stack columns.
+    double *columns = (double *)malloc(sizeof(double) * (__e->maxdepth + __e->ntemps) * VS_EXPR_BLOCK);
+
+    if (columns == NULL) return VS_EXPR_ENOMEM;
+
+    double *temps = columns + (__e->maxdepth * VS_EXPR_BLOCK);
+
+    for (size_t base = 0; base < __n; base += VS_EXPR_BLOCK) {
+        size_t m = ((__n - base) < VS_EXPR_BLOCK) ? (__n - base) : VS_EXPR_BLOCK;
+        unsigned int top = 0;
+
+        for (unsigned int k = 0; k < __e->count; k++) {
+            const vs_instr_t *i = &__e->instrs[k];
+
+            switch (i->kind) {
+                case VS_INSTR_CONSTANT: {
+                    double *o = columns + (top++ * VS_EXPR_BLOCK);
+                    for (size_t j = 0; j < m; j++) o[j] = i->value;
+                    break;
+                }
+
+                case VS_INSTR_VARIABLE: {
+                    double *o = columns + (top++ * VS_EXPR_BLOCK);
+
+                    if ((i->slot == VS_EXPR_SLOT_X) && (__xs != NULL)) {
+                        memcpy(o, __xs + base, sizeof(double) * m);
+                    }
+                    else {
+                        for (size_t j = 0; j < m; j++) o[j] = NAN;
+                    }
+
+                    break;
+                }
+
+                case VS_INSTR_NULLARY: {
+                    double *o = columns + (top++ * VS_EXPR_BLOCK);
+                    for (size_t j = 0; j < m; j++) o[j] = vs_op_evalm(i->op, __a, __m, NAN, NAN);
+                    break;
+                }
+
+                case VS_INSTR_UNARY: {
+                    vs_expr_unary_v(i->op, __a, __m, columns + ((top - 1) * VS_EXPR_BLOCK), m);
+                    break;
+                }
+
+                case VS_INSTR_BINARY: {
+                    top--;
+                    vs_expr_binary_v(i->op, __a, __m, columns + ((top - 1) * VS_EXPR_BLOCK), columns + (top * VS_EXPR_BLOCK), m);
+                    break;
+                }
+
+                case VS_INSTR_POWI: {
+                    double *x = columns + ((top - 1) * VS_EXPR_BLOCK);
+
+                    switch (i->slot) {
+                        case 2:  for (size_t j = 0; j < m; j++) x[j] = x[j] * x[j];                    break;
+                        case 3:  for (size_t j = 0; j < m; j++) x[j] = x[j] * (x[j] * x[j]);           break;
+                        default: for (size_t j = 0; j < m; j++) x[j] = vs_expr_powi(x[j], i->slot);    break;
+                    }
+
+                    vs_expr_snap_v(x, m);
+                    break;
+                }
+
+                case VS_INSTR_SCALE: {
+                    double *x = columns + ((top - 1) * VS_EXPR_BLOCK);
+
+                    for (size_t j = 0; j < m; j++) x[j] = x[j] * i->value;
+
+                    vs_expr_snap_v(x, m);
+                    break;
+                }
+
+                case VS_INSTR_FMA: {
+                    top -= 2;
+
+                    double *p = columns + ((top - 1) * VS_EXPR_BLOCK);
+                    const double *q = p + VS_EXPR_BLOCK;
+                    const double *r = q + VS_EXPR_BLOCK;
+
+                    switch (i->slot) {
+                        case VS_EXPR_FMA_ADD:      for (size_t j = 0; j < m; j++) p[j] = fma(p[j], q[j], r[j]);   break;
+                        case VS_EXPR_FMA_RADD:     for (size_t j = 0; j < m; j++) p[j] = fma(q[j], r[j], p[j]);   break;
+                        case VS_EXPR_FMA_SUBTRACT: for (size_t j = 0; j < m; j++) p[j] = fma(p[j], q[j], -r[j]);  break;
+                        default:                   for (size_t j = 0; j < m; j++) p[j] = fma(-q[j], r[j], p[j]);  break;
+                    }
+
+                    vs_expr_snap_v(p, m);
+                    break;
+                }
+
+                case VS_INSTR_STORE: {
+                    memcpy(temps + (i->slot * VS_EXPR_BLOCK), columns + ((top - 1) * VS_EXPR_BLOCK), sizeof(double) * m);
+                    break;
+                }
+
+                case VS_INSTR_LOAD: {
+                    memcpy(columns + (top++ * VS_EXPR_BLOCK), temps + (i->slot * VS_EXPR_BLOCK), sizeof(double) * m);
+                    break;
+                }
+            }
+        }
+
+        memcpy(__ys + base, columns, sizeof(double) * m);
+    }
+
+    free(columns);
+
+    return VS_EXPR_OK;
+}
+
+#pragma mark Memoized Evaluation
+
+/**
+ *  Dependency bits of memoized evaluation: one per variable slot, slots past the last bit sharing it, one which every instruction
+ *  depends on so that the first evaluation computes everything, and one for random numbers, which change on every evaluation.
+ */
+#define VS_EXPR_DEP_SLOTS    62
+#define VS_EXPR_DEP_INITIAL  (1ULL << 62)
+#define VS_EXPR_DEP_VOLATILE (1ULL << 63)
+#define VS_EXPR_DEP_ALL      (~0ULL)
+
+/**
+ *  Flag of planned instructions whose cached value is pushed instead of being computed.
+ */
+#define VS_EXPR_PLAN_CACHED 0x80000000u
+
+struct vs_expr_memo {
+    const vs_expr_t *expr;
+    uint64_t *deps;
+    unsigned int *parents;
+    unsigned int *plan;
+    unsigned int nplan;
+    uint64_t planned;
+    double *values;
+    double *temps;
+    double *stack;
+    double *vars;
+    unsigned int nvars;
+    unsigned int nbound;
+    int valid;
+    vs_angle_t angle;
+    int mode;
+};
+
+/**
+ *  Gets the dependency bit of a variable slot.
+ *
+ *  @param __slot
+ *
+ *  @return The dependency bit.
+ */
+static inline uint64_t vs_expr_dep(unsigned int __slot) {
+    return 1ULL << ((__slot < VS_EXPR_DEP_SLOTS) ? __slot : (VS_EXPR_DEP_SLOTS - 1));
+}
+
+/**
+ *  Plans the instructions to run when the specified dependencies changed: instructions depending on any of them are computed, and
+ *  the topmost instructions of every subtree depending on none of them push their cached value, skipping the rest of the subtree.
+ *
+ *  @param __c
+ *  @param __changed Changed dependency bits.
+ */
+static void vs_expr_memo_plan(vs_expr_memo_t *__c, uint64_t __changed) {
+    unsigned int n = 0;
+
+    for (unsigned int k = 0; k < __c->expr->count; k++) {
+        unsigned int parent = __c->parents[k];
+
+        if (__c->deps[k] & __changed) {
+            __c->plan[n++] = k;
+        }
+        else if ((parent == VS_EXPR_NONE) || (__c->deps[parent] & __changed)) {
+            __c->plan[n++] = k | VS_EXPR_PLAN_CACHED;
+        }
+    }
+
+    __c->nplan = n;
+    __c->planned = __changed;
+}
+
+vs_expr_memo_t *vs_expr_memo_alloc(const vs_expr_t *__e) {
+    if (!vs_expr_iscomplete(__e) || (__e->count >= VS_EXPR_PLAN_CACHED)) {
+        return NULL;
+    }
+
+    vs_expr_memo_t *c = (vs_expr_memo_t *)calloc(1, sizeof(vs_expr_memo_t));
+
+    if (c == NULL) {
+        return NULL;
+    }
+
+    c->expr = __e;
+    c->nvars = 2;
+
+    for (unsigned int k = 0; k < __e->count; k++) {
+        const vs_instr_t *i = &__e->instrs[k];
+
+        if (i->kind != VS_INSTR_VARIABLE) continue;
+
+        if (i->slot >= c->nvars) c->nvars = i->slot + 1;
+        if ((i->slot > VS_EXPR_SLOT_Y) && (i->slot >= c->nbound)) c->nbound = i->slot + 1;
+    }
+
+    c->deps = (uint64_t *)malloc(sizeof(uint64_t) * (__e->count + __e->ntemps));
+    c->parents = (unsigned int *)malloc(sizeof(unsigned int) * __e->count * 2);
+    c->values = (double *)malloc(sizeof(double) * (__e->count + __e->ntemps + __e->maxdepth + c->nvars));
+
+    if ((c->deps == NULL) || (c->parents == NULL) || (c->values == NULL)) {
+        vs_expr_memo_free(c);
+        return NULL;
+    }
+
+    c->plan = c->parents + __e->count;
+    c->temps = c->values + __e->count;
+    c->stack = c->temps + __e->ntemps;
+    c->vars = c->stack + __e->maxdepth;
+
+    for (unsigned int slot = 0; slot < c->nvars; slot++) {
+        c->vars[slot] = NAN;
+    }
+
+    // Dependencies flow from operands to the instructions consuming them, tracked on a stack of instruction indices which the plan
+    // buffer holds until the first evaluation. Loads depend on whatever their temporary was stored from, tracked past the dependencies
+    // of the instructions.
+    uint64_t *tempdeps = c->deps + __e->count;
+    unsigned int *operands = c->plan;
+    unsigned int top = 0;
+
+    for (unsigned int k = 0; k < __e->count; k++) {
+        const vs_instr_t *i = &__e->instrs[k];
+        uint64_t deps = VS_EXPR_DEP_INITIAL;
+
+        switch (i->kind) {
+            case VS_INSTR_VARIABLE: deps |= vs_expr_dep(i->slot);   break;
+            case VS_INSTR_NULLARY:  deps |= VS_EXPR_DEP_VOLATILE;   break;
+            case VS_INSTR_LOAD:     deps |= tempdeps[i->slot];      break;
+            default:                                                break;
+        }
+
+        for (unsigned int j = vs_expr_arity(i); j > 0; j--) {
+            unsigned int o = operands[--top];
+
+            deps |= c->deps[o];
+            c->parents[o] = k;
+        }
+
+        if (i->kind == VS_INSTR_STORE) {
+            tempdeps[i->slot] = deps;
+        }
+
+        c->deps[k] = deps;
+        c->parents[k] = VS_EXPR_NONE;
+        operands[top++] = k;
+    }
+
+    return c;
+}
+
+void vs_expr_memo_free(vs_expr_memo_t *__c) {
+    if (__c == NULL) {
+        return;
+    }
+
+    free(__c->deps);
+    free(__c->parents);
+    free(__c->values);
+    free(__c);
+}
+
+void vs_expr_memo_reset(vs_expr_memo_t *__c) {
+    if (__c != NULL) __c->valid = 0;
+}
+
+double vs_expr_memo_eval(vs_expr_memo_t *__c, vs_angle_t __a, int __m, const double *__v, size_t __n, int *__s) {
+    if (__c == NULL) {
+        if (__s != NULL) *__s = VS_EXPR_ESYNTAX;
+        return NAN;
+    }
+
+    if (__v == NULL) __n = 0;
+
+    if (__n < __c->nbound) {
+        if (__s != NULL) *__s = VS_EXPR_EUNBOUND;
+        return NAN;
+    }
+
+    uint64_t changed = VS_EXPR_DEP_VOLATILE;
+
+    if (!__c->valid || (__a != __c->angle) || (__m != __c->mode)) {
+        changed = VS_EXPR_DEP_ALL;
+    }
+
+    // Values are compared bitwise so that NAN variables which stay NAN are not considered changed.
+    for (unsigned int slot = 0; slot < __c->nvars; slot++) {
+        double v = (slot < __n) ? __v[slot] : NAN;
+
+        if (memcmp(&v, &__c->vars[slot], sizeof(double)) != 0) {
+            __c->vars[slot] = v;
+            changed |= vs_expr_dep(slot);
+        }
+    }
+
+    if (changed != __c->planned) {
+        vs_expr_memo_plan(__c, changed);
+    }
+
+    const vs_instr_t *instrs = __c->expr->instrs;
+    double *stack = __c->stack;
+    unsigned int top = 0;
+
+    for (unsigned int p = 0; p < __c->nplan; p++) {
+        unsigned int k = __c->plan[p];
+
+        if (k & VS_EXPR_PLAN_CACHED) {
+            stack[top++] = __c->values[k & ~VS_EXPR_PLAN_CACHED];
+            continue;
+        }
+
+        if (instrs[k].kind == VS_INSTR_VARIABLE) {
+            stack[top++] = __c->vars[instrs[k].slot];
+        }
+        else {
+            vs_expr_apply(&instrs[k], __a, __m, stack, &top, __c->temps);
+        }
+
+        __c->values[k] = stack[top-1];
+    }
+
+    __c->valid = 1;
+    __c->angle = __a;
+    __c->mode = __m;
+
+    if (__s != NULL) *__s = VS_EXPR_OK;
+
+    return stack[0];
+}
+
+#pragma mark Tokenization
+
+/**
+ *  Decodes one UTF-8 code point.
+ *
+ *  @param __c
+ *  @param __cp Receives the code point, U+FFFD if the sequence is malformed.
+ *
+ *  @return The number of bytes consumed, at least 1.
+ */
+static size_t vs_expr_utf8(const unsigned char *__c, uint32_t *__cp) {
+    unsigned char b = __c[0];
+
+    if (b < 0x80) {
+        *__cp = b;
+        return 1;
+    }
+    else if (((b & 0xE0) == 0xC0) && ((__c[1] & 0xC0) == 0x80)) {
+        *__cp = ((uint32_t)(b & 0x1F) << 6) | (__c[1] & 0x3F);
+        return 2;
+    }
+    else if (((b & 0xF0) == 0xE0) && ((__c[1] & 0xC0) == 0x80) && ((__c[2] & 0xC0) == 0x80)) {
+        *__cp = ((uint32_t)(b & 0x0F) << 12) | ((uint32_t)(__c[1] & 0x3F) << 6) | (__c[2] & 0x3F);
+        return 3;
+    }
+    else if (((b & 0xF8) == 0xF0) && ((__c[1] & 0xC0) == 0x80) && ((__c[2] & 0xC0) == 0x80) && ((__c[3] & 0xC0) == 0x80)) {
+        *__cp = ((uint32_t)(b & 0x07) << 18) | ((uint32_t)(__c[1] & 0x3F) << 12) | ((uint32_t)(__c[2] & 0x3F) << 6) | (__c[3] & 0x3F);
+        return 4;
+    }
+    else {
+        *__cp = 0xFFFD;
+        return 1;
+    }
+}
+
+/**
+ *  Gets the merge class of a code point.
+ *
+ *  @param __cp
+ *
+ *  @return VS_EXPR_CLASS_NUMERIC, VS_EXPR_CLASS_FUNCTION or VS_EXPR_CLASS_NONE.
+ */
+static int vs_expr_class(uint32_t __cp) {
+    if ((__cp >= '0' && __cp <= '9') || (__cp == '.') || (__cp == ',')) {
+        return VS_EXPR_CLASS_NUMERIC;
+    }
+    else if ((__cp >= 'a' && __cp <= 'z' && __cp != 'e' && __cp != 'x' && __cp != 'y') || (__cp == '_') || (__cp == 0x2081) || (__cp == 0x2082)) {
+        return VS_EXPR_CLASS_FUNCTION;
+    }
+    else {
+        return VS_EXPR_CLASS_NONE;
+    }
+}
+
+/**
+ *  Converts a numeric token the way +[VSNumberUtil numberFromString:] does: grouping separators are dropped and the remainder must
+ *  be digits with at most one decimal separator.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __v Receives the converted value.
+ *
+ *  @return 1 if the token is a valid number, 0 otherwise.
+ */
+static int vs_expr_number(const char *__c, size_t __n, double *__v) {
+    return vs_num_parse(__c, __n, VS_NUM_DECIMAL_SEPARATOR, VS_NUM_GROUPING_SEPARATOR, __v);
+}
+
+/**
+ *  Classifies a token span.
+ *
+ *  @param __c
+ *  @param __n
+ *  @param __class Merge class of the span.
+ *  @param __t     Receives the classified token.
+ *
+ *  @return 1 if the token is recognized, 0 otherwise.
+ */
+static int vs_expr_classify(const char *__c, size_t __n, int __class, vs_expr_token_t *__t) {
+    size_t count = sizeof(vs_expr_symbols) / sizeof(vs_expr_symbols[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        const char *symbol = vs_expr_symbols[i].symbol;
+
+        if ((strlen(symbol) == __n) && (memcmp(symbol, __c, __n) == 0)) {
+            __t->type = vs_expr_symbols[i].type;
+            __t->op = vs_expr_symbols[i].op;
+            __t->slot = vs_expr_symbols[i].slot;
+            __t->value = NAN;
+            return 1;
+        }
+    }
+
+    __t->type = VS_TOKEN_NUMERIC;
+    __t->op = VS_OP_UNKNOWN;
+    __t->slot = 0;
+    __t->value = NAN;
+
+    if ((__n == strlen(VS_M_SYMBOL_NAN)) && (memcmp(__c, VS_M_SYMBOL_NAN, __n) == 0)) {
+        return 1;
+    }
+    else if (__class == VS_EXPR_CLASS_NUMERIC) {
+        return vs_expr_number(__c, __n, &__t->value);
+    }
+    else {
+        return 0;
+    }
+}
+
+/**
+ *  Verifies that a token is product linkable (i.e. 3x = 3*x, meaning that 3 is linkable).
+ *
+ *  @param __t Token, or NULL if there is none.
+ *
+ *  @return 1 if linkable, 0 otherwise.
+ */
+static int vs_expr_islinkable(const vs_expr_token_t *__t) {
+    if (__t == NULL) {
+        return 0;
+    }
+
+    switch (__t->type) {
+        case VS_TOKEN_NUMERIC:
+        case VS_TOKEN_VARIABLE:
+            return 1;
+
+        default:
+            return ((__t->op == VS_OP_RIGHT_PARENTHESIS) || (__t->op == VS_OP_FACTORIAL) || (__t->op == VS_OP_PERCENT) || (__t->op == VS_OP_PI) || (__t->op == VS_OP_EULER));
+    }
+}
+
+#pragma mark Shunting-Yard Algorithm
+
+/**
+ *  Pops the top of the operator stack onto the output.
+ *
+ *  @param __y
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+static int vs_expr_yard_pop(vs_expr_yard_t *__y) {
+    vs_expr_token_t t = __y->stack[--__y->count];
+
+    switch (t.type) {
+        case VS_TOKEN_OPERATOR:      return vs_expr_pushop(__y->output, t.op, 2);
+        case VS_TOKEN_FUNCTION:
+        case VS_TOKEN_UNARY_PREFIX:
+        case VS_TOKEN_UNARY_POSTFIX: return vs_expr_pushop(__y->output, t.op, 1);
+        default:                     return VS_EXPR_OK; // Stray left parenthesis symbols are stripped.
+    }
+}
+
+/**
+ *  Pushes a binary operator onto the operator stack, first popping operators of higher precedence and pending functions.
+ *
+ *  @param __y
+ *  @param __op
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+static int vs_expr_yard_operator(vs_expr_yard_t *__y, vs_op_t __op) {
+    if (__y->count > 0) {
+        vs_token_t top = __y->stack[__y->count-1].type;
+
+        if ((top == VS_TOKEN_OPERATOR) || (top == VS_TOKEN_UNARY_PREFIX) || (top == VS_TOKEN_FUNCTION)) {
+            int prec = vs_op_prec(__op);
+            int rassoc = vs_op_israssoc(__op);
+
+            while (__y->count > 0) {
+                const vs_expr_token_t *t = &__y->stack[__y->count-1];
+                int p = vs_op_prec(t->op);
+
+                if (!(rassoc ? (p > prec) : (p >= prec)) && (t->type != VS_TOKEN_FUNCTION)) {
+                    break;
+                }
+
+                int s = vs_expr_yard_pop(__y);
+
+                if (s != VS_EXPR_OK) {
+                    return s;
+                }
+            }
+        }
+    }
+
+    vs_expr_token_t t = { VS_TOKEN_OPERATOR, __op, 0, NAN };
+    __y->stack[__y->count++] = t;
+
+    return VS_EXPR_OK;
+}
+
+/**
+ *  Inserts an implicit multiplication if the previous token is linkable (i.e. 2sin(90) == 2*sin(90)).
+ *
+ *  @param __y
+ *  @param __prev
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+static int vs_expr_yard_link(vs_expr_yard_t *__y, const vs_expr_token_t *__prev) {
+    if (vs_expr_islinkable(__prev)) {
+        return vs_expr_yard_operator(__y, VS_OP_MULTIPLY);
+    }
+    else {
+        return VS_EXPR_OK;
+    }
+}
+
+/**
+ *  Processes a token according to shunting-yard rules, mirroring +[VSMathUtil _processShuntingYardToken:andPreviousToken:...].
+ *
+ *  @param __y
+ *  @param __t
+ *  @param __prev
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+static int vs_expr_yard_token(vs_expr_yard_t *__y, const vs_expr_token_t *__t, const vs_expr_token_t *__prev) {
+    int s;
+
+    switch (__t->type) {
+        case VS_TOKEN_NUMERIC: {
+            if ((s = vs_expr_yard_link(__y, __prev)) != VS_EXPR_OK) return s;
+            return vs_expr_pushconst(__y->output, __t->value);
+        }
+
+        case VS_TOKEN_VARIABLE: {
+            if ((s = vs_expr_yard_link(__y, __prev)) != VS_EXPR_OK) return s;
+            return vs_expr_pushvar(__y->output, __t->slot);
+        }
+
+        case VS_TOKEN_CONSTANT: {
+            if ((s = vs_expr_yard_link(__y, __prev)) != VS_EXPR_OK) return s;
+            return vs_expr_pushop(__y->output, __t->op, 0);
+        }
+
+        case VS_TOKEN_UNARY_POSTFIX: {
+            return vs_expr_pushop(__y->output, __t->op, 1);
+        }
+
+        case VS_TOKEN_UNARY_PREFIX:
+        case VS_TOKEN_FUNCTION: {
+            // Check if this negative sign should behave like a minus sign.
+            if ((__t->op == VS_OP_NEGATIVE) && vs_expr_islinkable(__prev)) {
+                return vs_expr_yard_operator(__y, VS_OP_SUBTRACT);
+            }
+
+            if ((s = vs_expr_yard_link(__y, __prev)) != VS_EXPR_OK) return s;
+
+            __y->stack[__y->count++] = *__t;
+            return VS_EXPR_OK;
+        }
+
+        case VS_TOKEN_OPERATOR: {
+            // Check if this minus sign should behave like a negative sign.
+            if ((__t->op == VS_OP_SUBTRACT) && !vs_expr_islinkable(__prev)) {
+                vs_expr_token_t t = { VS_TOKEN_UNARY_PREFIX, VS_OP_NEGATIVE, 0, NAN };
+                __y->stack[__y->count++] = t;
+                return VS_EXPR_OK;
+            }
+
+            return vs_expr_yard_operator(__y, __t->op);
+        }
+
+        case VS_TOKEN_PARENTHESIS: {
+            if (__t->op == VS_OP_LEFT_PARENTHESIS) {
+                if ((s = vs_expr_yard_link(__y, __prev)) != VS_EXPR_OK) return s;
+
+                __y->stack[__y->count++] = *__t;
+                return VS_EXPR_OK;
+            }
+
+            // Pop to output until the matching left parenthesis, a mismatch is a syntax error.
+            while ((__y->count > 0) && (__y->stack[__y->count-1].op != VS_OP_LEFT_PARENTHESIS)) {
+                if ((s = vs_expr_yard_pop(__y)) != VS_EXPR_OK) return s;
+            }
+
+            if (__y->count == 0) {
+                return VS_EXPR_ESYNTAX;
+            }
+
+            __y->count--;
+
+            // Evaluate to see if stacktop is now a function and pop to output if it is.
+            if ((__y->count > 0) && (__y->stack[__y->count-1].type == VS_TOKEN_FUNCTION)) {
+                return vs_expr_yard_pop(__y);
+            }
+
+            return VS_EXPR_OK;
+        }
+
+        default: {
+            return VS_EXPR_ESYNTAX;
+        }
+    }
+}
+
+vs_expr_t *vs_expr_parse(const char *__c, int *__s) {
+    int s = VS_EXPR_OK;
+    size_t length = (__c == NULL) ? 0 : strlen(__c);
+
+    if (length == 0) {
+        if (__s != NULL) *__s = VS_EXPR_ESYNTAX;
+        return NULL;
+    }
+
+    vs_expr_yard_t y;
+    y.output = vs_expr_alloc((unsigned int)length);
+    y.stack = (vs_expr_token_t *)malloc(sizeof(vs_expr_token_t) * (length * 2 + 1));
+    y.count = 0;
+
+    if ((y.output == NULL) || (y.stack == NULL)) {
+        vs_expr_free(y.output);
+        free(y.stack);
+        if (__s != NULL) *__s = VS_EXPR_ENOMEM;
+        return NULL;
+    }
+
+    const unsigned char *c = (const unsigned char *)__c;
+    vs_expr_token_t prev;
+    vs_expr_token_t curr;
+    int hasPrev = 0;
+    size_t i = 0;
+
+    // Scan the expression once, recording each token as soon as it ends.
+    while ((i < length) && (s == VS_EXPR_OK)) {
+        uint32_t cp;
+        size_t n = vs_expr_utf8(c + i, &cp);
+
+        // Ignore white space.
+        if (cp == ' ') {
+            i += n;
+            continue;
+        }
+
+        size_t start = i;
+        int cls = vs_expr_class(cp);
+
+        i += n;
+
+        // Merge consecutive numeric or function characters into one token.
+        if (cls != VS_EXPR_CLASS_NONE) {
+            while (i < length) {
+                uint32_t next;
+                size_t m = vs_expr_utf8(c + i, &next);
+
+                if (vs_expr_class(next) != cls) break;
+
+                i += m;
+            }
+        }
+
+        if (!vs_expr_classify(__c + start, i - start, cls, &curr)) {
+            s = VS_EXPR_ESYNTAX;
+            break;
+        }
+
+        s = vs_expr_yard_token(&y, &curr, hasPrev ? &prev : NULL);
+
+        prev = curr;
+        hasPrev = 1;
+    }
+
+    // Pop remaining stack onto output.
+    while ((s == VS_EXPR_OK) && (y.count > 0)) {
+        s = vs_expr_yard_pop(&y);
+    }
+
+    free(y.stack);
+
+    if ((s == VS_EXPR_OK) && !vs_expr_iscomplete(y.output)) {
+        s = VS_EXPR_ESYNTAX;
+    }
+
+    if (s != VS_EXPR_OK) {
+        vs_expr_free(y.output);
+        y.output = NULL;
+    }
+
+    if (__s != NULL) *__s = s;
+
+    return y.output;
+}
+
+double vs_expr_evaluate(const char *__c, vs_angle_t __a, int *__s) {
+    vs_expr_t *e = vs_expr_parse(__c, __s);
+
+    if (e == NULL) {
+        return NAN;
+    }
+
+    double o = vs_expr_eval(e, __a, VS_EXPR_MODE_DEFAULT, NULL, 0, __s);
+
+    vs_expr_free(e);
+
+    return o;
+}
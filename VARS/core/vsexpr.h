@@ -0,0 +1,446 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS expression tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vsexpr_h
+#define vsexpr_h
+
+#include <stddef.h>
+
+#define VS_EXPR_SLOT_X 0
+#define VS_EXPR_SLOT_Y 1
+
+#define VS_EXPR_OK       0
+#define VS_EXPR_ESYNTAX  1
+#define VS_EXPR_EUNBOUND 2
+#define VS_EXPR_ENOMEM   3
+
+/**
+ *  Evaluation mode flags, numerically identical to VSMathEvaluationOptions. VS_EXPR_MODE_FAST_MATH evaluates sine, cosine, the
+ *  hyperbolic functions, natural logarithm, exp and exponentiation with the vsfmath approximations, trading a few ulp of accuracy
+ *  (see vsfmath.h) for throughput. VS_EXPR_MODE_FAST_ARITHMETIC evaluates addition, subtraction, multiplication and division in
+ *  compensated IEEE arithmetic rather than in decimal (see decfastadd()), which is several times faster and yields the same doubles.
+ *  VS_EXPR_MODE_STRENGTH_REDUCTION is not read by evaluation but by compilation, which rewrites costly operations into cheaper IEEE
+ *  ones (see vs_expr_reduce()). All other operations are unaffected.
+ */
+#define VS_EXPR_MODE_DEFAULT            0x0
+#define VS_EXPR_MODE_FAST_MATH          0x1
+#define VS_EXPR_MODE_FAST_ARITHMETIC    0x2
+#define VS_EXPR_MODE_STRENGTH_REDUCTION 0x4
+
+/**
+ *  Highest integer exponent evaluated by repeated multiplication in reduced expressions.
+ */
+#define VS_EXPR_POWI_MAX 16
+
+/**
+ *  Angle modes, numerically identical to VSMathAngleModeType.
+ */
+typedef enum {
+    VS_ANGLE_UNKNOWN = -1,
+    VS_ANGLE_DEGREE,
+    VS_ANGLE_RADIAN,
+    VS_ANGLE_GRADIAN
+} vs_angle_t;
+
+/**
+ *  Token types, numerically identical to VSMathTokenType.
+ */
+typedef enum {
+    VS_TOKEN_UNKNOWN = -1,
+    VS_TOKEN_NUMERIC,
+    VS_TOKEN_FUNCTION,
+    VS_TOKEN_OPERATOR,
+    VS_TOKEN_UNARY_PREFIX,
+    VS_TOKEN_UNARY_POSTFIX,
+    VS_TOKEN_CONSTANT,
+    VS_TOKEN_VARIABLE,
+    VS_TOKEN_PARENTHESIS
+} vs_token_t;
+
+/**
+ *  Operations, numerically identical to VSMathOperationType.
+ */
+typedef enum {
+    VS_OP_UNKNOWN = -1,
+    VS_OP_EXPONENT,
+    VS_OP_ROOT,
+    VS_OP_SCIENTIFIC_NOTATION,
+    VS_OP_CHOOSE,
+    VS_OP_PICK,
+    VS_OP_SQUARE,
+    VS_OP_CUBE,
+    VS_OP_SQUARE_ROOT,
+    VS_OP_CUBE_ROOT,
+    VS_OP_PERCENT,
+    VS_OP_FACTORIAL,
+    VS_OP_SINE,
+    VS_OP_COSINE,
+    VS_OP_TANGENT,
+    VS_OP_INVERSE_SINE,
+    VS_OP_INVERSE_COSINE,
+    VS_OP_INVERSE_TANGENT,
+    VS_OP_HYPERBOLIC_SINE,
+    VS_OP_HYPERBOLIC_COSINE,
+    VS_OP_HYPERBOLIC_TANGENT,
+    VS_OP_INVERSE_HYPERBOLIC_SINE,
+    VS_OP_INVERSE_HYPERBOLIC_COSINE,
+    VS_OP_INVERSE_HYPERBOLIC_TANGENT,
+    VS_OP_NATURAL_LOGARITHM,
+    VS_OP_INVERSE_NATURAL_LOGARITHM,
+    VS_OP_LOGARITHM_10,
+    VS_OP_INVERSE_LOGARITHM_10,
+    VS_OP_LOGARITHM_2,
+    VS_OP_INVERSE_LOGARITHM_2,
+    VS_OP_ABSOLUTE_VALUE,
+    VS_OP_LEFT_PARENTHESIS,
+    VS_OP_RIGHT_PARENTHESIS,
+    VS_OP_PI,
+    VS_OP_EULER,
+    VS_OP_RANDOM_NUMBER,
+    VS_OP_INVERSE,
+    VS_OP_NEGATIVE,
+    VS_OP_MODULO,
+    VS_OP_DIVIDE,
+    VS_OP_MULTIPLY,
+    VS_OP_SUBTRACT,
+    VS_OP_ADD,
+    VS_OP_EQUAL,
+    VS_OP_LEFT_SHIFT,
+    VS_OP_LEFT_SHIFT_BY,
+    VS_OP_RIGHT_SHIFT,
+    VS_OP_RIGHT_SHIFT_BY,
+    VS_OP_ONES_COMPLEMENT,
+    VS_OP_TWOS_COMPLEMENT,
+    VS_OP_FLIP_WORD,
+    VS_OP_FLIP_BYTE,
+    VS_OP_ROR,
+    VS_OP_ROL,
+    VS_OP_AND,
+    VS_OP_NAND,
+    VS_OP_OR,
+    VS_OP_NOR,
+    VS_OP_XOR,
+    VS_OP_XNOR
+} vs_op_t;
+
+/**
+ *  Kinds of compiled expression instructions. VS_INSTR_POWI, VS_INSTR_SCALE and VS_INSTR_FMA are only emitted by vs_expr_reduce():
+ *  VS_INSTR_POWI raises its operand to the integer power held in its slot by repeated multiplication, VS_INSTR_SCALE multiplies its
+ *  operand by its value and VS_INSTR_FMA computes a fused multiply-add of its 3 operands, laid out as described by its slot (see
+ *  VS_EXPR_FMA_*). VS_INSTR_STORE and VS_INSTR_LOAD are only emitted by vs_expr_share(): VS_INSTR_STORE copies the top of the stack
+ *  into the temporary held in its slot without popping it and VS_INSTR_LOAD pushes that temporary.
+ */
+typedef enum {
+    VS_INSTR_CONSTANT,
+    VS_INSTR_VARIABLE,
+    VS_INSTR_NULLARY,
+    VS_INSTR_UNARY,
+    VS_INSTR_BINARY,
+    VS_INSTR_POWI,
+    VS_INSTR_SCALE,
+    VS_INSTR_FMA,
+    VS_INSTR_STORE,
+    VS_INSTR_LOAD
+} vs_instr_kind_t;
+
+/**
+ *  Operand layouts of VS_INSTR_FMA instructions, from the bottommost operand to the topmost one: a b c computing a*b+c or a*b-c, and
+ *  c a b computing c+a*b or c-a*b.
+ */
+#define VS_EXPR_FMA_ADD       0
+#define VS_EXPR_FMA_RADD      1
+#define VS_EXPR_FMA_SUBTRACT  2
+#define VS_EXPR_FMA_RSUBTRACT 3
+
+/**
+ *  A single instruction of a compiled expression. Constants carry their value, variables carry their slot and operations carry their
+ *  operation.
+ */
+typedef struct {
+    vs_instr_kind_t kind;
+    vs_op_t op;
+    unsigned int slot;
+    double value;
+} vs_instr_t;
+
+/**
+ *  A compiled expression: a flat postfix program of instructions. Slot 0 is the x variable and slot 1 is the y variable. Temporaries
+ *  hold the values of subexpressions shared by vs_expr_share().
+ */
+typedef struct {
+    vs_instr_t *instrs;
+    unsigned int count;
+    unsigned int capacity;
+    unsigned int depth;
+    unsigned int maxdepth;
+    unsigned int nslots;
+    unsigned int ntemps;
+} vs_expr_t;
+
+/**
+ *  Memoized evaluation state of a compiled expression, see vs_expr_memo_eval().
+ */
+typedef struct vs_expr_memo vs_expr_memo_t;
+
+#pragma mark Operations
+
+/**
+ *  Evaluates a single operation the same way +[VSMathUtil evaluateOperation:angleMode:operandX:operandY:] does: any NAN operand
+ *  yields NAN, infinite results yield NAN and results smaller than DBL_EPSILON snap to 0. Addition, subtraction, multiplication and
+ *  division are carried out in decimal (see vsdec.h). Unary operations ignore __y, nullary operations ignore both operands.
+ *
+ *  @param __op
+ *  @param __a
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The computed double value.
+ */
+double vs_op_eval(vs_op_t __op, vs_angle_t __a, double __x, double __y);
+
+/**
+ *  Evaluates a single operation like vs_op_eval(), in the specified evaluation mode.
+ *
+ *  @param __op
+ *  @param __a
+ *  @param __m VS_EXPR_MODE_DEFAULT or a combination of VS_EXPR_MODE_* flags.
+ *  @param __x
+ *  @param __y
+ *
+ *  @return The computed double value.
+ */
+double vs_op_evalm(vs_op_t __op, vs_angle_t __a, int __m, double __x, double __y);
+
+/**
+ *  Verifies whether an operation has a fast approximation used by VS_EXPR_MODE_FAST_MATH.
+ *
+ *  @param __op
+ *
+ *  @return 1 if approximated in fast math mode, 0 otherwise.
+ */
+int vs_op_isapprox(vs_op_t __op);
+
+/**
+ *  Verifies whether an operation is one of the basic arithmetic operations affected by VS_EXPR_MODE_FAST_ARITHMETIC.
+ *
+ *  @param __op
+ *
+ *  @return 1 if addition, subtraction, multiplication or division, 0 otherwise.
+ */
+int vs_op_isarith(vs_op_t __op);
+
+/**
+ *  Gets the shunting-yard precedence of an operation.
+ *
+ *  @param __op
+ *
+ *  @return The precedence, -1 if the operation has none.
+ */
+int vs_op_prec(vs_op_t __op);
+
+/**
+ *  Verifies whether an operation is right-associative.
+ *
+ *  @param __op
+ *
+ *  @return 1 if right-associative, 0 otherwise.
+ */
+int vs_op_israssoc(vs_op_t __op);
+
+#pragma mark Compiled Expressions
+
+/**
+ *  Allocates an empty compiled expression.
+ *
+ *  @param __n Initial instruction capacity.
+ *
+ *  @return The allocated expression, NULL if out of memory. Release with vs_expr_free().
+ */
+vs_expr_t *vs_expr_alloc(unsigned int __n);
+
+/**
+ *  Releases a compiled expression.
+ *
+ *  @param __e
+ */
+void vs_expr_free(vs_expr_t *__e);
+
+/**
+ *  Appends a constant to a compiled expression.
+ *
+ *  @param __e
+ *  @param __v
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+int vs_expr_pushconst(vs_expr_t *__e, double __v);
+
+/**
+ *  Appends a variable slot to a compiled expression.
+ *
+ *  @param __e
+ *  @param __slot
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+int vs_expr_pushvar(vs_expr_t *__e, unsigned int __slot);
+
+/**
+ *  Appends an operation to a compiled expression. Pi and Euler are appended as constants, the random number as a nullary
+ *  instruction drawn on every evaluation.
+ *
+ *  @param __e
+ *  @param __op
+ *  @param __arity 0, 1 or 2.
+ *
+ *  @return VS_EXPR_OK on success, VS_EXPR_ESYNTAX if there are not enough operands.
+ */
+int vs_expr_pushop(vs_expr_t *__e, vs_op_t __op, int __arity);
+
+/**
+ *  Rewrites costly operations of a compiled expression into cheaper ones evaluated in IEEE double arithmetic:
+ *      1. Squares, cubes and powers of integer constants from 2 to VS_EXPR_POWI_MAX become repeated multiplications.
+ *      2. Division by a constant whose reciprocal is a normal double becomes multiplication by that reciprocal, which is exact for
+ *         powers of 2 and within 1.5 ulp of the division otherwise.
+ *      3. Additions and subtractions of a product become fused multiply-adds.
+ *      4. Multiplication and division by 1, addition and subtraction of 0 and double negation of an operation result are removed.
+ *  Results of rewritten operations still follow the rules of vs_op_eval() but may differ from the decimal or compensated ones by a few
+ *  ulp, so this is meant for expressions which are sampled rather than displayed. Identities are only removed where operands are
+ *  operation results, which are already moderated, and identities which do not hold in IEEE arithmetic (i.e. √(x²) = |x|, which
+ *  does not hold once x² overflows) are kept.
+ *
+ *  @param __e
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+int vs_expr_reduce(vs_expr_t *__e);
+
+/**
+ *  Eliminates common subexpressions of a compiled expression: identical subtrees are hash-consed into a directed acyclic graph, and
+ *  every operation result referenced more than once (i.e. sin(x) in sin(x)² + 2sin(x) + 1) is computed once per evaluation, stored
+ *  in a temporary and loaded wherever it repeats. Shared results are computed by the same instructions in the same order, so results
+ *  are identical to those of the unshared expression. Random numbers are never shared, and neither are constants and variables, which
+ *  cost as much to push as to load. Meant to run last, after vs_expr_reduce(). The expression is left unchanged on failure.
+ *
+ *  @param __e
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise.
+ */
+int vs_expr_share(vs_expr_t *__e);
+
+/**
+ *  Verifies that a compiled expression reduces to exactly one value.
+ *
+ *  @param __e
+ *
+ *  @return 1 if complete, 0 otherwise.
+ */
+int vs_expr_iscomplete(const vs_expr_t *__e);
+
+/**
+ *  Parses an UTF-8 infix expression into a compiled expression. Tokenization, implicit multiplication, negative/subtract
+ *  disambiguation and operator precedence follow +[VSMathUtil postfixStackFromInfixExpression:].
+ *
+ *  @param __c
+ *  @param __s Optional pointer to receive VS_EXPR_OK or an error code.
+ *
+ *  @return The compiled expression, NULL on failure. Release with vs_expr_free().
+ */
+vs_expr_t *vs_expr_parse(const char *__c, int *__s);
+
+/**
+ *  Evaluates a compiled expression. The x and y variables evaluate to NAN when their slots are not provided, other variables fail
+ *  with VS_EXPR_EUNBOUND. This function does not allocate memory unless the expression needs more than 128 stack values and
+ *  temporaries, in which case it fails with VS_EXPR_ENOMEM if they cannot be allocated.
+ *
+ *  @param __e
+ *  @param __a
+ *  @param __m VS_EXPR_MODE_DEFAULT or a combination of VS_EXPR_MODE_* flags.
+ *  @param __v Variable values indexed by slot, may be NULL if __n is 0.
+ *  @param __n
+ *  @param __s Optional pointer to receive VS_EXPR_OK or an error code.
+ *
+ *  @return The computed double value, NAN on failure.
+ */
+double vs_expr_eval(const vs_expr_t *__e, vs_angle_t __a, int __m, const double *__v, size_t __n, int *__s);
+
+/**
+ *  Evaluates a compiled expression over a column of x values. Each instruction is applied to a whole block of samples before the next
+ *  instruction runs, so operations are dispatched once per block rather than once per sample. Results match vs_expr_eval() called once
+ *  per x value with the y variable unset. Allocates a single scratch buffer per call.
+ *
+ *  @param __e
+ *  @param __a
+ *  @param __m VS_EXPR_MODE_DEFAULT or a combination of VS_EXPR_MODE_* flags.
+ *  @param __xs Values of the x variable, may be NULL to leave x unset.
+ *  @param __ys Array of at least __n doubles to receive the results.
+ *  @param __n
+ *
+ *  @return VS_EXPR_OK on success, an error code otherwise (i.e. VS_EXPR_EUNBOUND if the expression uses custom variables).
+ */
+int vs_expr_eval_v(const vs_expr_t *__e, vs_angle_t __a, int __m, const double *__xs, double *__ys, size_t __n);
+
+/**
+ *  Parses and evaluates an UTF-8 infix expression, equivalent to +[VSMathUtil evaluateInfixExpression:angleMode:].
+ *
+ *  @param __c
+ *  @param __a
+ *  @param __s Optional pointer to receive VS_EXPR_OK or an error code.
+ *
+ *  @return The computed double value, NAN on failure.
+ */
+double vs_expr_evaluate(const char *__c, vs_angle_t __a, int *__s);
+
+#pragma mark Memoized Evaluation
+
+/**
+ *  Allocates the memoized evaluation state of a compiled expression, recording which variable slots every instruction depends on.
+ *  The expression must outlive the state and must not be modified while it is in use.
+ *
+ *  @param __e
+ *
+ *  @return The allocated state, NULL if the expression is incomplete or out of memory. Release with vs_expr_memo_free().
+ */
+vs_expr_memo_t *vs_expr_memo_alloc(const vs_expr_t *__e);
+
+/**
+ *  Releases a memoized evaluation state.
+ *
+ *  @param __c
+ */
+void vs_expr_memo_free(vs_expr_memo_t *__c);
+
+/**
+ *  Discards the cached values of a memoized evaluation state, so that its next evaluation computes every instruction.
+ *
+ *  @param __c
+ */
+void vs_expr_memo_reset(vs_expr_memo_t *__c);
+
+/**
+ *  Evaluates a compiled expression like vs_expr_eval(), caching the value of every instruction. Only instructions depending on a
+ *  variable whose value changed since the previous evaluation (or on a random number) are computed again, while subtrees depending
+ *  on none of them push their cached value and are skipped as a whole. Evaluating f(x, y) with x fixed while y changes therefore only
+ *  costs the y-dependent part of the expression. Changing the angle mode or the evaluation mode recomputes everything. Results are
+ *  identical to those of vs_expr_eval(). This function does not allocate memory, and a state must not be used by multiple threads at
+ *  once.
+ *
+ *  @param __c
+ *  @param __a
+ *  @param __m VS_EXPR_MODE_DEFAULT or a combination of VS_EXPR_MODE_* flags.
+ *  @param __v Variable values indexed by slot, may be NULL if __n is 0.
+ *  @param __n
+ *  @param __s Optional pointer to receive VS_EXPR_OK or an error code.
+ *
+ *  @return The computed double value, NAN on failure.
+ */
+double vs_expr_memo_eval(vs_expr_memo_t *__c, vs_angle_t __a, int __m, const double *__v, size_t __n, int *__s);
+
+#endif
@@ -0,0 +1,556 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <math.h>
+#import <stdint.h>
+#import <string.h>
+
+#import "vsfmath.h"
+#import "vsmath.h"
+
+/**
+ *  Range reduction constants. The high parts have their low bits cleared so that multiplying them by the quadrant (or power of 2)
+ *  index is exact within the supported range.
+ */
+#define VS_FM_2_PI       0.6366197723675814
+#define VS_FM_PIO2_1     1.5707963267341256
+#define VS_FM_PIO2_2     6.077100506303966e-11
+#define VS_FM_PIO2_3     2.0222662487959506e-21
+#define VS_FM_1_LN2      1.4426950408889634
+#define VS_FM_LN2_HI     0.6931471804855391
+#define VS_FM_LN2_LO     7.440617110012397e-11
+#define VS_FM_LN2_HI_F   0.693145751953125f
+#define VS_FM_LN2_LO_F   1.4286068203094172e-06f
+
+/**
+ *  Beyond this magnitude the two-part reduction of sin/cos loses accuracy, so libm is used instead.
+ */
+#define VS_FM_TRIG_MAX   1.0e5
+
+/**
+ *  Adding and subtracting 1.5 * 2^52 (2^23 for floats) rounds to the nearest integer without a libm call, and leaves that integer in
+ *  the low bits of the intermediate sum.
+ */
+#define VS_FM_SHIFTER    0x1.8p52
+#define VS_FM_SHIFTER_F  0x1.8p23f
+
+#define VS_FM_EXP_MAX    709.782712893384
+#define VS_FM_EXP_MIN    -708.3964185322641
+#define VS_FM_EXP_MAX_F  88.72283935546875f
+#define VS_FM_EXP_MIN_F  -87.33654022216797f
+
+#pragma mark Kernels
+
+/**
+ *  Builds 2^__k by assembling its exponent bits.
+ *
+ *  @param __k An exponent in [-1022, 1023].
+ *
+ *  @return The computed double value.
+ */
+static inline double vs_fm_pow2(int64_t __k) {
+    uint64_t b = (uint64_t)(__k + 1023) << 52;
+    double o;
+
+    memcpy(&o, &b, sizeof(o));
+
+    return o;
+}
+
+/**
+ *  Builds 2^__k by assembling its exponent bits.
+ *
+ *  @param __k An exponent in [-126, 127].
+ *
+ *  @return The computed float value.
+ */
+static inline float vs_fm_pow2f(int32_t __k) {
+    uint32_t b = (uint32_t)(__k + 127) << 23;
+    float o;
+
+    memcpy(&o, &b, sizeof(o));
+
+    return o;
+}
+
+/**
+ *  Rounds to the nearest integer, for magnitudes below 2^51.
+ *
+ *  @param __n
+ *  @param __k Receives the integer.
+ *
+ *  @return The rounded double value.
+ */
+static inline double vs_fm_round(double __n, int64_t *__k) {
+    double t = __n + VS_FM_SHIFTER;
+    uint64_t b;
+
+    memcpy(&b, &t, sizeof(b));
+    *__k = (int64_t)(int32_t)(uint32_t)b;
+
+    return (t - VS_FM_SHIFTER);
+}
+
+/**
+ *  Rounds to the nearest integer, for magnitudes below 2^22.
+ *
+ *  @param __n
+ *  @param __k Receives the integer.
+ *
+ *  @return The rounded float value.
+ */
+static inline float vs_fm_roundf(float __n, int32_t *__k) {
+    float t = __n + VS_FM_SHIFTER_F;
+    uint32_t b;
+
+    memcpy(&b, &t, sizeof(b));
+    *__k = ((int32_t)(b & 0x7fffff)) - 0x400000;
+
+    return (t - VS_FM_SHIFTER_F);
+}
+
+/**
+ *  Polynomial kernels of sin and cos over [-π/4, π/4], exp(r) - 1 over [-ln(2)/2, ln(2)/2] and log(1 + f) over [√2/2 - 1, √2 - 1].
+ *  Coefficients are Chebyshev fits of the respective odd/even remainders, which are within a few percent of minimax.
+ */
+static inline double vs_fm_sinpoly(double __r) {
+    double z = __r * __r;
+    double p = -0.16666666666666666 + z * (0.008333333333330948 + z * (-0.00019841269836758574 + z * (2.755731610255244e-06 + z * (-2.5051131845003624e-08 + z * 1.5918129294866608e-10))));
+
+    return __r + (__r * z * p);
+}
+
+static inline double vs_fm_cospoly(double __r) {
+    double z = __r * __r;
+    double p = 0.041666666666666664 + z * (-0.0013888888888887398 + z * (2.480158729876569e-05 + z * (-2.7557317271729793e-07 + z * (2.08761462684032e-09 + z * -1.1382632425521717e-11))));
+
+    return 1.0 - ((0.5 * z) - (z * z * p));
+}
+
+static inline float vs_fm_sinpolyf(float __r) {
+    float z = __r * __r;
+    float p = -0.1666666666385529f + z * (0.008333331874710208f + z * (-0.00019840086735384846f + z * 2.724992580305979e-06f));
+
+    return __r + (__r * z * p);
+}
+
+static inline float vs_fm_cospolyf(float __r) {
+    float z = __r * __r;
+    float p = 0.0416666666643212f + z * (-0.001388888767201679f + z * (2.480060037715673e-05f + z * -2.730095920390147e-07f));
+
+    return 1.0f - ((0.5f * z) - (z * z * p));
+}
+
+static inline double vs_fm_expm1poly(double __r) {
+    double p = 0.5 + __r * (0.1666666666666667 + __r * (0.04166666666666667 + __r * (0.008333333333326141 + __r * (0.0013888888888883752 + __r * (0.00019841269874800493 + __r * (2.4801587325533363e-05 + __r * (2.7557255425746435e-06 + __r * (2.7557273661348616e-07 + __r * (2.510520637395701e-08 + __r * 2.0914679376589667e-09)))))))));
+
+    return __r + (__r * __r * p);
+}
+
+static inline float vs_fm_expm1polyf(float __r) {
+    float p = 0.5000000013457727f + __r * (0.16666666681614256f + __r * (0.04166646500604005f + __r * (0.008333310934448869f + __r * (0.0013933641031986701f + __r * 0.00019890980869750327f))));
+
+    return __r + (__r * __r * p);
+}
+
+static inline double vs_fm_logpoly(double __f) {
+    double s = __f / (2.0 + __f);
+    double w = s * s;
+    double p = 0.666666666666667 + w * (0.39999999999899505 + w * (0.28571428625975487 + w * (0.2222221113479508 + w * (0.18182889125261723 + w * (0.15331721600556042 + w * 0.14616449685043406)))));
+
+    return (2.0 * s) + (s * w * p);
+}
+
+static inline float vs_fm_logpolyf(float __f) {
+    float s = __f / (2.0f + __f);
+    float w = s * s;
+    float p = 0.6666666655449709f + w * (0.40000121839806124f + w * (0.28550820815960665f + w * 0.23330467216303835f));
+
+    return (2.0f * s) + (s * w * p);
+}
+
+static inline double vs_fm_sin(double __n) {
+    int64_t q;
+    double k = vs_fm_round(__n * VS_FM_2_PI, &q);
+    double r = ((__n - (k * VS_FM_PIO2_1)) - (k * VS_FM_PIO2_2)) - (k * VS_FM_PIO2_3);
+    double s = vs_fm_sinpoly(r);
+    double c = vs_fm_cospoly(r);
+    double o = (q & 1) ? c : s;
+
+    // The reduction turns -0 into +0.
+    o = (q & 2) ? -o : o;
+
+    return (__n == 0.0) ? __n : o;
+}
+
+static inline double vs_fm_cos(double __n) {
+    int64_t q;
+    double k = vs_fm_round(__n * VS_FM_2_PI, &q);
+    double r = ((__n - (k * VS_FM_PIO2_1)) - (k * VS_FM_PIO2_2)) - (k * VS_FM_PIO2_3);
+    double s = vs_fm_sinpoly(r);
+    double c = vs_fm_cospoly(r);
+    double o = (q & 1) ? s : c;
+
+    return ((q + 1) & 2) ? -o : o;
+}
+
+static inline double vs_fm_exp(double __n) {
+    double x = (__n > VS_FM_EXP_MAX) ? VS_FM_EXP_MAX : ((__n < VS_FM_EXP_MIN) ? VS_FM_EXP_MIN : __n);
+    int64_t i;
+    double k = vs_fm_round(x * VS_FM_1_LN2, &i);
+    double r = (x - (k * VS_FM_LN2_HI)) - (k * VS_FM_LN2_LO);
+    double o = (1.0 + vs_fm_expm1poly(r)) * vs_fm_pow2(i >> 1) * vs_fm_pow2(i - (i >> 1));
+
+    // Out of range and NAN inputs are patched after the fact to keep the computation branch-free.
+    o = (__n > VS_FM_EXP_MAX) ? INFINITY : o;
+    o = (__n < VS_FM_EXP_MIN) ? 0.0 : o;
+
+    return (__n != __n) ? __n : o;
+}
+
+static inline double vs_fm_log(double __n) {
+    double x = (__n < 0x1p-1022) ? (__n * 0x1p54) : __n;
+    uint64_t b;
+
+    memcpy(&b, &x, sizeof(b));
+
+    // Split into 2^e * m with m in [√2/2, √2). The exponent is converted to double through the shifter, avoiding a 64-bit integer
+    // conversion which SSE2 and NEON cannot vectorize.
+    uint64_t eb = ((b >> 52) & 0x7ff) | 0x4338000000000000ULL;
+    uint64_t mb = (b & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double e;
+    double m;
+
+    memcpy(&e, &eb, sizeof(e));
+    memcpy(&m, &mb, sizeof(m));
+
+    e = (e - VS_FM_SHIFTER) - ((__n < 0x1p-1022) ? (1023.0 + 54.0) : 1023.0);
+
+    e = (m > M_SQRT2) ? (e + 1.0) : e;
+    m = (m > M_SQRT2) ? (m * 0.5) : m;
+
+    double o = (e * VS_FM_LN2_HI) + (vs_fm_logpoly(m - 1.0) + (e * VS_FM_LN2_LO));
+
+    o = (__n == 0.0) ? -INFINITY : o;
+    o = (__n < 0.0) ? NAN : o;
+
+    return (__n < INFINITY) ? o : (__n + __n);
+}
+
+static inline double vs_fm_expm1(double __n) {
+    int64_t i;
+    double k = vs_fm_round(__n * VS_FM_1_LN2, &i);
+    double r = (__n - (k * VS_FM_LN2_HI)) - (k * VS_FM_LN2_LO);
+    double p = vs_fm_expm1poly(r);
+
+    if (i == 0) return p;
+
+    double t = vs_fm_pow2(i);
+
+    return ((t - 1.0) + (t * p));
+}
+
+static inline float vs_fm_sinf(float __n) {
+    int64_t q;
+    double k = vs_fm_round((double)__n * VS_FM_2_PI, &q);
+    float r = (float)(((double)__n - (k * VS_FM_PIO2_1)) - (k * VS_FM_PIO2_2));
+    float s = vs_fm_sinpolyf(r);
+    float c = vs_fm_cospolyf(r);
+    float o = (q & 1) ? c : s;
+
+    o = (q & 2) ? -o : o;
+
+    return (__n == 0.0f) ? __n : o;
+}
+
+static inline float vs_fm_cosf(float __n) {
+    int64_t q;
+    double k = vs_fm_round((double)__n * VS_FM_2_PI, &q);
+    float r = (float)(((double)__n - (k * VS_FM_PIO2_1)) - (k * VS_FM_PIO2_2));
+    float s = vs_fm_sinpolyf(r);
+    float c = vs_fm_cospolyf(r);
+    float o = (q & 1) ? s : c;
+
+    return ((q + 1) & 2) ? -o : o;
+}
+
+static inline float vs_fm_expf(float __n) {
+    float x = (__n > VS_FM_EXP_MAX_F) ? VS_FM_EXP_MAX_F : ((__n < VS_FM_EXP_MIN_F) ? VS_FM_EXP_MIN_F : __n);
+    int32_t i;
+    float k = vs_fm_roundf(x * (float)VS_FM_1_LN2, &i);
+    float r = (x - (k * VS_FM_LN2_HI_F)) - (k * VS_FM_LN2_LO_F);
+    float o = (1.0f + vs_fm_expm1polyf(r)) * vs_fm_pow2f(i >> 1) * vs_fm_pow2f(i - (i >> 1));
+
+    o = (__n > VS_FM_EXP_MAX_F) ? INFINITY : o;
+    o = (__n < VS_FM_EXP_MIN_F) ? 0.0f : o;
+
+    return (__n != __n) ? __n : o;
+}
+
+static inline float vs_fm_logf(float __n) {
+    float x = (__n < 0x1p-126f) ? (__n * 0x1p25f) : __n;
+    uint32_t b;
+
+    memcpy(&b, &x, sizeof(b));
+
+    int32_t e = (int32_t)((b >> 23) & 0xff) - 127 - ((__n < 0x1p-126f) ? 25 : 0);
+    uint32_t mb = (b & 0x007fffffU) | 0x3f800000U;
+    float m;
+
+    memcpy(&m, &mb, sizeof(m));
+
+    e = (m > (float)M_SQRT2) ? (e + 1) : e;
+    m = (m > (float)M_SQRT2) ? (m * 0.5f) : m;
+
+    float o = ((float)e * VS_FM_LN2_HI_F) + (vs_fm_logpolyf(m - 1.0f) + ((float)e * VS_FM_LN2_LO_F));
+
+    o = (__n == 0.0f) ? -INFINITY : o;
+    o = (__n < 0.0f) ? NAN : o;
+
+    return (__n < INFINITY) ? o : (__n + __n);
+}
+
+static inline float vs_fm_expm1f(float __n) {
+    int32_t i;
+    float k = vs_fm_roundf(__n * (float)VS_FM_1_LN2, &i);
+    float r = (__n - (k * VS_FM_LN2_HI_F)) - (k * VS_FM_LN2_LO_F);
+    float p = vs_fm_expm1polyf(r);
+
+    if (i == 0) return p;
+
+    float t = vs_fm_pow2f(i);
+
+    return ((t - 1.0f) + (t * p));
+}
+
+#pragma mark Trigonometric Functions
+
+float fastsinf(float __n) {
+    if (!(fabsf(__n) <= VS_FM_TRIG_MAX)) return sinf(__n);
+
+    return vs_fm_sinf(__n);
+}
+
+double fastsin(double __n) {
+    if (!(fabs(__n) <= VS_FM_TRIG_MAX)) return sin(__n);
+
+    return vs_fm_sin(__n);
+}
+
+float fastcosf(float __n) {
+    if (!(fabsf(__n) <= VS_FM_TRIG_MAX)) return cosf(__n);
+
+    return vs_fm_cosf(__n);
+}
+
+double fastcos(double __n) {
+    if (!(fabs(__n) <= VS_FM_TRIG_MAX)) return cos(__n);
+
+    return vs_fm_cos(__n);
+}
+
+#pragma mark Exponentials and Logarithms
+
+float fastexpf(float __n) {
+    return vs_fm_expf(__n);
+}
+
+double fastexp(double __n) {
+    return vs_fm_exp(__n);
+}
+
+float fastlogf(float __n) {
+    return vs_fm_logf(__n);
+}
+
+double fastlog(double __n) {
+    return vs_fm_log(__n);
+}
+
+float fastpowf(float __x, float __n) {
+    if ((__x > 0.0f) && (__x < INFINITY) && isfinite(__n)) {
+        return vs_fm_expf(__n * vs_fm_logf(__x));
+    }
+
+    return (float)fpow(__x, __n);
+}
+
+double fastpow(double __x, double __n) {
+    if ((__x > 0.0) && (__x < INFINITY) && isfinite(__n)) {
+        return vs_fm_exp(__n * vs_fm_log(__x));
+    }
+
+    return fpow(__x, __n);
+}
+
+#pragma mark Hyperbolic Functions
+
+float fastsinhf(float __n) {
+    float a = fabsf(__n);
+    float o;
+
+    if (a < 22.0f) {
+        float em = vs_fm_expm1f(a);
+        o = 0.5f * (em + (em / (em + 1.0f)));
+    }
+    else {
+        // Halving is exact, unlike subtracting ln 2, whose rounding error the exponential would amplify.
+        float e = vs_fm_expf(0.5f * a);
+        o = (0.5f * e) * e;
+    }
+
+    return copysignf(o, __n);
+}
+
+double fastsinh(double __n) {
+    double a = fabs(__n);
+    double o;
+
+    if (a < 22.0) {
+        double em = vs_fm_expm1(a);
+        o = 0.5 * (em + (em / (em + 1.0)));
+    }
+    else {
+        double e = vs_fm_exp(0.5 * a);
+        o = (0.5 * e) * e;
+    }
+
+    return copysign(o, __n);
+}
+
+float fastcoshf(float __n) {
+    float a = fabsf(__n);
+
+    if (a < 22.0f) {
+        float e = vs_fm_expf(a);
+        return 0.5f * (e + (1.0f / e));
+    }
+    else {
+        float e = vs_fm_expf(0.5f * a);
+        return (0.5f * e) * e;
+    }
+}
+
+double fastcosh(double __n) {
+    double a = fabs(__n);
+
+    if (a < 22.0) {
+        double e = vs_fm_exp(a);
+        return 0.5 * (e + (1.0 / e));
+    }
+    else {
+        double e = vs_fm_exp(0.5 * a);
+        return (0.5 * e) * e;
+    }
+}
+
+float fasttanhf(float __n) {
+    float a = fabsf(__n);
+
+    if (a > 9.0f) return copysignf(1.0f, __n);
+
+    float em = vs_fm_expm1f(2.0f * a);
+
+    return copysignf(em / (em + 2.0f), __n);
+}
+
+double fasttanh(double __n) {
+    double a = fabs(__n);
+
+    if (a > 22.0) return copysign(1.0, __n);
+
+    double em = vs_fm_expm1(2.0 * a);
+
+    return copysign(em / (em + 2.0), __n);
+}
+
+#pragma mark Array Operations
+
+/**
+ *  Verifies that an array is entirely within the range of the fast sin/cos reduction.
+ *
+ *  @param __in
+ *  @param __n
+ *
+ *  @return 1 if all values are in range, 0 otherwise.
+ */
+static int vs_fm_istrigsafe(const double *__in, size_t __n) {
+    int o = 1;
+
+    for (size_t j = 0; j < __n; j++) o &= (fabs(__in[j]) <= VS_FM_TRIG_MAX);
+
+    return o;
+}
+
+/**
+ *  Verifies that an array is entirely within the range of the fast sinf/cosf reduction.
+ *
+ *  @param __in
+ *  @param __n
+ *
+ *  @return 1 if all values are in range, 0 otherwise.
+ */
+static int vs_fm_istrigsafef(const float *__in, size_t __n) {
+    int o = 1;
+
+    for (size_t j = 0; j < __n; j++) o &= (fabsf(__in[j]) <= VS_FM_TRIG_MAX);
+
+    return o;
+}
+
+void fastsinf_v(const float *__in, float *__out, size_t __n) {
+    if (vs_fm_istrigsafef(__in, __n)) {
+        for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_sinf(__in[j]);
+    }
+    else {
+        for (size_t j = 0; j < __n; j++) __out[j] = fastsinf(__in[j]);
+    }
+}
+
+void fastsin_v(const double *__in, double *__out, size_t __n) {
+    if (vs_fm_istrigsafe(__in, __n)) {
+        for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_sin(__in[j]);
+    }
+    else {
+        for (size_t j = 0; j < __n; j++) __out[j] = fastsin(__in[j]);
+    }
+}
+
+void fastcosf_v(const float *__in, float *__out, size_t __n) {
+    if (vs_fm_istrigsafef(__in, __n)) {
+        for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_cosf(__in[j]);
+    }
+    else {
+        for (size_t j = 0; j < __n; j++) __out[j] = fastcosf(__in[j]);
+    }
+}
+
+void fastcos_v(const double *__in, double *__out, size_t __n) {
+    if (vs_fm_istrigsafe(__in, __n)) {
+        for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_cos(__in[j]);
+    }
+    else {
+        for (size_t j = 0; j < __n; j++) __out[j] = fastcos(__in[j]);
+    }
+}
+
+void fastexpf_v(const float *__in, float *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_expf(__in[j]);
+}
+
+void fastexp_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_exp(__in[j]);
+}
+
+void fastlogf_v(const float *__in, float *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_logf(__in[j]);
+}
+
+void fastlog_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = vs_fm_log(__in[j]);
+}
@@ -0,0 +1,484 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <math.h>
+#import <stdlib.h>
+#import <string.h>
+
+#import "vslex.h"
+#import "vsnum.h"
+
+/**
+ *  Character classes of Latin-1 characters, which covers every math symbol character but a handful of operators.
+ */
+static const unsigned char VS_LEX_CLASSES[256] = {
+    ['!']   = VS_LEX_UNARY_POSTFIX_OPERATOR,
+    ['(']   = VS_LEX_PARENTHESIS,
+    [')']   = VS_LEX_PARENTHESIS,
+    ['*']   = VS_LEX_OPERATOR,
+    ['+']   = VS_LEX_OPERATOR,
+    [',']   = VS_LEX_NUMERIC,
+    ['-']   = VS_LEX_UNARY_PREFIX_OPERATOR,
+    ['.']   = VS_LEX_NUMERIC,
+    ['/']   = VS_LEX_OPERATOR,
+    ['0']   = VS_LEX_NUMERIC,
+    ['1']   = VS_LEX_NUMERIC,
+    ['2']   = VS_LEX_NUMERIC,
+    ['3']   = VS_LEX_NUMERIC,
+    ['4']   = VS_LEX_NUMERIC,
+    ['5']   = VS_LEX_NUMERIC,
+    ['6']   = VS_LEX_NUMERIC,
+    ['7']   = VS_LEX_NUMERIC,
+    ['8']   = VS_LEX_NUMERIC,
+    ['9']   = VS_LEX_NUMERIC,
+    ['?']   = VS_LEX_CONSTANT,
+    ['C']   = VS_LEX_OPERATOR,
+    ['E']   = VS_LEX_OPERATOR,
+    ['P']   = VS_LEX_OPERATOR,
+    ['^']   = VS_LEX_OPERATOR,
+    ['_']   = VS_LEX_FUNCTION,
+    ['a']   = VS_LEX_FUNCTION,
+    ['b']   = VS_LEX_FUNCTION,
+    ['c']   = VS_LEX_FUNCTION | VS_LEX_UNARY_POSTFIX_OPERATOR,
+    ['d']   = VS_LEX_FUNCTION,
+    ['e']   = VS_LEX_CONSTANT,
+    ['f']   = VS_LEX_FUNCTION,
+    ['g']   = VS_LEX_FUNCTION,
+    ['h']   = VS_LEX_FUNCTION,
+    ['i']   = VS_LEX_FUNCTION,
+    ['j']   = VS_LEX_FUNCTION,
+    ['k']   = VS_LEX_FUNCTION,
+    ['l']   = VS_LEX_FUNCTION,
+    ['m']   = VS_LEX_FUNCTION,
+    ['n']   = VS_LEX_FUNCTION,
+    ['o']   = VS_LEX_FUNCTION,
+    ['p']   = VS_LEX_FUNCTION | VS_LEX_UNARY_POSTFIX_OPERATOR,
+    ['q']   = VS_LEX_FUNCTION,
+    ['r']   = VS_LEX_FUNCTION,
+    ['s']   = VS_LEX_FUNCTION,
+    ['t']   = VS_LEX_FUNCTION | VS_LEX_UNARY_POSTFIX_OPERATOR,
+    ['u']   = VS_LEX_FUNCTION,
+    ['v']   = VS_LEX_FUNCTION,
+    ['w']   = VS_LEX_FUNCTION,
+    ['x']   = VS_LEX_VARIABLE,
+    ['y']   = VS_LEX_VARIABLE,
+    ['z']   = VS_LEX_FUNCTION,
+    ['~']   = VS_LEX_OPERATOR,
+    [0xB2]  = VS_LEX_UNARY_POSTFIX_OPERATOR, // ²
+    [0xB3]  = VS_LEX_UNARY_POSTFIX_OPERATOR, // ³
+    [0xD7]  = VS_LEX_OPERATOR, // ×
+    [0xF7]  = VS_LEX_OPERATOR, // ÷
+};
+
+#pragma mark Classification
+
+int vs_lex_class(unsigned short __c) {
+    if (__c < 256) {
+        return VS_LEX_CLASSES[__c];
+    }
+
+    switch (__c) {
+        case 0x03C0: return VS_LEX_CONSTANT;              // π
+        case 0x2081: return VS_LEX_FUNCTION;              // ₁
+        case 0x2082: return VS_LEX_FUNCTION;              // ₂
+        case 0x2212: return VS_LEX_OPERATOR;              // −
+        case 0x221A: return VS_LEX_UNARY_PREFIX_OPERATOR; // √
+        case 0x221B: return VS_LEX_UNARY_PREFIX_OPERATOR; // ∛
+        case 0x2227: return VS_LEX_OPERATOR;              // ∧
+        case 0x2228: return VS_LEX_OPERATOR;              // ∨
+        case 0x226A: return VS_LEX_OPERATOR;              // ≪
+        case 0x226B: return VS_LEX_OPERATOR;              // ≫
+        case 0x22BB: return VS_LEX_OPERATOR;              // ⊻
+        case 0x22BC: return VS_LEX_OPERATOR;              // ⊼
+        case 0x22BD: return VS_LEX_OPERATOR;              // ⊽
+        case 0x22CA: return VS_LEX_OPERATOR;              // ⋊
+        default:     return 0;
+    }
+}
+
+int vs_lex_classes(const unsigned short *__s, size_t __n) {
+    int o = 0xFF;
+
+    for (size_t i = 0; (i < __n) && (o != 0); i++) {
+        o &= vs_lex_class(__s[i]);
+    }
+
+    return o;
+}
+
+int vs_lex_kind(int __classes) {
+    if      (__classes & VS_LEX_NUMERIC)                return VS_LEX_KIND_NUMERIC;
+    else if (__classes & VS_LEX_FUNCTION)               return VS_LEX_KIND_FUNCTION;
+    else if (__classes & VS_LEX_OPERATOR)               return VS_LEX_KIND_OPERATOR;
+    else if (__classes & VS_LEX_UNARY_POSTFIX_OPERATOR) return VS_LEX_KIND_UNARY_POSTFIX_OPERATOR;
+    else if (__classes & VS_LEX_UNARY_PREFIX_OPERATOR)  return VS_LEX_KIND_UNARY_PREFIX_OPERATOR;
+    else if (__classes & VS_LEX_CONSTANT)               return VS_LEX_KIND_CONSTANT;
+    else if (__classes & VS_LEX_PARENTHESIS)            return VS_LEX_KIND_PARENTHESIS;
+    else if (__classes & VS_LEX_VARIABLE)               return VS_LEX_KIND_VARIABLE;
+    else                                                return VS_LEX_KIND_UNKNOWN;
+}
+
+/**
+ *  Max length of numeric literals parsed by vs_lex_number() without allocating memory.
+ */
+#define VS_LEX_NUMBER_BUFFER_LENGTH 64
+
+int vs_lex_number(const unsigned short *__s, size_t __n, double *__value) {
+    if (__n == 3 && (__s[0] | 0x20) == 'n' && (__s[1] | 0x20) == 'a' && (__s[2] | 0x20) == 'n') {
+        *__value = NAN;
+        return 1;
+    }
+
+    char buffer[VS_LEX_NUMBER_BUFFER_LENGTH];
+    char *b = (__n < VS_LEX_NUMBER_BUFFER_LENGTH) ? buffer : (char *)malloc(__n + 1);
+    size_t k = 0;
+    int digits = 0;
+    int points = 0;
+    int o = 1;
+
+    if (b == NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0; (i < __n) && o; i++) {
+        unsigned short c = __s[i];
+
+        if (c == ',') {
+            continue;
+        }
+        else if (c == '.') {
+            o = (++points <= 1);
+        }
+        else if (c >= '0' && c <= '9') {
+            digits++;
+        }
+        else {
+            o = 0;
+        }
+
+        b[k++] = (char)c;
+    }
+
+    o = (o && digits > 0) && vs_num_parse(b, k, VS_NUM_DECIMAL_SEPARATOR, NULL, __value);
+
+    if (b != buffer) {
+        free(b);
+    }
+
+    return o;
+}
+
+#pragma mark Symbols
+
+typedef struct {
+    unsigned short *s;
+    size_t n;
+    int symbol;
+    int kind;
+} vs_lex_symbol_t;
+
+struct vs_lex_symtab {
+    vs_lex_symbol_t *slots;
+    size_t mask;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ *  FNV-1a hash of UTF-16 characters.
+ *
+ *  @param __s
+ *  @param __n
+ *
+ *  @return The hash.
+ */
+static size_t vs_lex_hash(const unsigned short *__s, size_t __n) {
+    size_t o = (size_t)0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < __n; i++) {
+        o ^= __s[i];
+        o *= (size_t)0x100000001b3ULL;
+    }
+
+    return o;
+}
+
+/**
+ *  Finds the slot of a symbol, or the empty slot where it belongs.
+ *
+ *  @param __t
+ *  @param __s
+ *  @param __n
+ *
+ *  @return The slot.
+ */
+static vs_lex_symbol_t *vs_lex_symtab_slot(const vs_lex_symtab_t *__t, const unsigned short *__s, size_t __n) {
+    size_t i = vs_lex_hash(__s, __n) & __t->mask;
+
+    while (1) {
+        vs_lex_symbol_t *slot = &__t->slots[i];
+
+        if (slot->s == NULL || (slot->n == __n && memcmp(slot->s, __s, __n * sizeof(unsigned short)) == 0)) {
+            return slot;
+        }
+
+        i = (i + 1) & __t->mask;
+    }
+}
+
+vs_lex_symtab_t *vs_lex_symtab_alloc(size_t __capacity) {
+    size_t size = 2;
+
+    // Keep the table at most half full.
+    while (size < 2 * __capacity) {
+        size <<= 1;
+    }
+
+    vs_lex_symtab_t *o = (vs_lex_symtab_t *)calloc(1, sizeof(vs_lex_symtab_t));
+
+    if (o == NULL) {
+        return NULL;
+    }
+
+    o->slots = (vs_lex_symbol_t *)calloc(size, sizeof(vs_lex_symbol_t));
+
+    if (o->slots == NULL) {
+        free(o);
+        return NULL;
+    }
+
+    o->mask = size - 1;
+    o->capacity = __capacity;
+
+    return o;
+}
+
+void vs_lex_symtab_free(vs_lex_symtab_t *__t) {
+    if (__t == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i <= __t->mask; i++) {
+        free(__t->slots[i].s);
+    }
+
+    free(__t->slots);
+    free(__t);
+}
+
+int vs_lex_symtab_add(vs_lex_symtab_t *__t, const unsigned short *__s, size_t __n, int __symbol, int __kind) {
+    if (__t == NULL || __s == NULL || __n == 0 || __symbol < 0) {
+        return 0;
+    }
+
+    vs_lex_symbol_t *slot = vs_lex_symtab_slot(__t, __s, __n);
+
+    if (slot->s == NULL) {
+        if (__t->count >= __t->capacity) {
+            return 0;
+        }
+
+        slot->s = (unsigned short *)malloc(__n * sizeof(unsigned short));
+
+        if (slot->s == NULL) {
+            return 0;
+        }
+
+        memcpy(slot->s, __s, __n * sizeof(unsigned short));
+        slot->n = __n;
+        __t->count++;
+    }
+
+    slot->symbol = __symbol;
+    slot->kind = __kind;
+
+    return 1;
+}
+
+int vs_lex_symtab_find(const vs_lex_symtab_t *__t, const unsigned short *__s, size_t __n, int *__kind) {
+    if (__t == NULL || __n == 0) {
+        return VS_LEX_SYMBOL_UNKNOWN;
+    }
+
+    const vs_lex_symbol_t *slot = vs_lex_symtab_slot(__t, __s, __n);
+
+    if (slot->s == NULL) {
+        return VS_LEX_SYMBOL_UNKNOWN;
+    }
+
+    if (__kind != NULL) {
+        *__kind = slot->kind;
+    }
+
+    return slot->symbol;
+}
+
+#pragma mark Custom Variable Sets
+
+/**
+ *  Number of bytes per bitmap page of 256 characters.
+ */
+#define VS_LEX_PAGE_SIZE 32
+
+static inline int vs_lex_member(const vs_lex_set_t *__set, unsigned short __c) {
+    const unsigned char *page = __set->pages[__c >> 8];
+
+    return (page != NULL) && (page[(__c & 0xFF) >> 3] & (1 << (__c & 7)));
+}
+
+int vs_lex_set_init(vs_lex_set_t *__set, const unsigned char *__bitmap, size_t __n, size_t __range) {
+    static const unsigned char empty[VS_LEX_PAGE_SIZE] = { 0 };
+    size_t count = 0;
+
+    memset(__set, 0, sizeof(vs_lex_set_t));
+    __set->range = __range;
+
+    if (__n > 256 * VS_LEX_PAGE_SIZE) {
+        __n = 256 * VS_LEX_PAGE_SIZE;
+    }
+
+    // Count the pages with members, so that they can be stored contiguously.
+    for (size_t i = 0; i * VS_LEX_PAGE_SIZE < __n; i++) {
+        size_t length = (__n - i * VS_LEX_PAGE_SIZE < VS_LEX_PAGE_SIZE) ? (__n - i * VS_LEX_PAGE_SIZE) : VS_LEX_PAGE_SIZE;
+
+        if (memcmp(__bitmap + i * VS_LEX_PAGE_SIZE, empty, length) != 0) {
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        return 1;
+    }
+
+    __set->bits = (unsigned char *)calloc(count, VS_LEX_PAGE_SIZE);
+
+    if (__set->bits == NULL) {
+        return 0;
+    }
+
+    unsigned char *page = __set->bits;
+
+    for (size_t i = 0; i * VS_LEX_PAGE_SIZE < __n; i++) {
+        size_t length = (__n - i * VS_LEX_PAGE_SIZE < VS_LEX_PAGE_SIZE) ? (__n - i * VS_LEX_PAGE_SIZE) : VS_LEX_PAGE_SIZE;
+
+        if (memcmp(__bitmap + i * VS_LEX_PAGE_SIZE, empty, length) != 0) {
+            memcpy(page, __bitmap + i * VS_LEX_PAGE_SIZE, length);
+            __set->pages[i] = page;
+            page += VS_LEX_PAGE_SIZE;
+        }
+    }
+
+    return 1;
+}
+
+void vs_lex_set_free(vs_lex_set_t *__set) {
+    free(__set->bits);
+    memset(__set, 0, sizeof(vs_lex_set_t));
+}
+
+int vs_lex_set_member(const vs_lex_set_t *__set, unsigned short __c) {
+    return vs_lex_member(__set, __c);
+}
+
+int vs_lex_set_contains(const vs_lex_set_t *__set, const unsigned short *__s, size_t __n) {
+    for (size_t i = 0; i < __n; i++) {
+        if (!vs_lex_member(__set, __s[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#pragma mark Tokenization
+
+void vs_lex_classify(vs_lex_token_t *__t, const unsigned short *__s, const vs_lex_symtab_t *__symbols) {
+    const unsigned short *s = __s + __t->offset;
+    int kind = VS_LEX_KIND_UNKNOWN;
+
+    __t->symbol = vs_lex_symtab_find(__symbols, s, __t->length, &kind);
+    __t->value = NAN;
+
+    // Symbols without a kind of their own (i.e. "=") are classified by their characters, like any other token.
+    if (__t->symbol != VS_LEX_SYMBOL_UNKNOWN) {
+        __t->kind = (kind != VS_LEX_KIND_UNKNOWN) ? kind : vs_lex_kind(vs_lex_classes(s, __t->length));
+        return;
+    }
+
+    if (vs_lex_number(s, __t->length, &__t->value)) {
+        __t->kind = VS_LEX_KIND_NUMERIC;
+        return;
+    }
+
+    __t->kind = vs_lex_kind(vs_lex_classes(s, __t->length));
+
+    if (__t->kind == VS_LEX_KIND_NUMERIC) {
+        __t->kind = VS_LEX_KIND_MALFORMED_NUMERIC;
+    }
+}
+
+int vs_lex_next(const unsigned short *__s, size_t __n, size_t *__i, const vs_lex_set_t *__sets, size_t __m, const vs_lex_symtab_t *__symbols, vs_lex_token_t *__t) {
+    size_t range = 1;
+
+    for (size_t i = *__i; i < __n; i++) {
+        int shouldRecordNow = 1;
+        unsigned short key = __s[i];
+
+        // Ignore white space.
+        if (key == ' ') {
+            continue;
+        }
+
+        if (i + 1 < __n) {
+            unsigned short nextKey = __s[i + 1];
+
+            // Check custom variable sets, each of which extends the capture range on its own.
+            for (size_t j = 0; j < __m; j++) {
+                const vs_lex_set_t *set = &__sets[j];
+
+                if ((set->range > 1) && (range < set->range) && vs_lex_member(set, key) && vs_lex_member(set, nextKey)) {
+                    range++;
+                    shouldRecordNow = 0;
+                }
+            }
+
+            // Keep capturing runs of numeric or of function characters.
+            if ((vs_lex_class(key) & vs_lex_class(nextKey)) & (VS_LEX_NUMERIC | VS_LEX_FUNCTION)) {
+                range++;
+                shouldRecordNow = 0;
+            }
+        }
+
+        if (shouldRecordNow) {
+            size_t location = (range > i + 1) ? 0 : (i + 1 - range);
+
+            __t->offset = location;
+            __t->length = i + 1 - location;
+            vs_lex_classify(__t, __s, __symbols);
+
+            *__i = i + 1;
+
+            return 1;
+        }
+    }
+
+    *__i = __n;
+
+    return 0;
+}
+
+size_t vs_lex_tokenize(const unsigned short *__s, size_t __n, const vs_lex_set_t *__sets, size_t __m, const vs_lex_symtab_t *__symbols, vs_lex_token_t *__tokens) {
+    size_t o = 0;
+    size_t i = 0;
+
+    while (vs_lex_next(__s, __n, &i, __sets, __m, __symbols, &__tokens[o])) {
+        o++;
+    }
+
+    return o;
+}
@@ -0,0 +1,250 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS expression lexing tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vslex_h
+#define vslex_h
+
+#include <stddef.h>
+
+/**
+ *  Character classes, one bit per math character set of VSMathUtil (i.e. VSMathUtil::numericCharacterSet). A character may belong to
+ *  several classes, such as the letters of "pct" which are both function and unary postfix operator characters.
+ */
+#define VS_LEX_NUMERIC                0x01
+#define VS_LEX_FUNCTION               0x02
+#define VS_LEX_OPERATOR               0x04
+#define VS_LEX_UNARY_PREFIX_OPERATOR  0x08
+#define VS_LEX_UNARY_POSTFIX_OPERATOR 0x10
+#define VS_LEX_CONSTANT               0x20
+#define VS_LEX_VARIABLE               0x40
+#define VS_LEX_PARENTHESIS            0x80
+
+/**
+ *  Token kinds, numerically identical to VSMathTokenType. Numeric tokens whose characters do not form a valid number are of kind
+ *  VS_LEX_KIND_MALFORMED_NUMERIC, which has no VSMathTokenType equivalent.
+ */
+#define VS_LEX_KIND_UNKNOWN                -1
+#define VS_LEX_KIND_NUMERIC                 0
+#define VS_LEX_KIND_FUNCTION                1
+#define VS_LEX_KIND_OPERATOR                2
+#define VS_LEX_KIND_UNARY_PREFIX_OPERATOR   3
+#define VS_LEX_KIND_UNARY_POSTFIX_OPERATOR  4
+#define VS_LEX_KIND_CONSTANT                5
+#define VS_LEX_KIND_VARIABLE                6
+#define VS_LEX_KIND_PARENTHESIS             7
+#define VS_LEX_KIND_MALFORMED_NUMERIC       8
+
+/**
+ *  Symbol id of tokens which are not found in the symbol table.
+ */
+#define VS_LEX_SYMBOL_UNKNOWN -1
+
+/**
+ *  Token within a UTF-16 expression buffer, which it does not copy. Numeric tokens carry their value, parsed once when lexed.
+ */
+typedef struct {
+    int kind;
+    int symbol;
+    size_t offset;
+    size_t length;
+    double value;
+} vs_lex_token_t;
+
+/**
+ *  Table of math symbols keyed by their UTF-16 characters, mapping each symbol to its id (i.e. VSMathSymbolType) and token kind.
+ */
+typedef struct vs_lex_symtab vs_lex_symtab_t;
+
+/**
+ *  Custom variable set compiled for lexing: a bitmap of its UTF-16 members split into 256 character pages, where pages without any
+ *  member are NULL. Consecutive members are captured into tokens of up to range characters.
+ */
+typedef struct {
+    const unsigned char *pages[256];
+    unsigned char *bits;
+    size_t range;
+} vs_lex_set_t;
+
+#pragma mark Classification
+
+/**
+ *  Gets the character classes of a UTF-16 character.
+ *
+ *  @param __c
+ *
+ *  @return Bitwise OR of the VS_LEX_* classes of the character, 0 if none.
+ */
+int vs_lex_class(unsigned short __c);
+
+/**
+ *  Gets the character classes shared by all characters of a UTF-16 string.
+ *
+ *  @param __s
+ *  @param __n
+ *
+ *  @return Bitwise AND of the VS_LEX_* classes of every character, all classes if __n is 0.
+ */
+int vs_lex_classes(const unsigned short *__s, size_t __n);
+
+/**
+ *  Gets the token kind of a set of character classes, i.e. the kind of a token which is not a symbol and not a valid number.
+ *
+ *  @param __classes Bitwise OR of VS_LEX_* classes.
+ *
+ *  @return The VS_LEX_KIND_* kind, VS_LEX_KIND_UNKNOWN if none.
+ */
+int vs_lex_kind(int __classes);
+
+/**
+ *  Parses a UTF-16 numeric literal: digits with at most one decimal point, where commas are grouping separators and are ignored, or
+ *  "nan" in any case.
+ *
+ *  @param __s
+ *  @param __n
+ *  @param __value Receives the value of the literal.
+ *
+ *  @return 1 if valid, 0 otherwise.
+ */
+int vs_lex_number(const unsigned short *__s, size_t __n, double *__value);
+
+#pragma mark Symbols
+
+/**
+ *  Creates an empty symbol table.
+ *
+ *  @param __capacity Maximum number of symbols.
+ *
+ *  @return The symbol table, NULL if out of memory.
+ */
+vs_lex_symtab_t *vs_lex_symtab_alloc(size_t __capacity);
+
+/**
+ *  Frees a symbol table.
+ *
+ *  @param __t
+ */
+void vs_lex_symtab_free(vs_lex_symtab_t *__t);
+
+/**
+ *  Adds a symbol to a symbol table, replacing the symbol of the same characters if any.
+ *
+ *  @param __t
+ *  @param __s
+ *  @param __n
+ *  @param __symbol Symbol id, at least 0.
+ *  @param __kind   VS_LEX_KIND_* kind of the symbol, VS_LEX_KIND_UNKNOWN to derive it from its character classes.
+ *
+ *  @return 1 if added, 0 if the table is full or out of memory.
+ */
+int vs_lex_symtab_add(vs_lex_symtab_t *__t, const unsigned short *__s, size_t __n, int __symbol, int __kind);
+
+/**
+ *  Looks up a symbol by its UTF-16 characters.
+ *
+ *  @param __t
+ *  @param __s
+ *  @param __n
+ *  @param __kind Receives the kind of the symbol if found, may be NULL.
+ *
+ *  @return The symbol id, VS_LEX_SYMBOL_UNKNOWN if not found.
+ */
+int vs_lex_symtab_find(const vs_lex_symtab_t *__t, const unsigned short *__s, size_t __n, int *__kind);
+
+#pragma mark Custom Variable Sets
+
+/**
+ *  Compiles a custom variable set from a bitmap of its members, in which character c is bit (c & 7) of byte (c >> 3) (i.e. the first
+ *  plane of NSCharacterSet::bitmapRepresentation).
+ *
+ *  @param __set
+ *  @param __bitmap
+ *  @param __n      Length of the bitmap in bytes, only the first 8192 bytes are used.
+ *  @param __range  Max number of characters per token.
+ *
+ *  @return 1 if compiled, 0 if out of memory.
+ */
+int vs_lex_set_init(vs_lex_set_t *__set, const unsigned char *__bitmap, size_t __n, size_t __range);
+
+/**
+ *  Frees the memory of a compiled custom variable set.
+ *
+ *  @param __set
+ */
+void vs_lex_set_free(vs_lex_set_t *__set);
+
+/**
+ *  Verifies whether a UTF-16 character is a member of a custom variable set.
+ *
+ *  @param __set
+ *  @param __c
+ *
+ *  @return 1 if member, 0 otherwise.
+ */
+int vs_lex_set_member(const vs_lex_set_t *__set, unsigned short __c);
+
+/**
+ *  Verifies whether all characters of a UTF-16 string are members of a custom variable set.
+ *
+ *  @param __set
+ *  @param __s
+ *  @param __n
+ *
+ *  @return 1 if all are members, 0 otherwise.
+ */
+int vs_lex_set_contains(const vs_lex_set_t *__set, const unsigned short *__s, size_t __n);
+
+#pragma mark Tokenization
+
+/**
+ *  Classifies the characters of a UTF-16 expression buffer at the offset and length of a token: symbols take the id and kind of the
+ *  symbol table, valid numeric literals are parsed into the value of the token, and every other token takes the kind of its character
+ *  classes.
+ *
+ *  @param __t       Token of which the offset and length are set.
+ *  @param __s
+ *  @param __symbols Symbol table, NULL if none.
+ */
+void vs_lex_classify(vs_lex_token_t *__t, const unsigned short *__s, const vs_lex_symtab_t *__symbols);
+
+/**
+ *  Splits a UTF-16 math expression in infix notation into classified tokens in a single pass (see vs_lex_classify()). Spaces separate
+ *  tokens, runs of numeric or of function characters are captured into a single token, as are runs of up to range characters of
+ *  every custom variable set with a range over 1. Every other character is a token on its own.
+ *
+ *  @param __s
+ *  @param __n
+ *  @param __sets    Custom variable sets, NULL if none.
+ *  @param __m       Number of custom variable sets.
+ *  @param __symbols Symbol table, NULL if none.
+ *  @param __tokens  Receives the tokens, must have room for __n tokens.
+ *
+ *  @return The number of tokens.
+ */
+size_t vs_lex_tokenize(const unsigned short *__s, size_t __n, const vs_lex_set_t *__sets, size_t __m, const vs_lex_symtab_t *__symbols, vs_lex_token_t *__tokens);
+
+/**
+ *  Lexes the next token of a UTF-16 math expression, following the rules of vs_lex_tokenize(). The lexer keeps no state across token
+ *  boundaries: the tokens following the end of a token only depend on the characters from there on, and the token itself only depends
+ *  on its characters and on the character following it. Expressions can therefore be re-lexed from the end of any token preceding an
+ *  edit, which is what incremental parsing relies on.
+ *
+ *  @param __s
+ *  @param __n
+ *  @param __i       Offset to lex from, which must be 0 or the end of a token. Receives the end of the token, or __n if none is left.
+ *  @param __sets    Custom variable sets, NULL if none.
+ *  @param __m       Number of custom variable sets.
+ *  @param __symbols Symbol table, NULL if none.
+ *  @param __t       Receives the token.
+ *
+ *  @return 1 if a token was lexed, 0 if only white space is left.
+ */
+int vs_lex_next(const unsigned short *__s, size_t __n, size_t *__i, const vs_lex_set_t *__sets, size_t __m, const vs_lex_symtab_t *__symbols, vs_lex_token_t *__t);
+
+#endif
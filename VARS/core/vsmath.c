@@ -7,12 +7,14 @@
  */
 
 #import <float.h>
-#import <locale.h>
+#import <limits.h>
 #import <math.h>
+#import <stdio.h>
 #import <stdlib.h>
-#import <xlocale.h>
+#import <string.h>
 
 #import "vsmath.h"
+#import "vsnum.h"
 
 #pragma mark Angle Conversions
 
@@ -90,38 +92,207 @@ double fgtor(double __n) {
 
 #pragma mark Trigonometric Functions
 
+#define VS_M_SQRT3_2  0.86602540378443864676 // sin(60°)
+#define VS_M_SQRT3    1.73205080756887729353 // tan(60°)
+#define VS_M_1_SQRT3  0.57735026918962576451 // tan(30°)
+
+/**
+ *  Reduces an angle in a unit where a right angle measures __r, modulo a full turn, to the interval [-__r/2, __r/2]. The reduction
+ *  is exact: fmod() is exact and the subtraction cancels without rounding.
+ *
+ *  @param __n
+ *  @param __r
+ *  @param __q Receives the quadrant (0-3) of the angle.
+ *
+ *  @return The reduced angle, in the same unit.
+ */
+static double vs_m_reduce(double __n, double __r, int *__q) {
+    double o = fmod(__n, 4.0 * __r);
+    double k = nearbyint(o / __r);
+
+    *__q = (((int)k % 4) + 4) % 4;
+
+    return (o - (k * __r));
+}
+
+/**
+ *  Computes the sine of a reduced angle, exact at 0, ±__t and ±__r/2.
+ *
+ *  @param __y Reduced angle.
+ *  @param __r Right angle in the unit of __y.
+ *  @param __t Third of a right angle if exactly representable in the unit of __y, NAN otherwise.
+ *
+ *  @return The computed double value.
+ */
+static double vs_m_sinred(double __y, double __r, double __t) {
+    double a = fabs(__y);
+
+    if (a == 0.0)       return 0.0;
+    if (a == __r / 2.0) return copysign(M_SQRT1_2, __y);
+    if (a == __t)       return copysign(0.5, __y);
+
+    return sin(__y * (M_PI_2 / __r));
+}
+
+/**
+ *  Computes the cosine of a reduced angle, exact at 0, ±__t and ±__r/2.
+ *
+ *  @param __y Reduced angle.
+ *  @param __r Right angle in the unit of __y.
+ *  @param __t Third of a right angle if exactly representable in the unit of __y, NAN otherwise.
+ *
+ *  @return The computed double value.
+ */
+static double vs_m_cosred(double __y, double __r, double __t) {
+    double a = fabs(__y);
+
+    if (a == 0.0)       return 1.0;
+    if (a == __r / 2.0) return M_SQRT1_2;
+    if (a == __t)       return VS_M_SQRT3_2;
+
+    return cos(__y * (M_PI_2 / __r));
+}
+
+/**
+ *  Computes the tangent of a reduced angle, or its negated cotangent if __cot is 1, exact at 0, ±__t and ±__r/2. The cotangent of 0
+ *  is the pole of the tangent and yields NAN.
+ *
+ *  @param __y   Reduced angle.
+ *  @param __r   Right angle in the unit of __y.
+ *  @param __t   Third of a right angle if exactly representable in the unit of __y, NAN otherwise.
+ *  @param __cot
+ *
+ *  @return The computed double value.
+ */
+static double vs_m_tanred(double __y, double __r, double __t, int __cot) {
+    double a = fabs(__y);
+
+    if (__cot == 1) {
+        if (a == 0.0)       return NAN;
+        if (a == __r / 2.0) return copysign(1.0, -__y);
+        if (a == __t)       return copysign(VS_M_SQRT3, -__y);
+
+        return (-1.0 / tan(__y * (M_PI_2 / __r)));
+    }
+    else {
+        if (a == 0.0)       return 0.0;
+        if (a == __r / 2.0) return copysign(1.0, __y);
+        if (a == __t)       return copysign(VS_M_1_SQRT3, __y);
+
+        return tan(__y * (M_PI_2 / __r));
+    }
+}
+
+/**
+ *  Computes the sine of an angle in a unit where a right angle measures __r.
+ *
+ *  @param __n
+ *  @param __r
+ *  @param __t Third of a right angle if exactly representable in this unit, NAN otherwise.
+ *
+ *  @return The computed double value.
+ */
+static double vs_m_sinu(double __n, double __r, double __t) {
+    if (!isfinite(__n)) return NAN;
+
+    // Zero keeps its sign, like sin(-0.0). Other exact zeros are returned as +0.
+    if (__n == 0.0) return __n;
+
+    int q;
+    double y = vs_m_reduce(__n, __r, &q);
+    double o;
+
+    switch (q) {
+        case 0:  o = vs_m_sinred(y, __r, __t);  break;
+        case 1:  o = vs_m_cosred(y, __r, __t);  break;
+        case 2:  o = -vs_m_sinred(y, __r, __t); break;
+        default: o = -vs_m_cosred(y, __r, __t); break;
+    }
+
+    return ((o == 0.0) ? 0.0 : o);
+}
+
+/**
+ *  Computes the cosine of an angle in a unit where a right angle measures __r.
+ *
+ *  @param __n
+ *  @param __r
+ *  @param __t Third of a right angle if exactly representable in this unit, NAN otherwise.
+ *
+ *  @return The computed double value.
+ */
+static double vs_m_cosu(double __n, double __r, double __t) {
+    if (!isfinite(__n)) return NAN;
+
+    int q;
+    double y = vs_m_reduce(__n, __r, &q);
+    double o;
+
+    switch (q) {
+        case 0:  o = vs_m_cosred(y, __r, __t);  break;
+        case 1:  o = -vs_m_sinred(y, __r, __t); break;
+        case 2:  o = -vs_m_cosred(y, __r, __t); break;
+        default: o = vs_m_sinred(y, __r, __t);  break;
+    }
+
+    return ((o == 0.0) ? 0.0 : o);
+}
+
+/**
+ *  Computes the tangent of an angle in a unit where a right angle measures __r. Poles are detected from the reduced angle, so no
+ *  cosine needs to be computed.
+ *
+ *  @param __n
+ *  @param __r
+ *  @param __t Third of a right angle if exactly representable in this unit, NAN otherwise.
+ *
+ *  @return The computed double value, NAN at poles.
+ */
+static double vs_m_tanu(double __n, double __r, double __t) {
+    if (!isfinite(__n)) return NAN;
+
+    // Zero keeps its sign, like sin(-0.0). Other exact zeros are returned as +0.
+    if (__n == 0.0) return __n;
+
+    int q;
+    double y = vs_m_reduce(__n, __r, &q);
+    double o = vs_m_tanred(y, __r, __t, (q & 1));
+
+    return ((o == 0.0) ? 0.0 : o);
+}
+
 float fsindf(float __n) {
-    float o = fsinrf(fdtorf(__n));
+    float o = (float)vs_m_sinu(__n, 90.0, 30.0);
 
     return o;
 }
 
 double fsind(double __n) {
-    double o = fsinr(fdtor(__n));
+    double o = vs_m_sinu(__n, 90.0, 30.0);
 
     return o;
 }
 
 float fcosdf(float __n) {
-    float o = fcosrf(fdtorf(__n));
+    float o = (float)vs_m_cosu(__n, 90.0, 30.0);
 
     return o;
 }
 
 double fcosd(double __n) {
-    double o = fcosr(fdtor(__n));
+    double o = vs_m_cosu(__n, 90.0, 30.0);
 
     return o;
 }
 
 float ftandf(float __n) {
-    float o = ftanrf(fdtorf(__n));
+    float o = (float)vs_m_tanu(__n, 90.0, 30.0);
 
     return o;
 }
 
 double ftand(double __n) {
-    double o = ftanr(fdtor(__n));
+    double o = vs_m_tanu(__n, 90.0, 30.0);
 
     return o;
 }
@@ -211,37 +382,37 @@ double ftanr(double __n) {
 }
 
 float fsingf(float __n) {
-    float o = fsinrf(fgtorf(__n));
+    float o = (float)vs_m_sinu(__n, 100.0, NAN);
 
     return o;
 }
 
 double fsing(double __n) {
-    double o = fsinr(fgtor(__n));
+    double o = vs_m_sinu(__n, 100.0, NAN);
 
     return o;
 }
 
 float fcosgf(float __n) {
-    float o = fcosrf(fgtorf(__n));
+    float o = (float)vs_m_cosu(__n, 100.0, NAN);
 
     return o;
 }
 
 double fcosg(double __n) {
-    double o = fcosr(fgtor(__n));
+    double o = vs_m_cosu(__n, 100.0, NAN);
 
     return o;
 }
 
 float ftangf(float __n) {
-    float o = ftanrf(fgtorf(__n));
+    float o = (float)vs_m_tanu(__n, 100.0, NAN);
 
     return o;
 }
 
 double ftang(double __n) {
-    double o = ftanr(fgtor(__n));
+    double o = vs_m_tanu(__n, 100.0, NAN);
 
     return o;
 }
@@ -1269,71 +1440,310 @@ int ndigits(int __n) {
     return 1;
 }
 
+#pragma mark String Scanning
+
+/**
+ *  Skips the whitespace characters of the C locale.
+ *
+ *  @param __c
+ *
+ *  @return Pointer to the first character which is not whitespace.
+ */
+static const char *vs_m_skipspace(const char *__c) {
+    while ((*__c == ' ') || ((*__c >= '\t') && (*__c <= '\r'))) __c++;
+
+    return __c;
+}
+
+/**
+ *  Gets the scanning result of a number of __k bytes at __c, ending a string which starts at __s.
+ *
+ *  @param __s
+ *  @param __c
+ *  @param __k
+ *  @param __r 1 if the number is out of range, 0 otherwise.
+ *  @param __n Optional pointer to receive the number of bytes scanned.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+static int vs_m_scanresult(const char *__s, const char *__c, size_t __k, int __r, size_t *__n) {
+    if (__n != NULL) *__n = (__k == 0) ? 0 : (size_t)(__c - __s) + __k;
+
+    if (__k == 0) {
+        return VS_M_SCAN_EINVAL;
+    }
+    else if (__c[__k] != 0) {
+        return VS_M_SCAN_ETRAIL;
+    }
+    else {
+        return __r ? VS_M_SCAN_ERANGE : VS_M_SCAN_OK;
+    }
+}
+
+/**
+ *  Scans the magnitude of an optionally signed integer with the prefixes of strtol() with base 0, saturating at ULLONG_MAX.
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the magnitude.
+ *  @param __s Pointer to receive 1 if the integer is negative, 0 otherwise.
+ *  @param __r Pointer to receive 1 if the magnitude is greater than ULLONG_MAX, 0 otherwise.
+ *
+ *  @return The number of bytes scanned, 0 if the string does not start with an integer.
+ */
+static size_t vs_m_scanint(const char *__c, unsigned long long int *__o, int *__s, int *__r) {
+    const char *c = __c;
+    unsigned long long int o = 0;
+    unsigned int base = 10;
+    int overflow = 0;
+
+    *__s = (*c == '-');
+
+    if ((*c == '-') || (*c == '+')) c++;
+
+    if ((c[0] == '0') && ((c[1] | 0x20) == 'x') && (((c[2] >= '0') && (c[2] <= '9')) || (((c[2] | 0x20) >= 'a') && ((c[2] | 0x20) <= 'f')))) {
+        base = 16;
+        c += 2;
+    }
+    else if (c[0] == '0') {
+        base = 8;
+    }
+
+    const char *digits = c;
+
+    for (;; c++) {
+        unsigned int d;
+
+        if ((*c >= '0') && (*c <= '9')) {
+            d = (unsigned int)(*c - '0');
+        }
+        else if (((*c | 0x20) >= 'a') && ((*c | 0x20) <= 'f')) {
+            d = (unsigned int)((*c | 0x20) - 'a' + 10);
+        }
+        else {
+            break;
+        }
+
+        if (d >= base) break;
+
+        if (o > (ULLONG_MAX - d) / base) {
+            overflow = 1;
+            o = ULLONG_MAX;
+        }
+        else if (!overflow) {
+            o = (o * base) + d;
+        }
+    }
+
+    if (c == digits) return 0;
+
+    *__o = o;
+    *__r = overflow;
+
+    return (size_t)(c - __c);
+}
+
+int fstrscannumf(const char *__c, float *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    int r = 0;
+    size_t k = vs_num_scanf(c, strlen(c), VS_NUM_DECIMAL_SEPARATOR, NULL, __o, &r);
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int fstrscannum(const char *__c, double *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    int r = 0;
+    size_t k = vs_num_scan(c, strlen(c), VS_NUM_DECIMAL_SEPARATOR, NULL, __o, &r);
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int fstrscannuml(const char *__c, long double *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    double d;
+    int r = 0;
+    size_t k = vs_num_scan(c, strlen(c), VS_NUM_DECIMAL_SEPARATOR, NULL, &d, &r);
+
+    if (k == 0) return vs_m_scanresult(__c, c, k, r, __n);
+
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    *__o = d;
+#else
+    if (!isfinite(d) && !r) {
+        // nan, inf or infinity.
+        *__o = d;
+    }
+    else {
+        // Digits and exponent without the decimal separator, the only locale dependent part of the syntax of strtold().
+        char buffer[64];
+        char *b = (k + 24 <= sizeof(buffer)) ? buffer : malloc(k + 24);
+        size_t j = 0;
+        long int e = 0;
+        size_t i = 0;
+
+        if (b == NULL) {
+            *__o = d;
+            return vs_m_scanresult(__c, c, k, r, __n);
+        }
+
+        if ((c[i] == '-') || (c[i] == '+')) b[j++] = c[i++];
+
+        for (int fraction = 0; (i < k) && ((c[i] | 0x20) != 'e'); i++) {
+            if (c[i] == '.') {
+                fraction = 1;
+            }
+            else {
+                b[j++] = c[i];
+                e -= fraction;
+            }
+        }
+
+        // An exponent which overflows long int is already far out of range.
+        long int x = (i < k) ? strtol(c + i + 1, NULL, 10) : 0;
+
+        e = (x < LONG_MIN / 2) ? x : (e + x);
+
+        snprintf(b + j, 24, "e%ld", e);
+
+        *__o = strtold(b, NULL);
+        r = (*__o == 0.0L) ? (d != 0.0 || r) : isinf(*__o);
+
+        if (b != buffer) free(b);
+    }
+#endif
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int lstrscannum(const char *__c, long int *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    unsigned long long int m = 0;
+    int s = 0;
+    int r = 0;
+    size_t k = vs_m_scanint(c, &m, &s, &r);
+
+    if (k == 0) return vs_m_scanresult(__c, c, k, r, __n);
+
+    if (s) {
+        r = r || (m > (unsigned long long int)LONG_MAX + 1);
+        *__o = r ? LONG_MIN : (long int)(0 - m);
+    }
+    else {
+        r = r || (m > LONG_MAX);
+        *__o = r ? LONG_MAX : (long int)m;
+    }
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int llstrscannum(const char *__c, long long int *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    unsigned long long int m = 0;
+    int s = 0;
+    int r = 0;
+    size_t k = vs_m_scanint(c, &m, &s, &r);
+
+    if (k == 0) return vs_m_scanresult(__c, c, k, r, __n);
+
+    if (s) {
+        r = r || (m > (unsigned long long int)LLONG_MAX + 1);
+        *__o = r ? LLONG_MIN : (long long int)(0 - m);
+    }
+    else {
+        r = r || (m > LLONG_MAX);
+        *__o = r ? LLONG_MAX : (long long int)m;
+    }
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int lustrscannum(const char *__c, unsigned long int *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    unsigned long long int m = 0;
+    int s = 0;
+    int r = 0;
+    size_t k = vs_m_scanint(c, &m, &s, &r);
+
+    if (k == 0) return vs_m_scanresult(__c, c, k, r, __n);
+
+    r = r || (m > ULONG_MAX);
+    *__o = r ? ULONG_MAX : (s ? (unsigned long int)(0 - m) : (unsigned long int)m);
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
+int llustrscannum(const char *__c, unsigned long long int *__o, size_t *__n) {
+    const char *c = vs_m_skipspace(__c);
+    unsigned long long int m = 0;
+    int s = 0;
+    int r = 0;
+    size_t k = vs_m_scanint(c, &m, &s, &r);
+
+    if (k == 0) return vs_m_scanresult(__c, c, k, r, __n);
+
+    *__o = r ? ULLONG_MAX : (s ? (0 - m) : m);
+
+    return vs_m_scanresult(__c, c, k, r, __n);
+}
+
 #pragma mark String Validations
 
 int fstrisnumf(const char *__c) {
-    char *t;
-
-    strtof_l(__c, &t, LC_GLOBAL_LOCALE);
+    float o;
+    int r = fstrscannumf(__c, &o, NULL);
 
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int fstrisnum(const char *__c) {
-    char *t;
-
-    strtod_l(__c, &t, LC_GLOBAL_LOCALE);
+    double o;
+    int r = fstrscannum(__c, &o, NULL);
 
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int fstrisnuml(const char *__c) {
-    char *t;
+    long double o;
+    int r = fstrscannuml(__c, &o, NULL);
 
-    strtold_l(__c, &t, LC_GLOBAL_LOCALE);
-
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int lstrisnum(const char *__c) {
-    char *t;
-
-    strtol_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    long int o;
+    int r = lstrscannum(__c, &o, NULL);
 
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int llstrisnum(const char *__c) {
-    char *t;
-
-    strtoll_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    long long int o;
+    int r = llstrscannum(__c, &o, NULL);
 
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int lustrisnum(const char *__c) {
-    char *t;
+    unsigned long int o;
+    int r = lustrscannum(__c, &o, NULL);
 
-    strtoul_l(__c, &t, 0, LC_GLOBAL_LOCALE);
-
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 int llustrisnum(const char *__c) {
-    char *t;
-
-    strtoull_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    unsigned long long int o;
+    int r = llustrscannum(__c, &o, NULL);
 
-    return (*t == 0);
+    return ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE));
 }
 
 #pragma mark String Conversions
 
 float fstrtonumf(const char *__c) {
-    char *t;
-    float f = strtof_l(__c, &t, LC_GLOBAL_LOCALE);
+    float f;
+    int r = fstrscannumf(__c, &f, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return f;
     }
     else {
@@ -1342,10 +1752,10 @@ float fstrtonumf(const char *__c) {
 }
 
 double fstrtonum(const char *__c) {
-    char *t;
-    double d = strtod_l(__c, &t, LC_GLOBAL_LOCALE);
+    double d;
+    int r = fstrscannum(__c, &d, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return d;
     }
     else {
@@ -1354,10 +1764,10 @@ double fstrtonum(const char *__c) {
 }
 
 long double fstrtonuml(const char *__c) {
-    char *t;
-    long double ld = strtold_l(__c, &t, LC_GLOBAL_LOCALE);
+    long double ld;
+    int r = fstrscannuml(__c, &ld, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return ld;
     }
     else {
@@ -1366,10 +1776,10 @@ long double fstrtonuml(const char *__c) {
 }
 
 long int lstrtonum(const char *__c) {
-    char *t;
-    long int l = strtol_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    long int l;
+    int r = lstrscannum(__c, &l, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return l;
     }
     else {
@@ -1378,10 +1788,10 @@ long int lstrtonum(const char *__c) {
 }
 
 long long int llstrtonum(const char *__c) {
-    char *t;
-    long long int ll = strtoll_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    long long int ll;
+    int r = llstrscannum(__c, &ll, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return ll;
     }
     else {
@@ -1390,10 +1800,10 @@ long long int llstrtonum(const char *__c) {
 }
 
 unsigned long int lustrtonum(const char *__c) {
-    char *t;
-    unsigned long int ul = strtoul_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    unsigned long int ul;
+    int r = lustrscannum(__c, &ul, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return ul;
     }
     else {
@@ -1402,10 +1812,10 @@ unsigned long int lustrtonum(const char *__c) {
 }
 
 unsigned long long int llustrtonum(const char *__c) {
-    char *t;
-    unsigned long long int ull = strtoull_l(__c, &t, 0, LC_GLOBAL_LOCALE);
+    unsigned long long int ull;
+    int r = llustrscannum(__c, &ull, NULL);
 
-    if (*t == 0) {
+    if ((r == VS_M_SCAN_OK) || (r == VS_M_SCAN_ERANGE)) {
         return ull;
     }
     else {
@@ -11,6 +11,8 @@
 #ifndef vsmath_h
 #define vsmath_h
 
+#include <stddef.h>
+
 #define VS_M_ARC4RANDOM_MAX 0x100000000
 
 #define VS_M_BITS_PER_UNSIGNED_CHAR      (sizeof(unsigned char)*8)
@@ -28,6 +30,15 @@
 #define VS_M_BYTES_PER_DWORD 4
 #define VS_M_BYTES_PER_QWORD 8
 
+/**
+ *  Results of the string scanning functions: the string is a number, does not start with a number, has characters after the number, or
+ *  is a number out of the range of the type.
+ */
+#define VS_M_SCAN_OK     0
+#define VS_M_SCAN_EINVAL 1
+#define VS_M_SCAN_ETRAIL 2
+#define VS_M_SCAN_ERANGE 3
+
 #ifdef __OBJC__
 #define VS_M_SYMBOL_EQUAL                      @"="
 #define VS_M_SYMBOL_ADD                        @"+"
@@ -281,7 +292,8 @@ double fgtor(double __n);
 #pragma mark Trigonometric Functions
 
 /**
- *  Computes the sine of a float value in degrees.
+ *  Computes the sine of a float value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact.
  *
  *  @param __n
  *
@@ -290,7 +302,8 @@ double fgtor(double __n);
 float fsindf(float __n);
 
 /**
- *  Computes the sine of a double value in degrees.
+ *  Computes the sine of a double value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact.
  *
  *  @param __n
  *
@@ -299,7 +312,8 @@ float fsindf(float __n);
 double fsind(double __n);
 
 /**
- *  Computes the cosine of a float value in degrees.
+ *  Computes the cosine of a float value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact.
  *
  *  @param __n
  *
@@ -308,7 +322,8 @@ double fsind(double __n);
 float fcosdf(float __n);
 
 /**
- *  Computes the cosine of a double value in degrees.
+ *  Computes the cosine of a double value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact.
  *
  *  @param __n
  *
@@ -317,7 +332,8 @@ float fcosdf(float __n);
 double fcosd(double __n);
 
 /**
- *  Computes the tangent of a float value in degrees.
+ *  Computes the tangent of a float value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact and poles yield NAN.
  *
  *  @param __n
  *
@@ -326,7 +342,8 @@ double fcosd(double __n);
 float ftandf(float __n);
 
 /**
- *  Computes the tangent of a double value in degrees.
+ *  Computes the tangent of a double value in degrees. The angle is reduced modulo 360° before
+ *  conversion, so multiples of 30° and 45° are exact and poles yield NAN.
  *
  *  @param __n
  *
@@ -389,7 +406,8 @@ float ftanrf(float __n);
 double ftanr(double __n);
 
 /**
- *  Computes the sine of a float value in gradians.
+ *  Computes the sine of a float value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact.
  *
  *  @param __n
  *
@@ -398,7 +416,8 @@ double ftanr(double __n);
 float fsingf(float __n);
 
 /**
- *  Computes the sine of a double value in gradians.
+ *  Computes the sine of a double value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact.
  *
  *  @param __n
  *
@@ -407,7 +426,8 @@ float fsingf(float __n);
 double fsing(double __n);
 
 /**
- *  Computes the cosine of a float value in gradians.
+ *  Computes the cosine of a float value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact.
  *
  *  @param __n
  *
@@ -416,7 +436,8 @@ double fsing(double __n);
 float fcosgf(float __n);
 
 /**
- *  Computes the cosine of a double value in gradians.
+ *  Computes the cosine of a double value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact.
  *
  *  @param __n
  *
@@ -425,7 +446,8 @@ float fcosgf(float __n);
 double fcosg(double __n);
 
 /**
- *  Computes the tangent of a float value in gradians.
+ *  Computes the tangent of a float value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact and poles yield NAN.
  *
  *  @param __n
  *
@@ -434,7 +456,8 @@ double fcosg(double __n);
 float ftangf(float __n);
 
 /**
- *  Computes the tangent of a double value in gradians.
+ *  Computes the tangent of a double value in gradians. The angle is reduced modulo 400 gradians
+ *  before conversion, so multiples of 50 gradians are exact and poles yield NAN.
  *
  *  @param __n
  *
@@ -1067,10 +1090,102 @@ double fnorm(double __n);
  */
 int ndigits(int __n);
 
+#pragma mark String Scanning
+
+/**
+ *  Scans a string into a float value in a single pass, without locale. Leading whitespace is skipped, followed by an optionally
+ *  signed decimal number with an optional exponent, or nan, inf or infinity in any case (see vs_num_scan()). Hexadecimal floats are
+ *  not supported. The decimal is rounded directly to the nearest float, so results are identical on all platforms.
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int fstrscannumf(const char *__c, float *__o, size_t *__n);
+
+/**
+ *  Scans a string into a double value in a single pass, without locale. See fstrscannumf().
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int fstrscannum(const char *__c, double *__o, size_t *__n);
+
+/**
+ *  Scans a string into a long double value in a single pass, without locale. See fstrscannumf(). Where long double is wider than
+ *  double, the scanned digits are rounded by strtold() without their decimal separator, so that the locale does not matter.
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int fstrscannuml(const char *__c, long double *__o, size_t *__n);
+
+/**
+ *  Scans a string into a long int value in a single pass, without locale. Leading whitespace is skipped, followed by an optionally
+ *  signed integer in base 10, base 16 with a 0x or 0X prefix, or base 8 with a 0 prefix, like strtol() with base 0. Values out of
+ *  range are clamped to the range of the type.
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int lstrscannum(const char *__c, long int *__o, size_t *__n);
+
+/**
+ *  Scans a string into a long long int value in a single pass, without locale. See lstrscannum().
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int llstrscannum(const char *__c, long long int *__o, size_t *__n);
+
+/**
+ *  Scans a string into an unsigned long int value in a single pass, without locale. See lstrscannum(). Negative values are negated in
+ *  the unsigned type like strtoul().
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int lustrscannum(const char *__c, unsigned long int *__o, size_t *__n);
+
+/**
+ *  Scans a string into an unsigned long long int value in a single pass, without locale. See lustrscannum().
+ *
+ *  @param __c
+ *  @param __o Pointer to receive the scanned value if the string starts with a number.
+ *  @param __n Optional pointer to receive the number of bytes scanned, including leading whitespace, 0 if the string does not start
+ *             with a number.
+ *
+ *  @return VS_M_SCAN_OK, VS_M_SCAN_EINVAL, VS_M_SCAN_ETRAIL or VS_M_SCAN_ERANGE.
+ */
+int llustrscannum(const char *__c, unsigned long long int *__o, size_t *__n);
+
 #pragma mark String Validations
 
 /**
- *  Verifies that a string represents a float value.
+ *  Verifies that a string represents a float value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1079,7 +1194,7 @@ int ndigits(int __n);
 int fstrisnumf(const char *__c);
 
 /**
- *  Verifies that a string represents a double value.
+ *  Verifies that a string represents a double value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1088,7 +1203,7 @@ int fstrisnumf(const char *__c);
 int fstrisnum(const char *__c);
 
 /**
- *  Verifies that a string represents a long double value.
+ *  Verifies that a string represents a long double value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1097,7 +1212,7 @@ int fstrisnum(const char *__c);
 int fstrisnuml(const char *__c);
 
 /**
- *  Verifies that a string represents a long int value.
+ *  Verifies that a string represents a long int value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1106,7 +1221,7 @@ int fstrisnuml(const char *__c);
 int lstrisnum(const char *__c);
 
 /**
- *  Verifies that a string represents a long long int value.
+ *  Verifies that a string represents a long long int value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1115,7 +1230,7 @@ int lstrisnum(const char *__c);
 int llstrisnum(const char *__c);
 
 /**
- *  Verifies that a string represents an unsigned long int value.
+ *  Verifies that a string represents an unsigned long int value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
@@ -1124,7 +1239,7 @@ int llstrisnum(const char *__c);
 int lustrisnum(const char *__c);
 
 /**
- *  Verifies that a string represents an unsigned long long int value.
+ *  Verifies that a string represents an unsigned long long int value, which may be out of range (see the string scanning functions).
  *
  *  @param __c
  *
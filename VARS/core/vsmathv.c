@@ -0,0 +1,730 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <float.h>
+#import <math.h>
+#import <stdatomic.h>
+#import <stdint.h>
+#import <string.h>
+
+#if defined(__SSE2__)
+#import <immintrin.h>
+#define VS_V_SSE2 1
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VS_V_AVX2 1
+#endif
+#elif defined(__aarch64__) || defined(__arm64__)
+#import <arm_neon.h>
+#define VS_V_NEON 1
+#endif
+
+#import "vsmath.h"
+#import "vsmathv.h"
+
+/**
+ *  Operations of the integer kernels.
+ */
+#define VS_V_LSHIFT  0
+#define VS_V_RSHIFT  1
+#define VS_V_LROTATE 2
+#define VS_V_RROTATE 3
+
+/**
+ *  Primitive kernels of one instruction set. All array functions are composed of these.
+ */
+typedef struct {
+    int level;
+    void (*scale)(const double *__in, double *__out, size_t __n, double __k);
+    void (*snapsin)(double *__o, size_t __n);
+    void (*snapzero)(double *__o, size_t __n);
+    void (*bound)(const double *__in, double *__out, size_t __n, double __min, double __max);
+    void (*within)(const double *__in, int *__out, size_t __n, double __min, double __max);
+    void (*norm)(const double *__in, double *__out, size_t __n);
+    void (*u32)(const unsigned int *__in, unsigned int *__out, size_t __n, int __op);
+    void (*u64)(const unsigned long long *__in, unsigned long long *__out, size_t __n, int __op);
+} vs_v_kernels_t;
+
+#pragma mark Scalar Kernels
+
+static void vs_v_scale_scalar(const double *__in, double *__out, size_t __n, double __k) {
+    for (size_t j = 0; j < __n; j++) __out[j] = __in[j] * __k;
+}
+
+static void vs_v_snapsin_scalar(double *__o, size_t __n) {
+    for (size_t j = 0; j < __n; j++) {
+        double o = __o[j];
+
+        if ((1.0 - fabs(o)) < FLT_EPSILON) {
+            __o[j] = round(o);
+        }
+        else if (fabs(o) < FLT_EPSILON) {
+            __o[j] = 0.0;
+        }
+    }
+}
+
+static void vs_v_snapzero_scalar(double *__o, size_t __n) {
+    for (size_t j = 0; j < __n; j++) {
+        if (fabs(__o[j]) < FLT_EPSILON) __o[j] = 0.0;
+    }
+}
+
+static void vs_v_bound_scalar(const double *__in, double *__out, size_t __n, double __min, double __max) {
+    for (size_t j = 0; j < __n; j++) {
+        double n = __in[j];
+        __out[j] = (n < __min) ? __min : ((n > __max) ? __max : n);
+    }
+}
+
+static void vs_v_within_scalar(const double *__in, int *__out, size_t __n, double __min, double __max) {
+    for (size_t j = 0; j < __n; j++) {
+        __out[j] = ((__in[j] >= __min) && (__in[j] <= __max)) ? 1 : 0;
+    }
+}
+
+static void vs_v_norm_scalar(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) {
+        double n = __in[j];
+        double r = round(n);
+        __out[j] = (fabs(r - n) < DBL_EPSILON) ? r : n;
+    }
+}
+
+static void vs_v_u32_scalar(const unsigned int *__in, unsigned int *__out, size_t __n, int __op) {
+    switch (__op) {
+        case VS_V_LSHIFT:  for (size_t j = 0; j < __n; j++) __out[j] = (__in[j] << 1);                          break;
+        case VS_V_RSHIFT:  for (size_t j = 0; j < __n; j++) __out[j] = (__in[j] >> 1);                          break;
+        case VS_V_LROTATE: for (size_t j = 0; j < __n; j++) __out[j] = ((__in[j] << 1) | (__in[j] >> 31));      break;
+        case VS_V_RROTATE: for (size_t j = 0; j < __n; j++) __out[j] = ((__in[j] >> 1) | (__in[j] << 31));      break;
+    }
+}
+
+static void vs_v_u64_scalar(const unsigned long long *__in, unsigned long long *__out, size_t __n, int __op) {
+    switch (__op) {
+        case VS_V_LSHIFT:  for (size_t j = 0; j < __n; j++) __out[j] = (__in[j] << 1);                          break;
+        case VS_V_RSHIFT:  for (size_t j = 0; j < __n; j++) __out[j] = (__in[j] >> 1);                          break;
+        case VS_V_LROTATE: for (size_t j = 0; j < __n; j++) __out[j] = ((__in[j] << 1) | (__in[j] >> 63));      break;
+        case VS_V_RROTATE: for (size_t j = 0; j < __n; j++) __out[j] = ((__in[j] >> 1) | (__in[j] << 63));      break;
+    }
+}
+
+static const vs_v_kernels_t vs_v_kernels_scalar = {
+    VS_M_SIMD_SCALAR,
+    vs_v_scale_scalar,
+    vs_v_snapsin_scalar,
+    vs_v_snapzero_scalar,
+    vs_v_bound_scalar,
+    vs_v_within_scalar,
+    vs_v_norm_scalar,
+    vs_v_u32_scalar,
+    vs_v_u64_scalar
+};
+
+#if VS_V_SSE2
+
+#pragma mark SSE2 Kernels
+
+static void vs_v_scale_sse2(const double *__in, double *__out, size_t __n, double __k) {
+    __m128d k = _mm_set1_pd(__k);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) _mm_storeu_pd(__out + j, _mm_mul_pd(_mm_loadu_pd(__in + j), k));
+
+    vs_v_scale_scalar(__in + j, __out + j, __n - j, __k);
+}
+
+static void vs_v_snapsin_sse2(double *__o, size_t __n) {
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128d one = _mm_set1_pd(1.0);
+    __m128d eps = _mm_set1_pd(FLT_EPSILON);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        __m128d o = _mm_loadu_pd(__o + j);
+        __m128d a = _mm_andnot_pd(sign, o);
+        __m128d m1 = _mm_cmplt_pd(_mm_sub_pd(one, a), eps);
+        __m128d m0 = _mm_cmplt_pd(a, eps);
+        __m128d s = _mm_or_pd(_mm_and_pd(o, sign), one);
+
+        o = _mm_or_pd(_mm_and_pd(m1, s), _mm_andnot_pd(m1, o));
+        _mm_storeu_pd(__o + j, _mm_andnot_pd(m0, o));
+    }
+
+    vs_v_snapsin_scalar(__o + j, __n - j);
+}
+
+static void vs_v_snapzero_sse2(double *__o, size_t __n) {
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128d eps = _mm_set1_pd(FLT_EPSILON);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        __m128d o = _mm_loadu_pd(__o + j);
+        _mm_storeu_pd(__o + j, _mm_andnot_pd(_mm_cmplt_pd(_mm_andnot_pd(sign, o), eps), o));
+    }
+
+    vs_v_snapzero_scalar(__o + j, __n - j);
+}
+
+static void vs_v_bound_sse2(const double *__in, double *__out, size_t __n, double __min, double __max) {
+    __m128d min = _mm_set1_pd(__min);
+    __m128d max = _mm_set1_pd(__max);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        __m128d n = _mm_loadu_pd(__in + j);
+        __m128d mmax = _mm_cmpgt_pd(n, max);
+        __m128d mmin = _mm_cmplt_pd(n, min);
+
+        n = _mm_or_pd(_mm_and_pd(mmax, max), _mm_andnot_pd(mmax, n));
+        n = _mm_or_pd(_mm_and_pd(mmin, min), _mm_andnot_pd(mmin, n));
+        _mm_storeu_pd(__out + j, n);
+    }
+
+    vs_v_bound_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+static void vs_v_within_sse2(const double *__in, int *__out, size_t __n, double __min, double __max) {
+    __m128d min = _mm_set1_pd(__min);
+    __m128d max = _mm_set1_pd(__max);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        __m128d n = _mm_loadu_pd(__in + j);
+        int m = _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(n, min), _mm_cmple_pd(n, max)));
+
+        __out[j] = m & 1;
+        __out[j+1] = (m >> 1) & 1;
+    }
+
+    vs_v_within_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+static void vs_v_u32_sse2(const unsigned int *__in, unsigned int *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(__in + j));
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = _mm_slli_epi32(v, 1);                                         break;
+            case VS_V_RSHIFT:  v = _mm_srli_epi32(v, 1);                                         break;
+            case VS_V_LROTATE: v = _mm_or_si128(_mm_slli_epi32(v, 1), _mm_srli_epi32(v, 31));    break;
+            case VS_V_RROTATE: v = _mm_or_si128(_mm_srli_epi32(v, 1), _mm_slli_epi32(v, 31));    break;
+        }
+
+        _mm_storeu_si128((__m128i *)(__out + j), v);
+    }
+
+    vs_v_u32_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+static void vs_v_u64_sse2(const unsigned long long *__in, unsigned long long *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(__in + j));
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = _mm_slli_epi64(v, 1);                                         break;
+            case VS_V_RSHIFT:  v = _mm_srli_epi64(v, 1);                                         break;
+            case VS_V_LROTATE: v = _mm_or_si128(_mm_slli_epi64(v, 1), _mm_srli_epi64(v, 63));    break;
+            case VS_V_RROTATE: v = _mm_or_si128(_mm_srli_epi64(v, 1), _mm_slli_epi64(v, 63));    break;
+        }
+
+        _mm_storeu_si128((__m128i *)(__out + j), v);
+    }
+
+    vs_v_u64_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+// SSE2 has no rounding instruction, so normalization stays scalar.
+static const vs_v_kernels_t vs_v_kernels_sse2 = {
+    VS_M_SIMD_SSE2,
+    vs_v_scale_sse2,
+    vs_v_snapsin_sse2,
+    vs_v_snapzero_sse2,
+    vs_v_bound_sse2,
+    vs_v_within_sse2,
+    vs_v_norm_scalar,
+    vs_v_u32_sse2,
+    vs_v_u64_sse2
+};
+
+#endif // VS_V_SSE2
+
+#if VS_V_AVX2
+
+#pragma mark AVX2 Kernels
+
+#define VS_V_AVX2_TARGET __attribute__((target("avx2")))
+
+VS_V_AVX2_TARGET static void vs_v_scale_avx2(const double *__in, double *__out, size_t __n, double __k) {
+    __m256d k = _mm256_set1_pd(__k);
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) _mm256_storeu_pd(__out + j, _mm256_mul_pd(_mm256_loadu_pd(__in + j), k));
+
+    vs_v_scale_scalar(__in + j, __out + j, __n - j, __k);
+}
+
+VS_V_AVX2_TARGET static void vs_v_snapsin_avx2(double *__o, size_t __n) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d eps = _mm256_set1_pd(FLT_EPSILON);
+    __m256d zero = _mm256_setzero_pd();
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m256d o = _mm256_loadu_pd(__o + j);
+        __m256d a = _mm256_andnot_pd(sign, o);
+        __m256d m1 = _mm256_cmp_pd(_mm256_sub_pd(one, a), eps, _CMP_LT_OQ);
+        __m256d m0 = _mm256_cmp_pd(a, eps, _CMP_LT_OQ);
+        __m256d s = _mm256_or_pd(_mm256_and_pd(o, sign), one);
+
+        o = _mm256_blendv_pd(o, s, m1);
+        _mm256_storeu_pd(__o + j, _mm256_blendv_pd(o, zero, m0));
+    }
+
+    vs_v_snapsin_scalar(__o + j, __n - j);
+}
+
+VS_V_AVX2_TARGET static void vs_v_snapzero_avx2(double *__o, size_t __n) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d eps = _mm256_set1_pd(FLT_EPSILON);
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m256d o = _mm256_loadu_pd(__o + j);
+        _mm256_storeu_pd(__o + j, _mm256_andnot_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, o), eps, _CMP_LT_OQ), o));
+    }
+
+    vs_v_snapzero_scalar(__o + j, __n - j);
+}
+
+VS_V_AVX2_TARGET static void vs_v_bound_avx2(const double *__in, double *__out, size_t __n, double __min, double __max) {
+    __m256d min = _mm256_set1_pd(__min);
+    __m256d max = _mm256_set1_pd(__max);
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m256d n = _mm256_loadu_pd(__in + j);
+        __m256d mmax = _mm256_cmp_pd(n, max, _CMP_GT_OQ);
+        __m256d mmin = _mm256_cmp_pd(n, min, _CMP_LT_OQ);
+
+        n = _mm256_blendv_pd(n, max, mmax);
+        _mm256_storeu_pd(__out + j, _mm256_blendv_pd(n, min, mmin));
+    }
+
+    vs_v_bound_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+VS_V_AVX2_TARGET static void vs_v_within_avx2(const double *__in, int *__out, size_t __n, double __min, double __max) {
+    __m256d min = _mm256_set1_pd(__min);
+    __m256d max = _mm256_set1_pd(__max);
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m256d n = _mm256_loadu_pd(__in + j);
+        int m = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(n, min, _CMP_GE_OQ), _mm256_cmp_pd(n, max, _CMP_LE_OQ)));
+
+        __out[j] = m & 1;
+        __out[j+1] = (m >> 1) & 1;
+        __out[j+2] = (m >> 2) & 1;
+        __out[j+3] = (m >> 3) & 1;
+    }
+
+    vs_v_within_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+VS_V_AVX2_TARGET static void vs_v_norm_avx2(const double *__in, double *__out, size_t __n) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d eps = _mm256_set1_pd(DBL_EPSILON);
+    size_t j = 0;
+
+    // Rounds half to even rather than away from zero, which only differs on ties, and ties are never within epsilon anyway.
+    for (; j + 4 <= __n; j += 4) {
+        __m256d n = _mm256_loadu_pd(__in + j);
+        __m256d r = _mm256_round_pd(n, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d m = _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(r, n)), eps, _CMP_LT_OQ);
+
+        _mm256_storeu_pd(__out + j, _mm256_blendv_pd(n, r, m));
+    }
+
+    vs_v_norm_scalar(__in + j, __out + j, __n - j);
+}
+
+VS_V_AVX2_TARGET static void vs_v_u32_avx2(const unsigned int *__in, unsigned int *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 8 <= __n; j += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(__in + j));
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = _mm256_slli_epi32(v, 1);                                              break;
+            case VS_V_RSHIFT:  v = _mm256_srli_epi32(v, 1);                                              break;
+            case VS_V_LROTATE: v = _mm256_or_si256(_mm256_slli_epi32(v, 1), _mm256_srli_epi32(v, 31));   break;
+            case VS_V_RROTATE: v = _mm256_or_si256(_mm256_srli_epi32(v, 1), _mm256_slli_epi32(v, 31));   break;
+        }
+
+        _mm256_storeu_si256((__m256i *)(__out + j), v);
+    }
+
+    vs_v_u32_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+VS_V_AVX2_TARGET static void vs_v_u64_avx2(const unsigned long long *__in, unsigned long long *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(__in + j));
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = _mm256_slli_epi64(v, 1);                                              break;
+            case VS_V_RSHIFT:  v = _mm256_srli_epi64(v, 1);                                              break;
+            case VS_V_LROTATE: v = _mm256_or_si256(_mm256_slli_epi64(v, 1), _mm256_srli_epi64(v, 63));   break;
+            case VS_V_RROTATE: v = _mm256_or_si256(_mm256_srli_epi64(v, 1), _mm256_slli_epi64(v, 63));   break;
+        }
+
+        _mm256_storeu_si256((__m256i *)(__out + j), v);
+    }
+
+    vs_v_u64_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+static const vs_v_kernels_t vs_v_kernels_avx2 = {
+    VS_M_SIMD_AVX2,
+    vs_v_scale_avx2,
+    vs_v_snapsin_avx2,
+    vs_v_snapzero_avx2,
+    vs_v_bound_avx2,
+    vs_v_within_avx2,
+    vs_v_norm_avx2,
+    vs_v_u32_avx2,
+    vs_v_u64_avx2
+};
+
+#endif // VS_V_AVX2
+
+#if VS_V_NEON
+
+#pragma mark NEON Kernels
+
+static void vs_v_scale_neon(const double *__in, double *__out, size_t __n, double __k) {
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) vst1q_f64(__out + j, vmulq_n_f64(vld1q_f64(__in + j), __k));
+
+    vs_v_scale_scalar(__in + j, __out + j, __n - j, __k);
+}
+
+static void vs_v_snapsin_neon(double *__o, size_t __n) {
+    float64x2_t one = vdupq_n_f64(1.0);
+    float64x2_t eps = vdupq_n_f64(FLT_EPSILON);
+    float64x2_t zero = vdupq_n_f64(0.0);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        float64x2_t o = vld1q_f64(__o + j);
+        float64x2_t a = vabsq_f64(o);
+        uint64x2_t m1 = vcltq_f64(vsubq_f64(one, a), eps);
+        uint64x2_t m0 = vcltq_f64(a, eps);
+        float64x2_t s = vbslq_f64(vdupq_n_u64(0x8000000000000000ULL), o, one);
+
+        o = vbslq_f64(m1, s, o);
+        vst1q_f64(__o + j, vbslq_f64(m0, zero, o));
+    }
+
+    vs_v_snapsin_scalar(__o + j, __n - j);
+}
+
+static void vs_v_snapzero_neon(double *__o, size_t __n) {
+    float64x2_t eps = vdupq_n_f64(FLT_EPSILON);
+    float64x2_t zero = vdupq_n_f64(0.0);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        float64x2_t o = vld1q_f64(__o + j);
+        vst1q_f64(__o + j, vbslq_f64(vcltq_f64(vabsq_f64(o), eps), zero, o));
+    }
+
+    vs_v_snapzero_scalar(__o + j, __n - j);
+}
+
+static void vs_v_bound_neon(const double *__in, double *__out, size_t __n, double __min, double __max) {
+    float64x2_t min = vdupq_n_f64(__min);
+    float64x2_t max = vdupq_n_f64(__max);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        float64x2_t n = vld1q_f64(__in + j);
+        uint64x2_t mmax = vcgtq_f64(n, max);
+        uint64x2_t mmin = vcltq_f64(n, min);
+
+        n = vbslq_f64(mmax, max, n);
+        vst1q_f64(__out + j, vbslq_f64(mmin, min, n));
+    }
+
+    vs_v_bound_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+static void vs_v_within_neon(const double *__in, int *__out, size_t __n, double __min, double __max) {
+    float64x2_t min = vdupq_n_f64(__min);
+    float64x2_t max = vdupq_n_f64(__max);
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        float64x2_t n = vld1q_f64(__in + j);
+        uint64x2_t m = vandq_u64(vcgeq_f64(n, min), vcleq_f64(n, max));
+
+        __out[j] = (int)(vgetq_lane_u64(m, 0) & 1);
+        __out[j+1] = (int)(vgetq_lane_u64(m, 1) & 1);
+    }
+
+    vs_v_within_scalar(__in + j, __out + j, __n - j, __min, __max);
+}
+
+static void vs_v_norm_neon(const double *__in, double *__out, size_t __n) {
+    float64x2_t eps = vdupq_n_f64(DBL_EPSILON);
+    size_t j = 0;
+
+    // vrndaq rounds half away from zero, exactly like round().
+    for (; j + 2 <= __n; j += 2) {
+        float64x2_t n = vld1q_f64(__in + j);
+        float64x2_t r = vrndaq_f64(n);
+
+        vst1q_f64(__out + j, vbslq_f64(vcltq_f64(vabdq_f64(r, n), eps), r, n));
+    }
+
+    vs_v_norm_scalar(__in + j, __out + j, __n - j);
+}
+
+static void vs_v_u32_neon(const unsigned int *__in, unsigned int *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 4 <= __n; j += 4) {
+        uint32x4_t v = vld1q_u32(__in + j);
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = vshlq_n_u32(v, 1);                                break;
+            case VS_V_RSHIFT:  v = vshrq_n_u32(v, 1);                                break;
+            case VS_V_LROTATE: v = vorrq_u32(vshlq_n_u32(v, 1), vshrq_n_u32(v, 31)); break;
+            case VS_V_RROTATE: v = vorrq_u32(vshrq_n_u32(v, 1), vshlq_n_u32(v, 31)); break;
+        }
+
+        vst1q_u32(__out + j, v);
+    }
+
+    vs_v_u32_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+static void vs_v_u64_neon(const unsigned long long *__in, unsigned long long *__out, size_t __n, int __op) {
+    size_t j = 0;
+
+    for (; j + 2 <= __n; j += 2) {
+        uint64x2_t v = vld1q_u64((const uint64_t *)(__in + j));
+
+        switch (__op) {
+            case VS_V_LSHIFT:  v = vshlq_n_u64(v, 1);                                break;
+            case VS_V_RSHIFT:  v = vshrq_n_u64(v, 1);                                break;
+            case VS_V_LROTATE: v = vorrq_u64(vshlq_n_u64(v, 1), vshrq_n_u64(v, 63)); break;
+            case VS_V_RROTATE: v = vorrq_u64(vshrq_n_u64(v, 1), vshlq_n_u64(v, 63)); break;
+        }
+
+        vst1q_u64((uint64_t *)(__out + j), v);
+    }
+
+    vs_v_u64_scalar(__in + j, __out + j, __n - j, __op);
+}
+
+static const vs_v_kernels_t vs_v_kernels_neon = {
+    VS_M_SIMD_NEON,
+    vs_v_scale_neon,
+    vs_v_snapsin_neon,
+    vs_v_snapzero_neon,
+    vs_v_bound_neon,
+    vs_v_within_neon,
+    vs_v_norm_neon,
+    vs_v_u32_neon,
+    vs_v_u64_neon
+};
+
+#endif // VS_V_NEON
+
+#pragma mark Dispatch
+
+/**
+ *  Gets the kernels of the fastest instruction set supported by the running CPU. The selection is published with release semantics
+ *  and read with acquire semantics, so concurrent first calls may each select the kernels, but they all store the same pointer.
+ *
+ *  @return The selected kernels.
+ */
+static const vs_v_kernels_t *vs_v_kernels(void) {
+    static const vs_v_kernels_t *_Atomic kernels = NULL;
+    const vs_v_kernels_t *loaded = atomic_load_explicit(&kernels, memory_order_acquire);
+
+    if (loaded != NULL) return loaded;
+
+    const vs_v_kernels_t *selected = &vs_v_kernels_scalar;
+
+#if VS_V_SSE2
+    selected = &vs_v_kernels_sse2;
+#elif VS_V_NEON
+    selected = &vs_v_kernels_neon;
+#endif
+
+#if VS_V_AVX2
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) selected = &vs_v_kernels_avx2;
+#endif
+
+    atomic_store_explicit(&kernels, selected, memory_order_release);
+
+    return selected;
+}
+
+#pragma mark Instruction Sets
+
+int simdlevel(void) {
+    return vs_v_kernels()->level;
+}
+
+#pragma mark Angle Conversions
+
+void fdtor_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (M_PI/180.0));
+}
+
+void fdtog_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (10.0/9.0));
+}
+
+void frtod_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (180.0/M_PI));
+}
+
+void frtog_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (200.0/M_PI));
+}
+
+void fgtod_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (9.0/10.0));
+}
+
+void fgtor_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->scale(__in, __out, __n, (M_PI/200.0));
+}
+
+#pragma mark Trigonometric Functions
+
+void fsind_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = fsind(__in[j]);
+}
+
+void fcosd_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = fcosd(__in[j]);
+}
+
+void ftand_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = ftand(__in[j]);
+}
+
+void fsinr_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = sin(__in[j]);
+
+    vs_v_kernels()->snapsin(__out, __n);
+}
+
+void fcosr_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = cos(__in[j]);
+
+    vs_v_kernels()->snapzero(__out, __n);
+}
+
+void ftanr_v(const double *__in, double *__out, size_t __n) {
+    // Poles are where the snapped cosine is 0, same as ftanr().
+    for (size_t j = 0; j < __n; j++) {
+        double n = __in[j];
+        __out[j] = (fabs(cos(n)) < FLT_EPSILON) ? NAN : tan(n);
+    }
+
+    vs_v_kernels()->snapzero(__out, __n);
+}
+
+void fsing_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = fsing(__in[j]);
+}
+
+void fcosg_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = fcosg(__in[j]);
+}
+
+void ftang_v(const double *__in, double *__out, size_t __n) {
+    for (size_t j = 0; j < __n; j++) __out[j] = ftang(__in[j]);
+}
+
+#pragma mark Bit Shifting
+
+void ulshift_v(const unsigned int *__in, unsigned int *__out, size_t __n) {
+    vs_v_kernels()->u32(__in, __out, __n, VS_V_LSHIFT);
+}
+
+void urshift_v(const unsigned int *__in, unsigned int *__out, size_t __n) {
+    vs_v_kernels()->u32(__in, __out, __n, VS_V_RSHIFT);
+}
+
+void ulrotate_v(const unsigned int *__in, unsigned int *__out, size_t __n) {
+    vs_v_kernels()->u32(__in, __out, __n, VS_V_LROTATE);
+}
+
+void urrotate_v(const unsigned int *__in, unsigned int *__out, size_t __n) {
+    vs_v_kernels()->u32(__in, __out, __n, VS_V_RROTATE);
+}
+
+void llulshift_v(const unsigned long long *__in, unsigned long long *__out, size_t __n) {
+    vs_v_kernels()->u64(__in, __out, __n, VS_V_LSHIFT);
+}
+
+void llurshift_v(const unsigned long long *__in, unsigned long long *__out, size_t __n) {
+    vs_v_kernels()->u64(__in, __out, __n, VS_V_RSHIFT);
+}
+
+void llulrotate_v(const unsigned long long *__in, unsigned long long *__out, size_t __n) {
+    vs_v_kernels()->u64(__in, __out, __n, VS_V_LROTATE);
+}
+
+void llurrotate_v(const unsigned long long *__in, unsigned long long *__out, size_t __n) {
+    vs_v_kernels()->u64(__in, __out, __n, VS_V_RROTATE);
+}
+
+#pragma mark Number Moderations
+
+void fbound_v(const double *__in, double *__out, size_t __n, double __min, double __max) {
+    // NAN bounds are ignored, which infinite bounds achieve without a per-element check.
+    if (isnan(__min)) __min = -INFINITY;
+    if (isnan(__max)) __max = INFINITY;
+
+    vs_v_kernels()->bound(__in, __out, __n, __min, __max);
+}
+
+void fisbounded_v(const double *__in, int *__out, size_t __n, double __min, double __max) {
+    if ((__max < __min) || (isnan(__max) && isnan(__min))) {
+        memset(__out, 0, sizeof(int) * __n);
+        return;
+    }
+
+    if (isnan(__min)) __min = -INFINITY;
+    if (isnan(__max)) __max = INFINITY;
+
+    vs_v_kernels()->within(__in, __out, __n, __min, __max);
+}
+
+void fnorm_v(const double *__in, double *__out, size_t __n) {
+    vs_v_kernels()->norm(__in, __out, __n);
+}
@@ -0,0 +1,287 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS vectorized math tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vsmathv_h
+#define vsmathv_h
+
+#include <stddef.h>
+
+#define VS_M_SIMD_SCALAR 0
+#define VS_M_SIMD_SSE2   1
+#define VS_M_SIMD_AVX2   2
+#define VS_M_SIMD_NEON   3
+
+/**
+ *  Array counterparts of the vsmath scalar kernels. Each function produces exactly the same values as calling its scalar counterpart
+ *  on every element. Input and output arrays may be the same array, but must not otherwise overlap. The fastest instruction set
+ *  available (AVX2, SSE2 or NEON) is selected at runtime on first use, with a scalar fallback on all other architectures.
+ *
+ *  Only the angle conversions, bounds, normalization, bit shifts and rotations, and the snapping of radian trigonometric results use
+ *  SIMD instructions. The trigonometric functions still compute each element with libm, as no vectorized sine or cosine rounds like it
+ *  does: the degree and gradian variants call their exact scalar kernels (range reduction included) in a loop, and the radian ones
+ *  vectorize nothing but the snapping. See vsfmath.h for vectorized approximations.
+ */
+
+#pragma mark Instruction Sets
+
+/**
+ *  Gets the instruction set used by the array kernels.
+ *
+ *  @return VS_M_SIMD_SCALAR, VS_M_SIMD_SSE2, VS_M_SIMD_AVX2 or VS_M_SIMD_NEON.
+ */
+int simdlevel(void);
+
+#pragma mark Angle Conversions
+
+/**
+ *  Converts an array of double values in degrees to radians.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fdtor_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Converts an array of double values in degrees to gradians.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fdtog_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Converts an array of double values in radians to degrees.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void frtod_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Converts an array of double values in radians to gradians.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void frtog_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Converts an array of double values in gradians to degrees.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fgtod_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Converts an array of double values in gradians to radians.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fgtor_v(const double *__in, double *__out, size_t __n);
+
+#pragma mark Trigonometric Functions
+
+/**
+ *  Computes the sine of an array of double values in degrees, calling fsind() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fsind_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the cosine of an array of double values in degrees, calling fcosd() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fcosd_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the tangent of an array of double values in degrees, calling ftand() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void ftand_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the sine of an array of double values in radians. Only the snapping near 0 and ±1 is vectorized.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fsinr_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the cosine of an array of double values in radians. Only the snapping near 0 is vectorized.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fcosr_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the tangent of an array of double values in radians.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void ftanr_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the sine of an array of double values in gradians, calling fsing() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fsing_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the cosine of an array of double values in gradians, calling fcosg() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fcosg_v(const double *__in, double *__out, size_t __n);
+
+/**
+ *  Computes the tangent of an array of double values in gradians, calling ftang() on each element.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void ftang_v(const double *__in, double *__out, size_t __n);
+
+#pragma mark Bit Shifting
+
+/**
+ *  Left shifts an array of unsigned int values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void ulshift_v(const unsigned int *__in, unsigned int *__out, size_t __n);
+
+/**
+ *  Right shifts an array of unsigned int values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void urshift_v(const unsigned int *__in, unsigned int *__out, size_t __n);
+
+/**
+ *  Left rotates an array of unsigned int values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void ulrotate_v(const unsigned int *__in, unsigned int *__out, size_t __n);
+
+/**
+ *  Right rotates an array of unsigned int values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void urrotate_v(const unsigned int *__in, unsigned int *__out, size_t __n);
+
+/**
+ *  Left shifts an array of unsigned long long values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void llulshift_v(const unsigned long long *__in, unsigned long long *__out, size_t __n);
+
+/**
+ *  Right shifts an array of unsigned long long values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void llurshift_v(const unsigned long long *__in, unsigned long long *__out, size_t __n);
+
+/**
+ *  Left rotates an array of unsigned long long values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void llulrotate_v(const unsigned long long *__in, unsigned long long *__out, size_t __n);
+
+/**
+ *  Right rotates an array of unsigned long long values.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void llurrotate_v(const unsigned long long *__in, unsigned long long *__out, size_t __n);
+
+#pragma mark Number Moderations
+
+/**
+ *  Moderates an array of double values to the specified bounds, inclusive. A NAN bound is ignored.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ *  @param __min
+ *  @param __max
+ */
+void fbound_v(const double *__in, double *__out, size_t __n, double __min, double __max);
+
+/**
+ *  Verifies that each double value of an array is within the specified bounds, inclusive.
+ *
+ *  @param __in
+ *  @param __out Receives 1 for every bounded value, 0 otherwise.
+ *  @param __n
+ *  @param __min
+ *  @param __max
+ */
+void fisbounded_v(const double *__in, int *__out, size_t __n, double __min, double __max);
+
+/**
+ *  Normalizes an array of double values, checking against epsilon.
+ *
+ *  @param __in
+ *  @param __out
+ *  @param __n
+ */
+void fnorm_v(const double *__in, double *__out, size_t __n);
+
+#endif
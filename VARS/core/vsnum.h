@@ -0,0 +1,155 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  VARS number conversion tools.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef vsnum_h
+#define vsnum_h
+
+#include <stddef.h>
+
+/**
+ *  Separators of the default locale (en_US), matching +[VSNumberUtil globalNumberFormatterWithDefaultLocale].
+ */
+#define VS_NUM_DECIMAL_SEPARATOR  "."
+#define VS_NUM_GROUPING_SEPARATOR ","
+
+/**
+ *  Default symbols of vs_num_format(), matching %g.
+ */
+#define VS_NUM_EXPONENT_SYMBOL "e"
+#define VS_NUM_NAN_SYMBOL      "nan"
+
+/**
+ *  Size of a buffer which holds any double formatted by vs_num_format() with the default symbols, including the null character.
+ */
+#define VS_NUM_FORMAT_SIZE 32
+
+/**
+ *  Size of a buffer which holds any 64-bit integer formatted by vs_num_formatu() without grouping, including the null character.
+ */
+#define VS_NUM_FORMATU_SIZE 65
+
+/**
+ *  Max number of significant digits read by vs_num_parse() and vs_num_scan(). Digits past this many only matter as to whether they are
+ *  all 0, which is enough to round any decimal correctly.
+ */
+#define VS_NUM_MAX_DIGITS 768
+
+#pragma mark Parsing
+
+/**
+ *  Parses a decimal number into the nearest double value (round half to even) in a single pass, without locale and without allocating
+ *  memory. The whole string must be an optionally signed decimal mantissa of at least one digit, with at most one decimal separator,
+ *  followed by an optional exponent (e or E, an optional sign and at least one digit), or nan, inf or infinity in any case. Grouping
+ *  separators are ignored anywhere in the mantissa. Mantissas of up to 19 significant digits are rounded with the Eisel-Lemire
+ *  algorithm over a table of 128-bit powers of 5, or exactly in double arithmetic when the mantissa and the power of 10 are both exact
+ *  doubles. Longer mantissas which the algorithm cannot round from their first 19 digits are rounded by comparing them with the
+ *  halfway point between both candidate doubles in big integer arithmetic.
+ *
+ *  @param __c UTF-8 string, not necessarily null-terminated.
+ *  @param __n Length of the string in bytes.
+ *  @param __d UTF-8 decimal separator, VS_NUM_DECIMAL_SEPARATOR if NULL.
+ *  @param __g UTF-8 grouping separator, NULL or empty if none.
+ *  @param __v Pointer to receive the parsed value, left untouched if the string is not a number.
+ *
+ *  @return 1 if the string is a number, 0 otherwise.
+ */
+int vs_num_parse(const char *__c, size_t __n, const char *__d, const char *__g, double *__v);
+
+#pragma mark Scanning
+
+/**
+ *  Scans the longest decimal number at the start of a string into the nearest double value, with the syntax and rounding of
+ *  vs_num_parse(). Leading whitespace is not skipped.
+ *
+ *  @param __c UTF-8 string, not necessarily null-terminated.
+ *  @param __n Length of the string in bytes.
+ *  @param __d UTF-8 decimal separator, VS_NUM_DECIMAL_SEPARATOR if NULL.
+ *  @param __g UTF-8 grouping separator, NULL or empty if none.
+ *  @param __v Pointer to receive the scanned value, left untouched if the string does not start with a number.
+ *  @param __r Optional pointer to receive 1 if a number with nonzero digits rounds to infinity or to 0, 0 otherwise.
+ *
+ *  @return The number of bytes scanned, 0 if the string does not start with a number.
+ */
+size_t vs_num_scan(const char *__c, size_t __n, const char *__d, const char *__g, double *__v, int *__r);
+
+/**
+ *  Scans the longest decimal number at the start of a string into the nearest float value, rounding the decimal once rather than through
+ *  a double. See vs_num_scan().
+ *
+ *  @param __c UTF-8 string, not necessarily null-terminated.
+ *  @param __n Length of the string in bytes.
+ *  @param __d UTF-8 decimal separator, VS_NUM_DECIMAL_SEPARATOR if NULL.
+ *  @param __g UTF-8 grouping separator, NULL or empty if none.
+ *  @param __v Pointer to receive the scanned value, left untouched if the string does not start with a number.
+ *  @param __r Optional pointer to receive 1 if a number with nonzero digits rounds to infinity or to 0, 0 otherwise.
+ *
+ *  @return The number of bytes scanned, 0 if the string does not start with a number.
+ */
+size_t vs_num_scanf(const char *__c, size_t __n, const char *__d, const char *__g, float *__v, int *__r);
+
+#pragma mark Formatting
+
+/**
+ *  Formats a double into the shortest decimal which parses back to the same double, with the Ryu algorithm and without locale. If that
+ *  decimal has more than __p significant digits, the double is rounded to __p digits instead like %.*g, so a precision of 16 shows
+ *  0.1 + 0.2 as 0.3 while a precision of 0 shows it as 0.30000000000000004. The layout is that of %g: scientific notation with a signed
+ *  exponent of at least 2 digits if the decimal exponent is less than -4 or at least the precision (17 if 0), fixed notation without
+ *  trailing zeros otherwise. Infinities are inf or -inf. The symbols are written in place, so the output never needs a second pass.
+ *
+ *  @param __v
+ *  @param __p   Max number of significant digits, from 1 to 17, or 0 for the shortest round trip decimal.
+ *  @param __e   UTF-8 exponent symbol, VS_NUM_EXPONENT_SYMBOL if NULL.
+ *  @param __nan UTF-8 NAN symbol, VS_NUM_NAN_SYMBOL if NULL.
+ *  @param __o   Buffer to receive the null-terminated string, truncated if too small (see VS_NUM_FORMAT_SIZE).
+ *  @param __n   Size of the buffer in bytes.
+ *
+ *  @return The length of the whole string, excluding the null character, like snprintf().
+ */
+size_t vs_num_format(double __v, int __p, const char *__e, const char *__nan, char *__o, size_t __n);
+
+#pragma mark Radix Formatting
+
+/**
+ *  Formats an unsigned integer in a radix from 2 to 36, without prefix, without leading zeros and without locale, digits above 9 being
+ *  uppercase like %X. Digits are written right to left into a stack buffer in a single pass, radices which are powers of 2 with shifts
+ *  and masks sized from the count of leading zero bits, so the cost is linear in the number of digits. Digits can be grouped from the
+ *  least significant one, i.e. 1010 1100 in binary with groups of 4 or FFFF_FFFF in hexadecimal with groups of 4.
+ *
+ *  @param __v
+ *  @param __b Radix, from 2 to 36, 10 if out of range.
+ *  @param __g Number of digits per group, 0 for no grouping.
+ *  @param __s UTF-8 grouping separator, NULL or empty if none.
+ *  @param __o Buffer to receive the null-terminated string, truncated if too small (see VS_NUM_FORMATU_SIZE).
+ *  @param __n Size of the buffer in bytes.
+ *
+ *  @return The length of the whole string, excluding the null character, like snprintf().
+ */
+size_t vs_num_formatu(unsigned long long __v, unsigned int __b, unsigned int __g, const char *__s, char *__o, size_t __n);
+
+/**
+ *  Formats an array of unsigned integers into a single buffer like vs_num_formatu(), separated by a delimiter.
+ *
+ *  @param __v
+ *  @param __m Number of values.
+ *  @param __b Radix, from 2 to 36, 10 if out of range.
+ *  @param __g Number of digits per group, 0 for no grouping.
+ *  @param __s UTF-8 grouping separator, NULL or empty if none.
+ *  @param __d UTF-8 delimiter between values, NULL or empty if none.
+ *  @param __o Buffer to receive the null-terminated string, truncated if too small.
+ *  @param __n Size of the buffer in bytes.
+ *  @param __k Optional array of __m + 1 byte offsets to receive the start of each value, followed by the length of the whole string,
+ *             whether or not it fits in the buffer.
+ *
+ *  @return The length of the whole string, excluding the null character, like snprintf().
+ */
+size_t vs_num_formatuv(const unsigned long long *__v, size_t __m, unsigned int __b, unsigned int __g, const char *__s, const char *__d,
+                       char *__o, size_t __n, size_t *__k);
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  Math expression compiled once into a flat instruction array for repeated evaluation.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "VSMathUtil.h"
+
+/**
+ *  Enums of all compiled expression evaluation statuses.
+ */
+typedef NS_ENUM(int, VSCompiledExpressionStatusType) {
+    VSCompiledExpressionStatusTypeUnknown = -1,
+    VSCompiledExpressionStatusTypeSuccess,
+    VSCompiledExpressionStatusTypeUnboundVariable,
+    VSCompiledExpressionStatusTypeMaxTypes
+};
+
+/**
+ *  Translates VSCompiledExpressionStatusType to string.
+ *
+ *  @param type
+ *
+ *  @return NSString equivalent of the specified VSCompiledExpressionStatusType.
+ */
+NSString *NSStringFromVSCompiledExpressionStatusType(VSCompiledExpressionStatusType type);
+
+#pragma mark -
+
+/**
+ *  Immutable math expression which is parsed and validated once, then evaluated on raw double values without re-classifying tokens or
+ *  boxing intermediates. Variable slot 0 is always the x variable and slot 1 is always the y variable. Custom variables (tokens found in
+ *  custom variable sets) follow in the order of their first appearance. Identical subexpressions are compiled into a single one which
+ *  is evaluated once per evaluation (see vs_expr_share()).
+ */
+@interface VSCompiledExpression : NSObject
+
+#pragma mark Properties
+
+/**
+ *  Angle mode used by trigonometric operations of this expression.
+ */
+@property (nonatomic, readonly) VSMathAngleModeType angleMode;
+
+/**
+ *  Evaluation options of this expression, VSMathEvaluationOptionNone by default. Options are fixed at compilation, see
+ *  VSCompiledExpression::compiledExpressionWithPostfixStack:angleMode:options:.
+ */
+@property (nonatomic, readonly) VSMathEvaluationOptions options;
+
+/**
+ *  Names of all variable slots, indexed by slot.
+ */
+@property (nonatomic, readonly) NSArray *variableNames;
+
+/**
+ *  Number of variable slots.
+ */
+@property (nonatomic, readonly) NSUInteger numberOfVariables;
+
+#pragma mark Instantiation
+
+/**
+ *  Compiles the given infix math expression.
+ *
+ *  @param infixExpression
+ *  @param angleMode
+ *
+ *  @return VSCompiledExpression instance, nil if the expression cannot be parsed or contains syntax errors.
+ */
++ (instancetype)compiledExpressionWithInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode;
+
+/**
+ *  Compiles the given infix math expression with the option to specify custom variable sets.
+ *
+ *  @param infixExpression
+ *  @param angleMode
+ *  @param customVariableSets
+ *
+ *  @return VSCompiledExpression instance, nil if the expression cannot be parsed or contains syntax errors.
+ */
++ (instancetype)compiledExpressionWithInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode customVariableSets:(NSArray *)customVariableSets;
+
+/**
+ *  Compiles the given math expression in postfix notation (i.e. the output of postfixStackFromInfixExpression:).
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *
+ *  @return VSCompiledExpression instance, nil if the postfix stack is empty or contains syntax errors.
+ */
++ (instancetype)compiledExpressionWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode;
+
+/**
+ *  Compiles the given math expression in postfix notation with the specified evaluation options. If the options contain
+ *  VSMathEvaluationOptionStrengthReduction, costly operations are rewritten into cheaper ones once compiled (see vs_expr_reduce()).
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param options
+ *
+ *  @return VSCompiledExpression instance, nil if the postfix stack is empty or contains syntax errors.
+ */
++ (instancetype)compiledExpressionWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode options:(VSMathEvaluationOptions)options;
+
+/**
+ *  Initializes a compiled expression from the given math expression in postfix notation.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *
+ *  @return VSCompiledExpression instance, nil if the postfix stack is empty or contains syntax errors.
+ */
+- (instancetype)initWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode;
+
+/**
+ *  Initializes a compiled expression from the given math expression in postfix notation with the specified evaluation options. See
+ *  VSCompiledExpression::compiledExpressionWithPostfixStack:angleMode:options:.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param options
+ *
+ *  @return VSCompiledExpression instance, nil if the postfix stack is empty or contains syntax errors.
+ */
+- (instancetype)initWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode options:(VSMathEvaluationOptions)options;
+
+#pragma mark Variables
+
+/**
+ *  Gets the slot of the specified variable.
+ *
+ *  @param variableName
+ *
+ *  @return The slot index, NSNotFound if the variable does not exist in this expression.
+ */
+- (NSUInteger)slotOfVariable:(NSString *)variableName;
+
+#pragma mark Evaluation
+
+/**
+ *  Evaluates the expression with the x and y variables. Custom variables are reported as unbound. This method does not allocate memory.
+ *
+ *  @param x
+ *  @param y
+ *  @param status Optional pointer to receive the evaluation status.
+ *
+ *  @return The evaluated double value, NAN if evaluation failed.
+ */
+- (double)evaluateWithX:(double)x y:(double)y status:(VSCompiledExpressionStatusType *)status;
+
+/**
+ *  Evaluates the expression with the specified variable values, indexed by slot. The x and y variables evaluate to NAN when their slots
+ *  are not provided, whereas missing custom variables fail with VSCompiledExpressionStatusTypeUnboundVariable, mirroring the token map
+ *  behavior of evaluatePostfixStack:angleMode:tokenMap:. This method does not allocate memory.
+ *
+ *  @param variables Variable values indexed by slot, may be NULL if count is 0.
+ *  @param count     Number of values in variables.
+ *  @param status    Optional pointer to receive the evaluation status.
+ *
+ *  @return The evaluated double value, NAN if evaluation failed.
+ */
+- (double)evaluateWithVariables:(const double *)variables count:(NSUInteger)count status:(VSCompiledExpressionStatusType *)status;
+
+/**
+ *  Evaluates the expression over a column of x values with the y variable unset, one operation at a time across blocks of samples rather
+ *  than one sample at a time. Custom variables are reported as unbound. Prefer this over repeated evaluateWithX:y:status: calls when
+ *  sampling large ranges.
+ *
+ *  @param xValues Values of the x variable.
+ *  @param results Array of at least count doubles to receive the evaluated values.
+ *  @param count   Number of values in xValues.
+ *
+ *  @return The evaluation status.
+ */
+- (VSCompiledExpressionStatusType)evaluateWithXValues:(const double *)xValues results:(double *)results count:(NSUInteger)count;
+
+@end
@@ -0,0 +1,308 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "vsexpr.h"
+#import "vsmath.h"
+#import "vsmem.h"
+
+#import "VSCompiledExpression.h"
+
+NSString *NSStringFromVSCompiledExpressionStatusType(VSCompiledExpressionStatusType type) {
+    switch (type) {
+        case VSCompiledExpressionStatusTypeUnknown:         return @"VSCompiledExpressionStatusTypeUnknown";
+        case VSCompiledExpressionStatusTypeSuccess:         return @"VSCompiledExpressionStatusTypeSuccess";
+        case VSCompiledExpressionStatusTypeUnboundVariable: return @"VSCompiledExpressionStatusTypeUnboundVariable";
+        case VSCompiledExpressionStatusTypeMaxTypes:        return @"VSCompiledExpressionStatusTypeMaxTypes";
+        default:                                            return @(type).stringValue;
+    }
+}
+
+#pragma mark -
+
+@interface VSCompiledExpression () {
+    vs_expr_t *_expression;
+}
+
+- (instancetype)_initWithExpression:(vs_expr_t *)expression variableNames:(NSArray *)variableNames angleMode:(VSMathAngleModeType)angleMode;
++ (vs_expr_t *)_expressionFromPostfixStack:(NSArray *)postfixStack variableNames:(NSMutableArray *)variableNames;
+
+@end
+
+#pragma mark -
+
+@implementation VSCompiledExpression
+
+#pragma mark Instantiation
+
++ (instancetype)compiledExpressionWithInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode {
+    return [VSCompiledExpression compiledExpressionWithInfixExpression:infixExpression angleMode:angleMode customVariableSets:nil];
+}
+
++ (instancetype)compiledExpressionWithInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode customVariableSets:(NSArray *)customVariableSets {
+    // Custom variable sets are only understood by the Objective-C tokenizer.
+    if (customVariableSets.count > 0) {
+        return [VSCompiledExpression compiledExpressionWithPostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression customVariableSets:customVariableSets] angleMode:angleMode];
+    }
+
+    vs_expr_t *expression = vs_expr_parse(infixExpression.UTF8String, NULL);
+
+    if (expression == NULL) {
+        return nil;
+    }
+
+    VSCompiledExpression *compiledExpression = [[VSCompiledExpression alloc] _initWithExpression:expression variableNames:nil angleMode:angleMode];
+
+#if !__has_feature(objc_arc)
+    return [compiledExpression autorelease];
+#else
+    return compiledExpression;
+#endif
+}
+
++ (instancetype)compiledExpressionWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode {
+    return [VSCompiledExpression compiledExpressionWithPostfixStack:postfixStack angleMode:angleMode options:VSMathEvaluationOptionNone];
+}
+
++ (instancetype)compiledExpressionWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode options:(VSMathEvaluationOptions)options {
+    VSCompiledExpression *compiledExpression = [[VSCompiledExpression alloc] initWithPostfixStack:postfixStack angleMode:angleMode options:options];
+
+#if !__has_feature(objc_arc)
+    return [compiledExpression autorelease];
+#else
+    return compiledExpression;
+#endif
+}
+
+- (instancetype)initWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode {
+    return [self initWithPostfixStack:postfixStack angleMode:angleMode options:VSMathEvaluationOptionNone];
+}
+
+- (instancetype)initWithPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode options:(VSMathEvaluationOptions)options {
+    NSMutableArray *variableNames = [NSMutableArray arrayWithObjects:VS_M_SYMBOL_X_VARIABLE, VS_M_SYMBOL_Y_VARIABLE, nil];
+    vs_expr_t *expression = [VSCompiledExpression _expressionFromPostfixStack:postfixStack variableNames:variableNames];
+
+    if ((expression != NULL) && (options & VSMathEvaluationOptionStrengthReduction) && (vs_expr_reduce(expression) != VS_EXPR_OK)) {
+        vs_expr_free(expression);
+        expression = NULL;
+    }
+
+    if (expression == NULL) {
+#if !__has_feature(objc_arc)
+        [self release];
+#endif
+        return nil;
+    }
+
+    self = [self _initWithExpression:expression variableNames:variableNames angleMode:angleMode];
+
+    if (self != nil) {
+        _options = options;
+    }
+
+    return self;
+}
+
+/**
+ *  Initializes a compiled expression which takes ownership of the specified C expression.
+ *
+ *  @param expression
+ *  @param variableNames Names of all variable slots, nil if only the x and y variables are used.
+ *  @param angleMode
+ *
+ *  @return VSCompiledExpression instance.
+ *
+ *  @private
+ */
+- (instancetype)_initWithExpression:(vs_expr_t *)expression variableNames:(NSArray *)variableNames angleMode:(VSMathAngleModeType)angleMode {
+    self = [super init];
+
+    if (self == nil) {
+        vs_expr_free(expression);
+        return nil;
+    }
+
+    // Repeated subexpressions are evaluated once per evaluation. Sharing is only an optimization, so the unshared expression is kept
+    // if it fails.
+    vs_expr_share(expression);
+
+    _expression = expression;
+    _angleMode = angleMode;
+    _options = VSMathEvaluationOptionNone;
+
+    if (variableNames == nil) {
+        _variableNames = [[NSArray alloc] initWithObjects:VS_M_SYMBOL_X_VARIABLE, VS_M_SYMBOL_Y_VARIABLE, nil];
+    }
+    else {
+        _variableNames = [[NSArray alloc] initWithArray:variableNames];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    vs_expr_free(_expression);
+    _expression = NULL;
+
+    vs_dealloc(_variableNames);
+
+#if !__has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+#pragma mark Properties
+
+- (NSUInteger)numberOfVariables {
+    return _variableNames.count;
+}
+
+/**
+ *  Gets the C expression compiled from this expression, for evaluators built on top of it.
+ *
+ *  @return The C expression.
+ *
+ *  @private
+ */
+- (const vs_expr_t *)_compiledExpression {
+    return _expression;
+}
+
+#pragma mark Variables
+
+- (NSUInteger)slotOfVariable:(NSString *)variableName {
+    if (variableName == nil) {
+        return NSNotFound;
+    }
+
+    return [_variableNames indexOfObject:variableName];
+}
+
+#pragma mark Evaluation
+
+- (double)evaluateWithX:(double)x y:(double)y status:(VSCompiledExpressionStatusType *)status {
+    double variables[2] = { x, y };
+
+    return [self evaluateWithVariables:variables count:2 status:status];
+}
+
+- (double)evaluateWithVariables:(const double *)variables count:(NSUInteger)count status:(VSCompiledExpressionStatusType *)status {
+    int s;
+    double o = vs_expr_eval(_expression, (vs_angle_t)_angleMode, (int)_options, variables, count, &s);
+
+    if (status != NULL) {
+        switch (s) {
+            case VS_EXPR_OK:       *status = VSCompiledExpressionStatusTypeSuccess;         break;
+            case VS_EXPR_EUNBOUND: *status = VSCompiledExpressionStatusTypeUnboundVariable; break;
+            default:               *status = VSCompiledExpressionStatusTypeUnknown;         break;
+        }
+    }
+
+    return o;
+}
+
+- (VSCompiledExpressionStatusType)evaluateWithXValues:(const double *)xValues results:(double *)results count:(NSUInteger)count {
+    switch (vs_expr_eval_v(_expression, (vs_angle_t)_angleMode, (int)_options, xValues, results, count)) {
+        case VS_EXPR_OK:       return VSCompiledExpressionStatusTypeSuccess;
+        case VS_EXPR_EUNBOUND: return VSCompiledExpressionStatusTypeUnboundVariable;
+        default:               return VSCompiledExpressionStatusTypeUnknown;
+    }
+}
+
+#pragma mark Compilation
+
+/**
+ *  Compiles the specified postfix stack into a C expression, validating operand counts along the way.
+ *
+ *  @param postfixStack
+ *  @param variableNames Mutable array of variable names to append custom variables to.
+ *
+ *  @return The compiled C expression, NULL if the postfix stack is empty or contains syntax errors.
+ *
+ *  @private
+ */
++ (vs_expr_t *)_expressionFromPostfixStack:(NSArray *)postfixStack variableNames:(NSMutableArray *)variableNames {
+    if ((postfixStack == nil) || (postfixStack.count <= 0)) {
+        return NULL;
+    }
+
+    vs_expr_t *expression = vs_expr_alloc((unsigned int)postfixStack.count);
+
+    if (expression == NULL) {
+        return NULL;
+    }
+
+    for (id token in postfixStack) {
+        int s = VS_EXPR_OK;
+
+        switch ([VSMathUtil typeOfToken:token]) {
+            case VSMathTokenTypeNumeric: {
+                s = vs_expr_pushconst(expression, [VSMathUtil doubleFromToken:token]);
+                break;
+            }
+
+            case VSMathTokenTypeConstant: {
+                s = vs_expr_pushop(expression, (vs_op_t)[VSMathUtil operationTypeOfSymbol:token], 0);
+                break;
+            }
+
+            case VSMathTokenTypeVariable: {
+                s = vs_expr_pushvar(expression, ([VSMathUtil typeOfSymbol:token] == VSMathSymbolTypeYVariable) ? VS_EXPR_SLOT_Y : VS_EXPR_SLOT_X);
+                break;
+            }
+
+            case VSMathTokenTypeUnaryPrefixOperator:
+            case VSMathTokenTypeUnaryPostfixOperator:
+            case VSMathTokenTypeFunction: {
+                s = vs_expr_pushop(expression, (vs_op_t)[VSMathUtil operationTypeOfSymbol:token], 1);
+                break;
+            }
+
+            case VSMathTokenTypeOperator: {
+                s = vs_expr_pushop(expression, (vs_op_t)[VSMathUtil operationTypeOfSymbol:token], 2);
+                break;
+            }
+
+            case VSMathTokenTypeParenthesis: {
+                // Ignore, as if they never existed.
+                break;
+            }
+
+            default: {
+                // Unrecognized tokens can only be bound as custom variables.
+                if (![token isKindOfClass:[NSString class]]) {
+                    s = VS_EXPR_ESYNTAX;
+                    break;
+                }
+
+                NSUInteger slot = [variableNames indexOfObject:token];
+
+                if (slot == NSNotFound) {
+                    slot = variableNames.count;
+                    [variableNames addObject:token];
+                }
+
+                s = vs_expr_pushvar(expression, (unsigned int)slot);
+                break;
+            }
+        }
+
+        if (s != VS_EXPR_OK) {
+            vs_expr_free(expression);
+            return NULL;
+        }
+    }
+
+    if (!vs_expr_iscomplete(expression)) {
+        vs_expr_free(expression);
+        return NULL;
+    }
+
+    return expression;
+}
+
+@end
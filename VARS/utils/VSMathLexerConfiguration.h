@@ -0,0 +1,102 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  Custom variable sets compiled once for tokenizing math expressions.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "vslex.h"
+
+#import "VSMathUtil.h"
+
+/**
+ *  Immutable set of custom variable sets, validated and compiled once into the character bitmaps of vslex.h. Tokenizing and parsing
+ *  with a lexer configuration costs one table lookup per character and custom variable set, instead of validating every set and
+ *  querying its NSCharacterSet for every character and token. Character sets are copied when compiled, so mutating them afterwards
+ *  has no effect on the configuration. Only characters of the Basic Multilingual Plane can be custom variable characters.
+ */
+@interface VSMathLexerConfiguration : NSObject
+
+#pragma mark Properties
+
+/**
+ *  Valid custom variable sets of this configuration, in the order they were specified.
+ */
+@property (nonatomic, readonly) NSArray *customVariableSets;
+
+/**
+ *  Number of valid custom variable sets.
+ */
+@property (nonatomic, readonly) NSUInteger numberOfSets;
+
+/**
+ *  Compiled custom variable sets, indexed like VSMathLexerConfiguration::customVariableSets, NULL if there are none.
+ */
+@property (nonatomic, readonly) const vs_lex_set_t *sets;
+
+#pragma mark Instantiation
+
+/**
+ *  Gets the shared lexer configuration without custom variable sets.
+ *
+ *  @return VSMathLexerConfiguration instance.
+ */
++ (instancetype)defaultLexerConfiguration;
+
+/**
+ *  Compiles the given custom variable sets into a lexer configuration. Custom variable sets are defined by an array of NSDictionary
+ *  objects, each containing a "characterSet" key (an NSCharacterSet object) and a "maxRange" key (an NSNumber object, indicating the
+ *  max character length of the string token of associated type). Invalid sets are ignored.
+ *
+ *  @param customVariableSets
+ *
+ *  @return VSMathLexerConfiguration instance, nil if out of memory.
+ */
++ (instancetype)lexerConfigurationWithCustomVariableSets:(NSArray *)customVariableSets;
+
+/**
+ *  Compiles the given custom variable sets into a lexer configuration. See
+ *  VSMathLexerConfiguration::lexerConfigurationWithCustomVariableSets:.
+ *
+ *  @param customVariableSets
+ *
+ *  @return VSMathLexerConfiguration instance, nil if out of memory.
+ */
+- (instancetype)initWithCustomVariableSets:(NSArray *)customVariableSets;
+
+#pragma mark Validation
+
+/**
+ *  Verifies that a custom variable set is valid. A custom variable sets is defined by a NSDictionary object
+ *  containing a "characterSet" key (an NSCharacterSet object) and a "maxRange" key (an NSNumber object,
+ *  indicating the max character length of the token of associated type).
+ *
+ *  @param customVariableSet
+ *
+ *  @return YES if valid, NO otherwise.
+ */
++ (BOOL)validateCustomVariableSet:(id)customVariableSet;
+
+/**
+ *  Verifies whether all characters of a token belong to any of the custom variable sets of this configuration.
+ *
+ *  @param token
+ *
+ *  @return YES if custom variable, NO otherwise.
+ */
+- (BOOL)isCustomVariable:(NSString *)token;
+
+/**
+ *  Verifies whether all UTF-16 characters of a token belong to any of the custom variable sets of this configuration.
+ *
+ *  @param characters
+ *  @param length
+ *
+ *  @return YES if custom variable, NO otherwise.
+ */
+- (BOOL)isCustomVariableWithCharacters:(const unichar *)characters length:(NSUInteger)length;
+
+@end
@@ -0,0 +1,199 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "vsmem.h"
+
+#import "VSMathLexerConfiguration.h"
+
+/**
+ *  Max length of tokens verified by VSMathLexerConfiguration::isCustomVariable: without allocating memory.
+ */
+#define VS_M_LEXER_TOKEN_BUFFER_LENGTH 64
+
+@interface VSMathLexerConfiguration () {
+    vs_lex_set_t *_sets;
+}
+
+@end
+
+#pragma mark -
+
+@implementation VSMathLexerConfiguration
+
+#pragma mark Instantiation
+
++ (instancetype)defaultLexerConfiguration {
+    static VSMathLexerConfiguration *lexerConfiguration = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        lexerConfiguration = [[VSMathLexerConfiguration alloc] initWithCustomVariableSets:nil];
+    });
+
+    return lexerConfiguration;
+}
+
++ (instancetype)lexerConfigurationWithCustomVariableSets:(NSArray *)customVariableSets {
+    if (customVariableSets.count <= 0) {
+        return [VSMathLexerConfiguration defaultLexerConfiguration];
+    }
+
+    VSMathLexerConfiguration *lexerConfiguration = [[VSMathLexerConfiguration alloc] initWithCustomVariableSets:customVariableSets];
+
+#if !__has_feature(objc_arc)
+    return [lexerConfiguration autorelease];
+#else
+    return lexerConfiguration;
+#endif
+}
+
+- (instancetype)initWithCustomVariableSets:(NSArray *)customVariableSets {
+    self = [super init];
+
+    if (self == nil) {
+        return nil;
+    }
+
+    NSMutableArray *validSets = [NSMutableArray array];
+
+    if ([customVariableSets isKindOfClass:[NSArray class]]) {
+        for (id customVariableSet in customVariableSets) {
+            if ([VSMathLexerConfiguration validateCustomVariableSet:customVariableSet]) {
+                [validSets addObject:customVariableSet];
+            }
+        }
+    }
+
+    _customVariableSets = [[NSArray alloc] initWithArray:validSets];
+    _numberOfSets = 0;
+    _sets = NULL;
+
+    if (_customVariableSets.count <= 0) {
+        return self;
+    }
+
+    _sets = (vs_lex_set_t *)calloc(_customVariableSets.count, sizeof(vs_lex_set_t));
+
+    if (_sets == NULL) {
+#if !__has_feature(objc_arc)
+        [self release];
+#endif
+        return nil;
+    }
+
+    for (NSDictionary *dictionary in _customVariableSets) {
+        NSCharacterSet *characterSet = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
+        NSData *bitmap = characterSet.bitmapRepresentation;
+        unsigned long maxRange = [(NSNumber *)[dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_MAX_RANGE] unsignedLongValue];
+
+        if (!vs_lex_set_init(&_sets[_numberOfSets], (const unsigned char *)bitmap.bytes, bitmap.length, maxRange)) {
+#if !__has_feature(objc_arc)
+            [self release];
+#endif
+            return nil;
+        }
+
+        _numberOfSets++;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _numberOfSets; i++) {
+        vs_lex_set_free(&_sets[i]);
+    }
+
+    free(_sets);
+    _sets = NULL;
+
+    vs_dealloc(_customVariableSets);
+
+#if !__has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+#pragma mark Properties
+
+- (const vs_lex_set_t *)sets {
+    return _sets;
+}
+
+#pragma mark Validation
+
++ (BOOL)validateCustomVariableSet:(id)customVariableSet {
+    if (customVariableSet == nil) {
+        return NO;
+    }
+
+    if (![customVariableSet isKindOfClass:[NSDictionary class]]) {
+        return NO;
+    }
+
+    NSDictionary *dictionary = (NSDictionary *)customVariableSet;
+    id characterSet = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
+    id maxRange = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_MAX_RANGE];
+
+    if ((characterSet == nil) || ![characterSet isKindOfClass:[NSCharacterSet class]]) {
+        return NO;
+    }
+
+    if ((maxRange == nil) || ![maxRange isKindOfClass:[NSNumber class]]) {
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)isCustomVariable:(NSString *)token {
+    if ((_numberOfSets <= 0) || ![token isKindOfClass:[NSString class]]) {
+        return NO;
+    }
+
+    CFStringRef string = (__bridge CFStringRef)token;
+    CFIndex length = CFStringGetLength(string);
+    const UniChar *characters = CFStringGetCharactersPtr(string);
+    UniChar buffer[VS_M_LEXER_TOKEN_BUFFER_LENGTH];
+    UniChar *heapBuffer = NULL;
+
+    if (characters == NULL) {
+        if (length <= VS_M_LEXER_TOKEN_BUFFER_LENGTH) {
+            characters = buffer;
+        }
+        else {
+            heapBuffer = (UniChar *)malloc(length * sizeof(UniChar));
+
+            if (heapBuffer == NULL) {
+                return NO;
+            }
+
+            characters = heapBuffer;
+        }
+
+        CFStringGetCharacters(string, CFRangeMake(0, length), (UniChar *)characters);
+    }
+
+    BOOL isCustomVariable = [self isCustomVariableWithCharacters:characters length:length];
+
+    free(heapBuffer);
+
+    return isCustomVariable;
+}
+
+- (BOOL)isCustomVariableWithCharacters:(const unichar *)characters length:(NSUInteger)length {
+    for (NSUInteger i = 0; i < _numberOfSets; i++) {
+        if (vs_lex_set_contains(&_sets[i], characters, length)) {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+@end
@@ -0,0 +1,132 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  Math expression parsed incrementally as it is edited.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "VSMathLexerConfiguration.h"
+#import "VSMathUtil.h"
+
+/**
+ *  Mutable math expression in infix notation which keeps its tokens and the state of the shunting-yard algorithm across edits, meant
+ *  for expressions typed one keystroke at a time. Every edit only re-lexes the tokens around the edited characters, until the new tokens
+ *  line up with the previous ones again, and resumes the shunting-yard algorithm from the last checkpoint of its operator stack before
+ *  the first changed token. Editing near the end of a long expression therefore costs time proportional to the edit rather than to the
+ *  whole expression. The postfix stack of a session is identical to the output of
+ *  VSMathUtil::postfixStackFromInfixExpression:lexerConfiguration: for the same expression.
+ */
+@interface VSMathParserSession : NSObject
+
+#pragma mark Properties
+
+/**
+ *  Current math expression in infix notation.
+ */
+@property (nonatomic, readonly) NSString *infixExpression;
+
+/**
+ *  Lexer configuration of the custom variable sets of this session.
+ */
+@property (nonatomic, readonly) VSMathLexerConfiguration *lexerConfiguration;
+
+/**
+ *  Number of tokens of the current expression.
+ */
+@property (nonatomic, readonly) NSUInteger numberOfTokens;
+
+/**
+ *  Postfix notation (RPN) of the current expression, nil if it cannot be parsed.
+ */
+@property (nonatomic, readonly) NSArray *postfixStack;
+
+#pragma mark Instantiation
+
+/**
+ *  Creates a session with an empty expression and no custom variable sets.
+ *
+ *  @return VSMathParserSession instance.
+ */
++ (instancetype)parserSession;
+
+/**
+ *  Creates a session with an empty expression.
+ *
+ *  @param lexerConfiguration Lexer configuration of custom variable sets, nil if none.
+ *
+ *  @return VSMathParserSession instance, nil if out of memory.
+ */
++ (instancetype)parserSessionWithLexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
+/**
+ *  Initializes a session with an empty expression.
+ *
+ *  @param lexerConfiguration Lexer configuration of custom variable sets, nil if none.
+ *
+ *  @return VSMathParserSession instance, nil if out of memory.
+ */
+- (instancetype)initWithLexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
+#pragma mark Editing
+
+/**
+ *  Appends a string to the end of the expression.
+ *
+ *  @param string
+ *
+ *  @return YES if edited, NO if out of memory.
+ */
+- (BOOL)appendString:(NSString *)string;
+
+/**
+ *  Deletes the characters of the expression in the specified range.
+ *
+ *  @param range Range of characters, clamped to the expression.
+ *
+ *  @return YES if edited, NO if out of memory.
+ */
+- (BOOL)deleteCharactersInRange:(NSRange)range;
+
+/**
+ *  Replaces the characters of the expression in the specified range with a string. All other edits are carried out by this method.
+ *
+ *  @param range  Range of characters, clamped to the expression.
+ *  @param string
+ *
+ *  @return YES if edited, NO if out of memory.
+ */
+- (BOOL)replaceCharactersInRange:(NSRange)range withString:(NSString *)string;
+
+/**
+ *  Replaces the whole expression, re-parsing only the characters between the prefix and the suffix it shares with the current
+ *  expression.
+ *
+ *  @param infixExpression
+ *
+ *  @return YES if edited, NO if out of memory.
+ */
+- (BOOL)replaceInfixExpression:(NSString *)infixExpression;
+
+#pragma mark Evaluation
+
+/**
+ *  Verifies the syntax of the current expression, equivalent to VSMathUtil::validateInfixExpressionSyntax:customVariableSets:.
+ *
+ *  @return YES if valid, NO otherwise.
+ */
+- (BOOL)validateSyntax;
+
+/**
+ *  Evaluates the current expression, equivalent to VSMathUtil::evaluateInfixExpression:angleMode:tokenMap:lexerConfiguration:.
+ *
+ *  @param angleMode
+ *  @param tokenMap
+ *
+ *  @return The evaluated NSNumber object, nil if the expression is invalid or contains syntax errors.
+ */
+- (NSNumber *)evaluateWithAngleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap;
+
+@end
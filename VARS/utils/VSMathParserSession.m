@@ -0,0 +1,501 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "vsast.h"
+#import "vslex.h"
+#import "vsmem.h"
+
+#import "VSMathParserSession.h"
+
+/**
+ *  Number of tokens between two checkpoints of the shunting-yard algorithm, i.e. the max number of unchanged tokens processed again
+ *  after an edit.
+ */
+#define VS_M_PARSER_SESSION_CHECKPOINT_INTERVAL 16
+
+/**
+ *  State of the shunting-yard algorithm before a token: the number of nodes of the expression tree and the entries of the operator stack
+ *  and of the roots of the tree, which are stored in the checkpoint pools of the session from the specified offsets.
+ */
+typedef struct {
+    NSUInteger numberOfTokens;
+    size_t numberOfNodes;
+    NSUInteger stackOffset;
+    NSUInteger stackCount;
+    NSUInteger rootOffset;
+    size_t rootCount;
+} VSMathParserCheckpoint;
+
+/**
+ *  Grows a buffer to hold at least the specified number of elements, doubling its capacity.
+ *
+ *  @param buffer
+ *  @param capacity Capacity of the buffer in elements.
+ *  @param count    Number of elements needed.
+ *  @param size     Size of an element.
+ *
+ *  @return YES if the buffer holds enough elements, NO if out of memory.
+ */
+static BOOL VSMathParserSessionReserve(void **buffer, NSUInteger *capacity, NSUInteger count, size_t size) {
+    if (count <= *capacity) {
+        return YES;
+    }
+
+    NSUInteger n = (*capacity > 0) ? *capacity : 16;
+
+    while (n < count) n *= 2;
+
+    void *b = realloc(*buffer, n * size);
+
+    if (b == NULL) {
+        return NO;
+    }
+
+    *buffer = b;
+    *capacity = n;
+
+    return YES;
+}
+
+/**
+ *  Verifies whether a token lexed after an edit is identical to the token it replaces, which is only the case if the edit did not touch
+ *  its characters.
+ *
+ *  @param token
+ *  @param previousToken
+ *  @param location      Location of the edit.
+ *
+ *  @return YES if identical, NO otherwise.
+ */
+static inline BOOL VSMathParserSessionIsTokenUnchanged(const vs_lex_token_t *token, const vs_lex_token_t *previousToken, NSUInteger location) {
+    return ((token->offset + token->length <= location) &&
+            (token->offset == previousToken->offset) &&
+            (token->length == previousToken->length) &&
+            (token->kind == previousToken->kind) &&
+            (token->symbol == previousToken->symbol));
+}
+
+/**
+ *  Shunting-yard internals of VSMathUtil which sessions resume from their checkpoints.
+ */
+@interface VSMathUtil (VSMathParserSession)
+
++ (const vs_lex_symtab_t *)_lexerSymbols;
++ (id)_objectOfLexToken:(const vs_lex_token_t *)token source:(NSString *)source;
++ (BOOL)_processShuntingYardToken:(const vs_lex_token_t *)token andPreviousToken:(const vs_lex_token_t *)prevToken characters:(const UniChar *)characters stack:(vs_lex_token_t *)stack count:(NSUInteger *)count tree:(vs_ast_t *)tree lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration contentAware:(BOOL)isContentAware;
+
+@end
+
+@interface VSMathParserSession () {
+    NSMutableString *_expression;
+    UniChar *_characters;
+    NSUInteger _characterCapacity;
+
+    vs_lex_token_t *_tokens;
+    NSUInteger _tokenCapacity;
+
+    vs_lex_token_t *_stack;
+    NSUInteger _stackCount;
+    NSUInteger _stackCapacity;
+    vs_ast_t _tree;
+    NSMutableArray *_objects;
+    NSUInteger _numberOfProcessedTokens;
+    BOOL _hasFailed;
+
+    VSMathParserCheckpoint *_checkpoints;
+    NSUInteger _numberOfCheckpoints;
+    NSUInteger _checkpointCapacity;
+    vs_lex_token_t *_checkpointStacks;
+    NSUInteger _checkpointStackCount;
+    NSUInteger _checkpointStackCapacity;
+    size_t *_checkpointRoots;
+    NSUInteger _checkpointRootCount;
+    NSUInteger _checkpointRootCapacity;
+
+    NSArray *_postfixStack;
+    BOOL _isPostfixStackValid;
+}
+
+- (void)_restoreCheckpointAtIndex:(NSUInteger)index;
+- (BOOL)_saveCheckpoint;
+- (BOOL)_resumeShuntingYard;
+
+@end
+
+#pragma mark -
+
+@implementation VSMathParserSession
+
+#pragma mark Instantiation
+
++ (instancetype)parserSession {
+    return [VSMathParserSession parserSessionWithLexerConfiguration:nil];
+}
+
++ (instancetype)parserSessionWithLexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    VSMathParserSession *parserSession = [[VSMathParserSession alloc] initWithLexerConfiguration:lexerConfiguration];
+
+#if !__has_feature(objc_arc)
+    return [parserSession autorelease];
+#else
+    return parserSession;
+#endif
+}
+
+- (instancetype)initWithLexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    self = [super init];
+
+    if (self == nil) {
+        return nil;
+    }
+
+    if (lexerConfiguration == nil) {
+        lexerConfiguration = [VSMathLexerConfiguration defaultLexerConfiguration];
+    }
+
+#if !__has_feature(objc_arc)
+    _lexerConfiguration = [lexerConfiguration retain];
+#else
+    _lexerConfiguration = lexerConfiguration;
+#endif
+
+    _expression = [[NSMutableString alloc] init];
+    _objects = [[NSMutableArray alloc] init];
+
+    // The checkpoint before the first token is the empty state, which every edit can go back to.
+    if (!vs_ast_init(&_tree, 16) || ![self _saveCheckpoint]) {
+#if !__has_feature(objc_arc)
+        [self release];
+#endif
+        return nil;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_characters);
+    free(_tokens);
+    free(_stack);
+    free(_checkpoints);
+    free(_checkpointStacks);
+    free(_checkpointRoots);
+
+    vs_ast_free(&_tree);
+
+    vs_dealloc(_expression);
+    vs_dealloc(_objects);
+    vs_dealloc(_postfixStack);
+    vs_dealloc(_lexerConfiguration);
+
+#if !__has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+#pragma mark Properties
+
+- (NSString *)infixExpression {
+    return [NSString stringWithString:_expression];
+}
+
+- (NSArray *)postfixStack {
+    if (_isPostfixStackValid) {
+        return _postfixStack;
+    }
+
+    vs_dealloc(_postfixStack);
+
+    if (!_hasFailed && (_numberOfTokens > 0)) {
+        NSMutableArray *postfixStack = [[NSMutableArray alloc] initWithArray:_objects];
+
+        // Pop remaining stack to the output, stripping out useless left parenthesis symbols.
+        for (NSUInteger i = _stackCount; i > 0; i--) {
+            if (_stack[i - 1].symbol != VSMathSymbolTypeLeftParenthesis) {
+                [postfixStack addObject:[VSMathUtil _objectOfLexToken:&_stack[i - 1] source:_expression]];
+            }
+        }
+
+        _postfixStack = [[NSArray alloc] initWithArray:postfixStack];
+
+        vs_dealloc(postfixStack);
+    }
+
+    _isPostfixStackValid = YES;
+
+    return _postfixStack;
+}
+
+#pragma mark Editing
+
+- (BOOL)appendString:(NSString *)string {
+    return [self replaceCharactersInRange:NSMakeRange(_expression.length, 0) withString:string];
+}
+
+- (BOOL)deleteCharactersInRange:(NSRange)range {
+    return [self replaceCharactersInRange:range withString:nil];
+}
+
+- (BOOL)replaceInfixExpression:(NSString *)infixExpression {
+    CFStringRef string = (__bridge CFStringRef)infixExpression;
+    NSUInteger length = (infixExpression != nil) ? CFStringGetLength(string) : 0;
+    NSUInteger prefix = 0;
+    NSUInteger suffix = 0;
+
+    while ((prefix < _expression.length) && (prefix < length) && (_characters[prefix] == CFStringGetCharacterAtIndex(string, prefix))) {
+        prefix++;
+    }
+
+    while ((suffix < _expression.length - prefix) && (suffix < length - prefix) && (_characters[_expression.length - suffix - 1] == CFStringGetCharacterAtIndex(string, length - suffix - 1))) {
+        suffix++;
+    }
+
+    NSRange range = NSMakeRange(prefix, _expression.length - prefix - suffix);
+
+    return [self replaceCharactersInRange:range withString:(infixExpression != nil) ? [infixExpression substringWithRange:NSMakeRange(prefix, length - prefix - suffix)] : nil];
+}
+
+- (BOOL)replaceCharactersInRange:(NSRange)range withString:(NSString *)string {
+    NSUInteger length = _expression.length;
+    NSUInteger location = MIN(range.location, length);
+    NSUInteger deleted = MIN(range.length, length - location);
+    NSUInteger inserted = string.length;
+    NSUInteger newLength = length - deleted + inserted;
+    NSInteger delta = (NSInteger)inserted - (NSInteger)deleted;
+
+    if ((deleted == 0) && (inserted == 0)) {
+        return YES;
+    }
+
+    // Every token is at least one character long.
+    if (!VSMathParserSessionReserve((void **)&_characters, &_characterCapacity, newLength, sizeof(UniChar)) ||
+        !VSMathParserSessionReserve((void **)&_tokens, &_tokenCapacity, newLength, sizeof(vs_lex_token_t))) {
+        return NO;
+    }
+
+    // Tokens ending before the character preceding the edit keep their lexing, so lexing resumes from the end of the last of them.
+    NSUInteger first = _numberOfTokens;
+    NSUInteger lower = 0;
+
+    while (lower < first) {
+        NSUInteger middle = lower + (first - lower) / 2;
+
+        if (_tokens[middle].offset + _tokens[middle].length < location) {
+            lower = middle + 1;
+        }
+        else {
+            first = middle;
+        }
+    }
+
+    size_t offset = (first > 0) ? (_tokens[first - 1].offset + _tokens[first - 1].length) : 0;
+
+    memmove(_characters + location + inserted, _characters + location + deleted, (length - location - deleted) * sizeof(UniChar));
+
+    if (inserted > 0) {
+        CFStringGetCharacters((__bridge CFStringRef)string, CFRangeMake(0, inserted), _characters + location);
+    }
+
+    [_expression replaceCharactersInRange:NSMakeRange(location, deleted) withString:(string != nil) ? string : @""];
+
+    vs_dealloc(_postfixStack);
+    _isPostfixStackValid = NO;
+
+    // Lex until a new token ends where a previous token ended past the edit, from where the previous tokens are reused as they are.
+    vs_lex_token_t *lexed = NULL;
+    NSUInteger lexedCount = 0;
+    NSUInteger lexedCapacity = 0;
+    NSUInteger resumed = _numberOfTokens;
+    NSUInteger j = first;
+    vs_lex_token_t token;
+
+    while (vs_lex_next(_characters, newLength, &offset, _lexerConfiguration.sets, _lexerConfiguration.numberOfSets, [VSMathUtil _lexerSymbols], &token)) {
+        if (!VSMathParserSessionReserve((void **)&lexed, &lexedCapacity, lexedCount + 1, sizeof(vs_lex_token_t))) {
+            free(lexed);
+
+            // The tokens no longer match the expression, so the session starts over on the next edit.
+            _numberOfTokens = 0;
+            [self _restoreCheckpointAtIndex:0];
+
+            return NO;
+        }
+
+        lexed[lexedCount++] = token;
+
+        if (offset < location + inserted) {
+            continue;
+        }
+
+        while ((j < _numberOfTokens) && ((NSInteger)(_tokens[j].offset + _tokens[j].length) + delta < (NSInteger)offset)) {
+            j++;
+        }
+
+        if ((j < _numberOfTokens) && ((NSInteger)(_tokens[j].offset + _tokens[j].length) + delta == (NSInteger)offset)) {
+            resumed = j + 1;
+            break;
+        }
+    }
+
+    // The shunting-yard algorithm resumes from the first token which differs.
+    NSUInteger unchanged = 0;
+
+    while ((unchanged < lexedCount) && (first + unchanged < resumed) && VSMathParserSessionIsTokenUnchanged(&lexed[unchanged], &_tokens[first + unchanged], location)) {
+        unchanged++;
+    }
+
+    NSUInteger reused = _numberOfTokens - resumed;
+
+    memmove(&_tokens[first + lexedCount], &_tokens[resumed], reused * sizeof(vs_lex_token_t));
+
+    for (NSUInteger i = first + lexedCount; i < first + lexedCount + reused; i++) {
+        _tokens[i].offset += delta;
+    }
+
+    if (lexedCount > 0) {
+        memcpy(&_tokens[first], lexed, lexedCount * sizeof(vs_lex_token_t));
+    }
+
+    free(lexed);
+
+    _numberOfTokens = first + lexedCount + reused;
+
+    NSUInteger changed = first + unchanged;
+
+    // A failure before the first changed token still fails the same way.
+    if (_hasFailed && (_numberOfProcessedTokens < changed)) {
+        return YES;
+    }
+
+    [self _restoreCheckpointAtIndex:MIN(changed / VS_M_PARSER_SESSION_CHECKPOINT_INTERVAL, _numberOfCheckpoints - 1)];
+
+    return [self _resumeShuntingYard];
+}
+
+#pragma mark Evaluation
+
+- (BOOL)validateSyntax {
+    return [VSMathUtil validatePostfixStackSyntax:self.postfixStack];
+}
+
+- (NSNumber *)evaluateWithAngleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap {
+    return [VSMathUtil evaluatePostfixStack:self.postfixStack angleMode:angleMode tokenMap:tokenMap];
+}
+
+#pragma mark Shunting-Yard Algorithm
+
+/**
+ *  Rolls the shunting-yard algorithm back to a checkpoint, discarding all checkpoints after it.
+ *
+ *  @param index
+ *
+ *  @private
+ */
+- (void)_restoreCheckpointAtIndex:(NSUInteger)index {
+    const VSMathParserCheckpoint *checkpoint = &_checkpoints[index];
+
+    // Buffers never shrink, so they still have room for the state they held at the checkpoint.
+    if (checkpoint->stackCount > 0) {
+        memcpy(_stack, _checkpointStacks + checkpoint->stackOffset, checkpoint->stackCount * sizeof(vs_lex_token_t));
+    }
+
+    if (checkpoint->rootCount > 0) {
+        memcpy(_tree.roots, _checkpointRoots + checkpoint->rootOffset, checkpoint->rootCount * sizeof(size_t));
+    }
+
+    _stackCount = checkpoint->stackCount;
+    _tree.count = checkpoint->numberOfNodes;
+    _tree.nroots = checkpoint->rootCount;
+    _numberOfProcessedTokens = checkpoint->numberOfTokens;
+    _hasFailed = NO;
+
+    [_objects removeObjectsInRange:NSMakeRange(checkpoint->numberOfNodes, _objects.count - checkpoint->numberOfNodes)];
+
+    _numberOfCheckpoints = index + 1;
+    _checkpointStackCount = checkpoint->stackOffset + checkpoint->stackCount;
+    _checkpointRootCount = checkpoint->rootOffset + checkpoint->rootCount;
+}
+
+/**
+ *  Saves the current state of the shunting-yard algorithm as the next checkpoint.
+ *
+ *  @return YES if saved, NO if out of memory.
+ *
+ *  @private
+ */
+- (BOOL)_saveCheckpoint {
+    if (!VSMathParserSessionReserve((void **)&_checkpoints, &_checkpointCapacity, _numberOfCheckpoints + 1, sizeof(VSMathParserCheckpoint)) ||
+        !VSMathParserSessionReserve((void **)&_checkpointStacks, &_checkpointStackCapacity, _checkpointStackCount + _stackCount, sizeof(vs_lex_token_t)) ||
+        !VSMathParserSessionReserve((void **)&_checkpointRoots, &_checkpointRootCapacity, _checkpointRootCount + _tree.nroots, sizeof(size_t))) {
+        return NO;
+    }
+
+    VSMathParserCheckpoint *checkpoint = &_checkpoints[_numberOfCheckpoints++];
+
+    checkpoint->numberOfTokens = _numberOfProcessedTokens;
+    checkpoint->numberOfNodes = _tree.count;
+    checkpoint->stackOffset = _checkpointStackCount;
+    checkpoint->stackCount = _stackCount;
+    checkpoint->rootOffset = _checkpointRootCount;
+    checkpoint->rootCount = _tree.nroots;
+
+    if (_stackCount > 0) {
+        memcpy(_checkpointStacks + _checkpointStackCount, _stack, _stackCount * sizeof(vs_lex_token_t));
+    }
+
+    if (_tree.nroots > 0) {
+        memcpy(_checkpointRoots + _checkpointRootCount, _tree.roots, _tree.nroots * sizeof(size_t));
+    }
+
+    _checkpointStackCount += _stackCount;
+    _checkpointRootCount += _tree.nroots;
+
+    return YES;
+}
+
+/**
+ *  Processes the tokens following the last processed one according to shunting-yard rules, stopping at the first token which fails.
+ *
+ *  @return YES if processed, NO if out of memory.
+ *
+ *  @private
+ */
+- (BOOL)_resumeShuntingYard {
+    while (_numberOfProcessedTokens < _numberOfTokens) {
+        NSUInteger i = _numberOfProcessedTokens;
+
+        if ((i % VS_M_PARSER_SESSION_CHECKPOINT_INTERVAL == 0) && (i / VS_M_PARSER_SESSION_CHECKPOINT_INTERVAL == _numberOfCheckpoints) && ![self _saveCheckpoint]) {
+            _hasFailed = YES;
+            return NO;
+        }
+
+        // The operator stack needs room for the token and an inserted multiplier.
+        if (!VSMathParserSessionReserve((void **)&_stack, &_stackCapacity, _stackCount + 2, sizeof(vs_lex_token_t))) {
+            _hasFailed = YES;
+            return NO;
+        }
+
+        size_t numberOfNodes = _tree.count;
+        const vs_lex_token_t *prevToken = (i > 0) ? &_tokens[i - 1] : NULL;
+
+        if (![VSMathUtil _processShuntingYardToken:&_tokens[i] andPreviousToken:prevToken characters:_characters stack:_stack count:&_stackCount tree:&_tree lexerConfiguration:_lexerConfiguration contentAware:YES]) {
+            _hasFailed = YES;
+            return YES;
+        }
+
+        // Nodes are emitted in postfix order.
+        for (size_t n = numberOfNodes; n < _tree.count; n++) {
+            [_objects addObject:[VSMathUtil _objectOfLexToken:&_tree.nodes[n].token source:_expression]];
+        }
+
+        _numberOfProcessedTokens++;
+    }
+
+    return YES;
+}
+
+@end
@@ -14,6 +14,8 @@
 
 #import "VSNumberUtil.h"
 
+@class VSMathLexerConfiguration;
+
 /**
  *  Dictionary property for character sets.
  */
@@ -24,6 +26,13 @@
  */
 #define VS_M_DICTIONARY_PROPERTY_MAX_RANGE @"maxRange"
 
+/**
+ *  Maximum number of postfix stacks cached by VSMathUtil::postfixStackFromInfixExpression:customVariableSets:, 0 to disable caching.
+ */
+#ifndef VS_M_POSTFIX_STACK_CACHE_CAPACITY
+#define VS_M_POSTFIX_STACK_CACHE_CAPACITY 512
+#endif
+
 #pragma mark -
 
 /**
@@ -263,6 +272,27 @@ typedef NS_ENUM(int, VSMathTokenType) {
  */
 NSString *NSStringFromVSMathTokenType(VSMathTokenType type);
 
+/**
+ *  Options of math expression evaluation, numerically identical to the VS_EXPR_MODE_* flags of vsexpr.
+ *
+ *  VSMathEvaluationOptionFastMath evaluates sine, cosine, the hyperbolic functions, natural logarithm, exp and exponentiation with the
+ *  approximations of vsfmath, which are accurate to a few ulp (see vsfmath.h) but considerably faster over large numbers of samples.
+ *
+ *  VSMathEvaluationOptionFastArithmetic evaluates addition, subtraction, multiplication and division with compensated doubles instead of
+ *  decimals (see vsdec.h). Results are the same doubles as the decimal ones, only the rare results that need decimal arithmetic to be
+ *  rounded cost as much as before, which is meant for callers that evaluate large numbers of samples, such as the samplers.
+ *
+ *  VSMathEvaluationOptionStrengthReduction rewrites powers, divisions by constants and additions of products of compiled expressions
+ *  into repeated multiplications, multiplications by reciprocals and fused multiply-adds (see vs_expr_reduce()). Results are within a
+ *  few ulp of the unreduced ones. It only takes effect when an expression is compiled, see VSCompiledExpression.
+ */
+typedef NS_OPTIONS(int, VSMathEvaluationOptions) {
+    VSMathEvaluationOptionNone              = 0,
+    VSMathEvaluationOptionFastMath          = 1 << 0,
+    VSMathEvaluationOptionFastArithmetic    = 1 << 1,
+    VSMathEvaluationOptionStrengthReduction = 1 << 2
+};
+
 #pragma mark -
 
 NS_ROOT_CLASS @interface VSMathUtil
@@ -383,6 +413,31 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operandX:(double)operandX operandY:(double)operandY;
 
+/**
+ *  Evaluates the given operation type with only one operand x, using the specified evaluation options.
+ *
+ *  @param operationType
+ *  @param angleMode
+ *  @param operand
+ *  @param options
+ *
+ *  @return Double value result.
+ */
++ (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operand:(double)operand options:(VSMathEvaluationOptions)options;
+
+/**
+ *  Evaluates the given operation type with two operands x and y, using the specified evaluation options.
+ *
+ *  @param operationType
+ *  @param angleMode
+ *  @param operandX
+ *  @param operandY
+ *  @param options
+ *
+ *  @return Double value result.
+ */
++ (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operandX:(double)operandX operandY:(double)operandY options:(VSMathEvaluationOptions)options;
+
 #pragma mark Expression Syntax Verification
 
 /**
@@ -421,7 +476,7 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  consideration the specified custom character sets. Custom character sets are defined by an array of NSDictionary
  *  objects, each containing a "characterSet" key (an NSCharacterSet object) and a "maxRange" key (an NSNumber object,
  *  indicating the max character length of the string token of associated type). This process does not detect any errors,
- *  everything will be parsed into string tokens.
+ *  everything will be parsed into string tokens. The expression is scanned once, classifying characters with the tables of vslex.h.
  *
  *  @param infixExpression
  *  @param customVariableSets
@@ -430,6 +485,18 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSArray *)tokensInInfixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Parses the expression into tokens and returns them in the form of an NSArray, taking into consideration the custom variable sets
+ *  precompiled in the specified lexer configuration. Reusing a lexer configuration avoids compiling its custom variable sets on
+ *  every call. See VSMathUtil::tokensInInfixExpression:customVariableSets:.
+ *
+ *  @param infixExpression
+ *  @param lexerConfiguration
+ *
+ *  @return An array of string tokens.
+ */
++ (NSArray *)tokensInInfixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
 /**
  *  Parses the infix expression into tokens and stores them into the specified NSMutableArray pointer with the option
  *  to take into consideration the specified custom character sets. Custom character sets are defined by an array of
@@ -445,6 +512,19 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (BOOL)parseInfixExpressionIntoTokens:(NSMutableArray *)tokens infixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Parses the infix expression into tokens and stores them into the specified NSMutableArray pointer, taking into consideration the
+ *  custom variable sets precompiled in the specified lexer configuration. See
+ *  VSMathUtil::parseInfixExpressionIntoTokens:infixExpression:customVariableSets:.
+ *
+ *  @param tokens
+ *  @param infixExpression
+ *  @param lexerConfiguration
+ *
+ *  @return YES if successful, NO if something went wrong.
+ */
++ (BOOL)parseInfixExpressionIntoTokens:(NSMutableArray *)tokens infixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
 /**
  *  Gets the double value from a math expression token.
  *
@@ -492,6 +572,10 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  the following condition(s):
  *      1. Process token operation fails. See VSMathUtil::processShuntingYardToken:andPreviousToken:stack:output:customVariableSets:
  *
+ *  Results are cached by expression and custom variable sets (up to VS_M_POSTFIX_STACK_CACHE_CAPACITY of them), so the returned array
+ *  may be shared with other callers and threads and must not be mutated. Custom variable sets are identified by their max ranges and
+ *  their character set instances, or their character set contents for mutable character sets, which may be mutated between calls.
+ *
  *  @param infixExpression
  *  @param customVariableSets
  *
@@ -499,6 +583,37 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSArray *)postfixStackFromInfixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Converts a string math expression in infix notation to postfix notation (RPN) represented in an array, taking into consideration
+ *  the custom variable sets precompiled in the specified lexer configuration. Results share the postfix stack cache of
+ *  VSMathUtil::postfixStackFromInfixExpression:customVariableSets:.
+ *
+ *  @param infixExpression
+ *  @param lexerConfiguration
+ *
+ *  @return The corresponding postfix notation, nil if anything goes wrong.
+ */
++ (NSArray *)postfixStackFromInfixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
+/**
+ *  Gets the number of VSMathUtil::postfixStackFromInfixExpression:customVariableSets: calls served from the postfix stack cache.
+ *
+ *  @return The hit count.
+ */
++ (unsigned long long)postfixStackCacheHitCount;
+
+/**
+ *  Gets the number of VSMathUtil::postfixStackFromInfixExpression:customVariableSets: calls which had to parse their expression.
+ *
+ *  @return The miss count.
+ */
++ (unsigned long long)postfixStackCacheMissCount;
+
+/**
+ *  Removes all postfix stacks from the cache. Hit and miss counts are kept.
+ */
++ (void)clearPostfixStackCache;
+
 /**
  *  Converts a string math expression in infix notation to postfix notation (RPN) represented in an array. The postfix notation is stored
  *  in the specified array pointer. This operation only fails under the following condition(s):
@@ -525,6 +640,21 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (BOOL)parseInfixExpressionIntoPostfixStack:(NSMutableArray *)postfixStack infixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Converts a string math expression in infix notation to postfix notation (RPN) represented in an array, taking into consideration
+ *  the custom variable sets precompiled in the specified lexer configuration. The postfix notation is stored in the specified array
+ *  pointer. The expression is lexed into token structs pointing into its characters rather than into substrings, and its numbers are
+ *  parsed once while lexing. The tokens are then parsed into an expression tree (see vsast.h) in a single linear pass, from which the
+ *  postfix notation is emitted. See VSMathUtil::parseInfixExpressionIntoPostfixStack:infixExpression:customVariableSets:.
+ *
+ *  @param postfixStack
+ *  @param infixExpression
+ *  @param lexerConfiguration
+ *
+ *  @return YES if successful, NO if something went wrong.
+ */
++ (BOOL)parseInfixExpressionIntoPostfixStack:(NSMutableArray *)postfixStack infixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
 #pragma mark Shunting-Yard Algorithm
 
 /**
@@ -559,6 +689,19 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (BOOL)processShuntingYardToken:(id)token stack:(NSMutableArray *)stack output:(NSMutableArray *)output customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Processes a token and allocates them to the stack according to shunting-yard rules, taking into consideration the custom variable
+ *  sets precompiled in the specified lexer configuration. See VSMathUtil::processShuntingYardToken:stack:output:customVariableSets:.
+ *
+ *  @param token
+ *  @param stack
+ *  @param output
+ *  @param lexerConfiguration
+ *
+ *  @return YES if everything went fine, NO if something went wrong.
+ */
++ (BOOL)processShuntingYardToken:(id)token stack:(NSMutableArray *)stack output:(NSMutableArray *)output lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
 #pragma mark RPN Processing
 
 /**
@@ -584,6 +727,20 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSArray *)postfixStackByTruncatingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap;
 
+/**
+ *  Truncates a math expression in postfix notation (RPN) in double values and returns an autoreleased array of
+ *  the truncated stack, with the option to replace tokens by specifying a token map, using the specified
+ *  evaluation options.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param tokenMap
+ *  @param options
+ *
+ *  @return An array of truncated tokens, nil if expression is invalid or contains syntax errors.
+ */
++ (NSArray *)postfixStackByTruncatingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options;
+
 /**
  *  Truncates a math expression in postfix notation (RPN) in unsigned long long values and returns an autoreleased array
  *  of the truncated stack.
@@ -632,6 +789,21 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (BOOL)truncatePostfixStackIntoPostfixStack:(NSMutableArray *)truncatedPostfixStack postfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap;
 
+/**
+ *  Truncates a math expression in postfix notation (RPN) in double values and stores the truncated stack
+ *  into a specified array pointer with the option to replace tokens by specifying a token map, using the
+ *  specified evaluation options.
+ *
+ *  @param truncatedPostfixStack
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param tokenMap
+ *  @param options
+ *
+ *  @return YES if successful, NO if something went wrong.
+ */
++ (BOOL)truncatePostfixStackIntoPostfixStack:(NSMutableArray *)truncatedPostfixStack postfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options;
+
 /**
  *  Truncates a math expression in postfix notation (RPN) in unsigned long long values and stores the truncated
  *  stack into a specified array pointer.
@@ -657,6 +829,38 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (BOOL)truncateBitwisePostfixStackIntoPostfixStack:(NSMutableArray *)truncatedPostfixStack postfixStack:(NSArray *)postfixStack binaryDigitMode:(VSBinaryDigitType)binaryDigitMode tokenMap:(NSDictionary *)tokenMap;
 
+#pragma mark RPN Optimization
+
+/**
+ *  Partially evaluates a math expression in postfix notation (RPN), folding every subexpression which does not depend on the
+ *  specified variables into a single numeric token and leaving the rest of the stack symbolic (i.e. sin(π/4)*x+3! becomes
+ *  0.707... x * 6 + with x varying). Impure tokens such as the random number constant are never folded. Evaluating the folded stack
+ *  with any values of the variables yields the same result as evaluating the original stack, so samplers can fold once before
+ *  sampling.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param variables    Variable tokens which will vary (i.e. VS_M_SYMBOL_X_VARIABLE), nil if none.
+ *
+ *  @return The folded postfix stack, nil if the postfix stack is empty.
+ */
++ (NSArray *)postfixStackByFoldingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode variables:(NSSet *)variables;
+
+/**
+ *  Partially evaluates a math expression in postfix notation (RPN) using the specified evaluation options, with the option to replace
+ *  tokens by specifying a token map. Tokens of the token map which are not among the varying variables are replaced by their values
+ *  and folded, tokens which are neither remain symbolic. See VSMathUtil::postfixStackByFoldingPostfixStack:angleMode:variables:.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param variables    Variable tokens which will vary (i.e. VS_M_SYMBOL_X_VARIABLE), nil if none.
+ *  @param tokenMap
+ *  @param options
+ *
+ *  @return The folded postfix stack, nil if the postfix stack is empty.
+ */
++ (NSArray *)postfixStackByFoldingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode variables:(NSSet *)variables tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options;
+
 #pragma mark Expression Evaluation
 
 /**
@@ -682,6 +886,19 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSNumber *)evaluateInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap customVariableSets:(NSArray *)customVariableSets;
 
+/**
+ *  Evalutes the given infix math expression and returns the result with the option to replace tokens by inserting a token map, taking
+ *  into consideration the custom variable sets precompiled in the specified lexer configuration.
+ *
+ *  @param infixExpression
+ *  @param angleMode
+ *  @param tokenMap
+ *  @param lexerConfiguration
+ *
+ *  @return NSNumber result if expression can be evaluated, nil if expression cannot be evaluated (syntax error, etc).
+ */
++ (NSNumber *)evaluateInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration;
+
 /**
  *  Evaluates a math expression in postfix notation for double values.
  *
@@ -704,6 +921,19 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSNumber *)evaluatePostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap;
 
+/**
+ *  Evaluates a math expression in postfix notation for double values with the option to replace tokens by specifying
+ *  a token map, using the specified evaluation options.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param tokenMap
+ *  @param options
+ *
+ *  @return The evaluated NSNumber object, nil if expression is invalid or contains syntax errors.
+ */
++ (NSNumber *)evaluatePostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options;
+
 /**
  *  Evaluates a math expression in postfix notation for unsigned long long values.
  *
@@ -754,6 +984,35 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (NSArray *)samplesFromLinearSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples;
 
+/**
+ *  Performs linear sampling on a math expression f(x) over the specified range, using the specified evaluation options.
+ *
+ *  @param infixExpression
+ *  @param angleMode
+ *  @param xMin
+ *  @param xMax
+ *  @param numberOfSamples
+ *  @param options
+ *
+ *  @return An array of sampled points wrapped in NSValue.
+ */
++ (NSArray *)samplesFromLinearSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples options:(VSMathEvaluationOptions)options;
+
+/**
+ *  Performs linear sampling on a math expression in postfix notation (RPN) f(x) over the specified range, using the specified
+ *  evaluation options.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param xMin
+ *  @param xMax
+ *  @param numberOfSamples
+ *  @param options
+ *
+ *  @return An array of sampled points wrapped in NSValue.
+ */
++ (NSArray *)samplesFromLinearSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples options:(VSMathEvaluationOptions)options;
+
 /**
  *  Performs adaptive sampling on a math expression in infix notation f(x) with specified paramaters.
  *
@@ -764,7 +1023,7 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  @param tolerance       Tolerance to sample to, aka epsilon.
  *  @param depth           Maximum recursion iteration.
  *
- *  @return An array of sampled points wrapped in NSValue objects.
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
  */
 + (NSArray *)samplesFromAdaptiveSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth;
 
@@ -778,10 +1037,42 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  @param tolerance    Tolerance to sample to, aka epsilon.
  *  @param depth        Maximum recursion iteration (8 is optimal).
  *
- *  @return An array of sampled points wrapped in NSValue objects.
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
  */
 + (NSArray *)samplesFromAdaptiveSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth;
 
+/**
+ *  Performs adaptive sampling on a math expression in infix notation f(x) with specified paramaters, using the specified evaluation
+ *  options.
+ *
+ *  @param infixExpression Math expression in infix notation represented in a string.
+ *  @param angleMode       Angle mode (i.e. deg, rad, etc) in which the RPN should be evaluated in.
+ *  @param xMin            Minimum x value to sample.
+ *  @param xMax            Maximum x value to sample (along with xMin, marks the x boundary).
+ *  @param tolerance       Tolerance to sample to, aka epsilon.
+ *  @param depth           Maximum recursion iteration.
+ *  @param options         Evaluation options (i.e. VSMathEvaluationOptionFastArithmetic for plotting).
+ *
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
+ */
++ (NSArray *)samplesFromAdaptiveSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth options:(VSMathEvaluationOptions)options;
+
+/**
+ *  Performs adaptive sampling on a math expression in postfix notation (RPN) f(x) with specified paramaters, using the specified
+ *  evaluation options.
+ *
+ *  @param postfixStack Math expression in postfix notation (RPN) represented in an array.
+ *  @param angleMode    Angle mode (i.e. deg, rad, etc) in which the RPN should be evaluated in.
+ *  @param xMin         Minimum x value to sample.
+ *  @param xMax         Maximum x value to sample (along with xMin, marks the x boundary).
+ *  @param tolerance    Tolerance to sample to, aka epsilon.
+ *  @param depth        Maximum recursion iteration (8 is optimal).
+ *  @param options      Evaluation options (i.e. VSMathEvaluationOptionFastArithmetic for plotting).
+ *
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
+ */
++ (NSArray *)samplesFromAdaptiveSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth options:(VSMathEvaluationOptions)options;
+
 /**
  *  Performs custom sampling on a math expression in infix notation f(x) with specified paramaters.
  *
@@ -793,7 +1084,7 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  @param yMax
  *  @param tolerance
  *
- *  @return An array of sampled points wrapped in NSValue objects.
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
  */
 + (NSArray *)samplesFromCustomSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance;
 
@@ -808,10 +1099,44 @@ NS_ROOT_CLASS @interface VSMathUtil
  *  @param yMax
  *  @param tolerance
  *
- *  @return An array of sampled points wrapped in NSValue objects.
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
  */
 + (NSArray *)samplesFromCustomSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance;
 
+/**
+ *  Performs custom sampling on a math expression in infix notation f(x) with specified paramaters, using the specified evaluation
+ *  options.
+ *
+ *  @param infixExpression
+ *  @param angleMode
+ *  @param xMin
+ *  @param xMax
+ *  @param yMin
+ *  @param yMax
+ *  @param tolerance
+ *  @param options
+ *
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
+ */
++ (NSArray *)samplesFromCustomSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance options:(VSMathEvaluationOptions)options;
+
+/**
+ *  Performs custom sampling on a math expression in postfix notation (RPN) f(x) with specified paramaters, using the specified
+ *  evaluation options.
+ *
+ *  @param postfixStack
+ *  @param angleMode
+ *  @param xMin
+ *  @param xMax
+ *  @param yMin
+ *  @param yMax
+ *  @param tolerance
+ *  @param options
+ *
+ *  @return An array of sampled points wrapped in NSValue objects, nil if the expression contains syntax errors.
+ */
++ (NSArray *)samplesFromCustomSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance options:(VSMathEvaluationOptions)options;
+
 /**
  *  Evaluates the slope between two given points.
  *
@@ -905,6 +1230,24 @@ NS_ROOT_CLASS @interface VSMathUtil
  */
 + (VSMathOperatorUnaryType)operatorUnaryTypeOfOperationType:(VSMathOperationType)operationType;
 
+/**
+ *  Gets the number of operands of an NSString math symbol.
+ *
+ *  @param symbol
+ *
+ *  @return 2 for binary operators, 1 for unary operators and functions, 0 otherwise.
+ */
++ (int)arityOfSymbol:(NSString *)symbol;
+
+/**
+ *  Gets the number of operands of a VSMathSymbolType.
+ *
+ *  @param symbolType
+ *
+ *  @return 2 for binary operators, 1 for unary operators and functions, 0 otherwise.
+ */
++ (int)arityOfSymbolType:(VSMathSymbolType)symbolType;
+
 #pragma mark Enum Translations
 
 /**
@@ -935,7 +1278,9 @@ NS_ROOT_CLASS @interface VSMathUtil
 + (NSString *)symbolWithType:(VSMathSymbolType)symbolType;
 
 /**
- *  Returns the VSMathSymbolType of the corresponding NSString math symbol.
+ *  Returns the VSMathSymbolType of the corresponding NSString math symbol. Symbols are resolved with a single lookup, by address for
+ *  the tokens returned by VSMathUtil::tokensInInfixExpression:customVariableSets: (which are interned to the VS_M_SYMBOL_* instances)
+ *  and by value otherwise.
  *
  *  @param symbol
  *
@@ -6,9 +6,16 @@
  *  http://www.opensource.org/licenses/mit-license.php
  */
 
+#import "vsast.h"
+#import "vscache.h"
+#import "vsdec.h"
+#import "vsexpr.h"
+#import "vslex.h"
 #import "vsmath.h"
 #import "vsmem.h"
 
+#import "VSCompiledExpression.h"
+#import "VSMathLexerConfiguration.h"
 #import "VSMathUtil.h"
 #import "VSStringUtil.h"
 
@@ -194,20 +201,366 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 }
 
+#pragma mark Symbol Descriptors
+
+/**
+ *  Properties of a math symbol, identified by its VSMathSymbolType.
+ */
+typedef struct {
+    VSMathTokenType tokenType;
+    VSMathOperationType operationType;
+    int precedence;
+    VSMathOperatorAssociativeType associativeType;
+    VSMathOperatorUnaryType unaryType;
+    int arity;
+} VSMathSymbolDescriptor;
+
+/**
+ *  Descriptors of all math symbols, indexed by VSMathSymbolType.
+ */
+static const VSMathSymbolDescriptor VS_M_SYMBOL_DESCRIPTORS[VSMathSymbolTypeMaxTypes] = {
+    [VSMathSymbolTypeEqual]                    = { VSMathTokenTypeUnknown,              VSMathOperationTypeEqual,                    1,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeUnknown,      2 },
+    [VSMathSymbolTypeAdd]                      = { VSMathTokenTypeOperator,             VSMathOperationTypeAdd,                      6,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeSubtract]                 = { VSMathTokenTypeOperator,             VSMathOperationTypeSubtract,                 6,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeMultiply]                 = { VSMathTokenTypeOperator,             VSMathOperationTypeMultiply,                 7,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeMultiplyAlternate]        = { VSMathTokenTypeOperator,             VSMathOperationTypeMultiply,                 7,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeDivide]                   = { VSMathTokenTypeOperator,             VSMathOperationTypeDivide,                   7,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeDivideAlternate]          = { VSMathTokenTypeOperator,             VSMathOperationTypeDivide,                   7,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeModulo]                   = { VSMathTokenTypeOperator,             VSMathOperationTypeModulo,                   7,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeExponent]                 = { VSMathTokenTypeOperator,             VSMathOperationTypeExponent,                 8,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeRoot]                     = { VSMathTokenTypeOperator,             VSMathOperationTypeRoot,                     8,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeScientificNotation]       = { VSMathTokenTypeOperator,             VSMathOperationTypeScientificNotation,       8,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeChoose]                   = { VSMathTokenTypeOperator,             VSMathOperationTypeChoose,                   8,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypePick]                     = { VSMathTokenTypeOperator,             VSMathOperationTypePick,                     8,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeNegative]                 = { VSMathTokenTypeUnaryPrefixOperator,  VSMathOperationTypeNegative,                 8,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeUnaryPrefix,  1 },
+    [VSMathSymbolTypeSquare]                   = { VSMathTokenTypeUnaryPostfixOperator, VSMathOperationTypeSquare,                   -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnaryPostfix, 1 },
+    [VSMathSymbolTypeSquareRoot]               = { VSMathTokenTypeUnaryPrefixOperator,  VSMathOperationTypeSquareRoot,               9,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeUnaryPrefix,  1 },
+    [VSMathSymbolTypeCube]                     = { VSMathTokenTypeUnaryPostfixOperator, VSMathOperationTypeCube,                     -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnaryPostfix, 1 },
+    [VSMathSymbolTypeCubeRoot]                 = { VSMathTokenTypeUnaryPrefixOperator,  VSMathOperationTypeCubeRoot,                 9,  VSMathOperatorAssociativeTypeRight,   VSMathOperatorUnaryTypeUnaryPrefix,  1 },
+    [VSMathSymbolTypePercent]                  = { VSMathTokenTypeFunction,             VSMathOperationTypePercent,                  -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeFactorial]                = { VSMathTokenTypeUnaryPostfixOperator, VSMathOperationTypeFactorial,                -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnaryPostfix, 1 },
+    [VSMathSymbolTypeSine]                     = { VSMathTokenTypeFunction,             VSMathOperationTypeSine,                     -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeCosine]                   = { VSMathTokenTypeFunction,             VSMathOperationTypeCosine,                   -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeTangent]                  = { VSMathTokenTypeFunction,             VSMathOperationTypeTangent,                  -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseSine]              = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseSine,              -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseCosine]            = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseCosine,            -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseTangent]           = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseTangent,           -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeHyperbolicSine]           = { VSMathTokenTypeFunction,             VSMathOperationTypeHyperbolicSine,           -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeHyperbolicCosine]         = { VSMathTokenTypeFunction,             VSMathOperationTypeHyperbolicCosine,         -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeHyperbolicTangent]        = { VSMathTokenTypeFunction,             VSMathOperationTypeHyperbolicTangent,        -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseHyperbolicSine]    = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseHyperbolicSine,    -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseHyperbolicCosine]  = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseHyperbolicCosine,  -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeInverseHyperbolicTangent] = { VSMathTokenTypeFunction,             VSMathOperationTypeInverseHyperbolicTangent, -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeNaturalLogarithm]         = { VSMathTokenTypeFunction,             VSMathOperationTypeNaturalLogarithm,         -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeLogarithm10]              = { VSMathTokenTypeFunction,             VSMathOperationTypeLogarithm10,              -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeLogarithm2]               = { VSMathTokenTypeFunction,             VSMathOperationTypeLogarithm2,               -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeAbsoluteValue]            = { VSMathTokenTypeFunction,             VSMathOperationTypeAbsoluteValue,            -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeLeftParenthesis]          = { VSMathTokenTypeParenthesis,          VSMathOperationTypeLeftParenthesis,          -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeRightParenthesis]         = { VSMathTokenTypeParenthesis,          VSMathOperationTypeRightParenthesis,         -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeLeftShift]                = { VSMathTokenTypeFunction,             VSMathOperationTypeLeftShift,                -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeLeftShiftBy]              = { VSMathTokenTypeOperator,             VSMathOperationTypeLeftShiftBy,              5,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeRightShift]               = { VSMathTokenTypeFunction,             VSMathOperationTypeRightShift,               -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeRightShiftBy]             = { VSMathTokenTypeOperator,             VSMathOperationTypeRightShiftBy,             5,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeLeftRotate]               = { VSMathTokenTypeFunction,             VSMathOperationTypeRoL,                      -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeRightRotate]              = { VSMathTokenTypeFunction,             VSMathOperationTypeRoR,                      -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeOnesComplement]           = { VSMathTokenTypeFunction,             VSMathOperationTypeOnesComplement,           -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeTwosComplement]           = { VSMathTokenTypeFunction,             VSMathOperationTypeTwosComplement,           -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeFlipWord]                 = { VSMathTokenTypeFunction,             VSMathOperationTypeFlipWord,                 -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeFlipByte]                 = { VSMathTokenTypeFunction,             VSMathOperationTypeFlipByte,                 -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      1 },
+    [VSMathSymbolTypeAnd]                      = { VSMathTokenTypeOperator,             VSMathOperationTypeAnd,                      4,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeNand]                     = { VSMathTokenTypeOperator,             VSMathOperationTypeNand,                     4,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeOr]                       = { VSMathTokenTypeOperator,             VSMathOperationTypeOr,                       2,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeNor]                      = { VSMathTokenTypeOperator,             VSMathOperationTypeNor,                      2,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeXor]                      = { VSMathTokenTypeOperator,             VSMathOperationTypeXor,                      3,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypeXnor]                     = { VSMathTokenTypeOperator,             VSMathOperationTypeXnor,                     3,  VSMathOperatorAssociativeTypeLeft,    VSMathOperatorUnaryTypeNonUnary,     2 },
+    [VSMathSymbolTypePi]                       = { VSMathTokenTypeConstant,             VSMathOperationTypePi,                       -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeEuler]                    = { VSMathTokenTypeConstant,             VSMathOperationTypeEuler,                    -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeRandomNumber]             = { VSMathTokenTypeConstant,             VSMathOperationTypeRandomNumber,             -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeXVariable]                = { VSMathTokenTypeVariable,             VSMathOperationTypeUnknown,                  -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+    [VSMathSymbolTypeYVariable]                = { VSMathTokenTypeVariable,             VSMathOperationTypeUnknown,                  -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown,      0 },
+};
+
+/**
+ *  Descriptor of unknown symbols.
+ */
+static const VSMathSymbolDescriptor VS_M_UNKNOWN_SYMBOL_DESCRIPTOR = { VSMathTokenTypeUnknown, VSMathOperationTypeUnknown, -1, VSMathOperatorAssociativeTypeUnknown, VSMathOperatorUnaryTypeUnknown, 0 };
+
+/**
+ *  Gets the descriptor of a VSMathSymbolType.
+ *
+ *  @param symbolType
+ *
+ *  @return The descriptor, VS_M_UNKNOWN_SYMBOL_DESCRIPTOR if the symbol type is unknown.
+ */
+static inline const VSMathSymbolDescriptor *VSMathSymbolDescriptorOfSymbolType(VSMathSymbolType symbolType) {
+    if ((symbolType <= VSMathSymbolTypeUnknown) || (symbolType >= VSMathSymbolTypeMaxTypes)) {
+        return &VS_M_UNKNOWN_SYMBOL_DESCRIPTOR;
+    }
+
+    return &VS_M_SYMBOL_DESCRIPTORS[symbolType];
+}
+
+#pragma mark Lexer Tokens
+
+/**
+ *  Gets the UTF-16 characters of a string, borrowing the buffer of the string if possible and copying them otherwise.
+ *
+ *  @param string
+ *  @param length Length of the string.
+ *  @param buffer Receives the copy to free after use, NULL if borrowed.
+ *
+ *  @return The characters, NULL if out of memory.
+ */
+static const UniChar *VSMathUtilCharactersOfString(CFStringRef string, CFIndex length, UniChar **buffer) {
+    const UniChar *characters = CFStringGetCharactersPtr(string);
+
+    *buffer = NULL;
+
+    if (characters == NULL) {
+        *buffer = (UniChar *)malloc(((length > 0) ? length : 1) * sizeof(UniChar));
+
+        if (*buffer == NULL) {
+            return NULL;
+        }
+
+        CFStringGetCharacters(string, CFRangeMake(0, length), *buffer);
+        characters = *buffer;
+    }
+
+    return characters;
+}
+
+/**
+ *  Creates a lexer token standing for a math symbol which is not part of the source expression (i.e. an inserted multiplier).
+ *
+ *  @param symbolType
+ *
+ *  @return The lexer token.
+ */
+static inline vs_lex_token_t VSMathUtilLexTokenOfSymbolType(VSMathSymbolType symbolType) {
+    vs_lex_token_t token = { VSMathSymbolDescriptorOfSymbolType(symbolType)->tokenType, symbolType, 0, 0, NAN };
+
+    return token;
+}
+
+/**
+ *  Gets the string token of a lexer token: the VS_M_SYMBOL_* instance of symbols, a substring of the source expression otherwise.
+ *
+ *  @param token
+ *  @param source
+ *
+ *  @return The string token.
+ */
+static inline NSString *VSMathUtilStringOfLexToken(const vs_lex_token_t *token, NSString *source) {
+    if (token->symbol != VS_LEX_SYMBOL_UNKNOWN) {
+        return [VSMathUtil symbolWithType:(VSMathSymbolType)token->symbol];
+    }
+    else {
+        return [source substringWithRange:NSMakeRange(token->offset, token->length)];
+    }
+}
+
+/**
+ *  Gets the postfix stack token of a lexer token: the value of numeric tokens, the string token otherwise.
+ *
+ *  @param token
+ *  @param source
+ *
+ *  @return The postfix stack token.
+ */
+static inline id VSMathUtilObjectOfLexToken(const vs_lex_token_t *token, NSString *source) {
+    if (token->kind == VS_LEX_KIND_NUMERIC) {
+        return [NSNumber numberWithDouble:token->value];
+    }
+    else {
+        return VSMathUtilStringOfLexToken(token, source);
+    }
+}
+
+/**
+ *  Appends a lexer token to an expression tree as the next token of its postfix notation, with the operation and arity of its symbol.
+ *
+ *  @param tree
+ *  @param token
+ *
+ *  @return YES if appended, NO if out of memory.
+ */
+static inline BOOL VSMathUtilEmitLexToken(vs_ast_t *tree, const vs_lex_token_t *token) {
+    const VSMathSymbolDescriptor *descriptor = VSMathSymbolDescriptorOfSymbolType((VSMathSymbolType)token->symbol);
+
+    return (vs_ast_emit(tree, token, (vs_op_t)descriptor->operationType, descriptor->arity) != VS_AST_NONE);
+}
+
+/**
+ *  Pushes an operator lexer token onto a shunting-yard operator stack, first popping the functions and the operators which take
+ *  precedence over it into the expression tree.
+ *
+ *  @param token
+ *  @param stack
+ *  @param count Number of entries of the operator stack.
+ *  @param tree
+ *
+ *  @return YES if pushed, NO if out of memory.
+ */
+static BOOL VSMathUtilPushLexOperator(const vs_lex_token_t *token, vs_lex_token_t *stack, NSUInteger *count, vs_ast_t *tree) {
+    const VSMathSymbolDescriptor *descriptor = VSMathSymbolDescriptorOfSymbolType((VSMathSymbolType)token->symbol);
+    int stackTopTokenType = (*count > 0) ? stack[*count - 1].kind : VS_LEX_KIND_UNKNOWN;
+    BOOL isLeftAssociative = (descriptor->associativeType == VSMathOperatorAssociativeTypeLeft);
+    BOOL isRightAssociative = (descriptor->associativeType == VSMathOperatorAssociativeTypeRight);
+
+    if ((isLeftAssociative || isRightAssociative) &&
+        ((stackTopTokenType == VS_LEX_KIND_OPERATOR) || (stackTopTokenType == VS_LEX_KIND_UNARY_PREFIX_OPERATOR) || (stackTopTokenType == VS_LEX_KIND_FUNCTION))) {
+        while (*count > 0) {
+            const vs_lex_token_t *top = &stack[*count - 1];
+            int precedence = VSMathSymbolDescriptorOfSymbolType((VSMathSymbolType)top->symbol)->precedence;
+
+            // Left-associative operators yield to operators of equal precedence, right-associative ones do not.
+            if ((top->kind != VS_LEX_KIND_FUNCTION) &&
+                ((isLeftAssociative && (precedence < descriptor->precedence)) || (isRightAssociative && (precedence <= descriptor->precedence)))) {
+                break;
+            }
+
+            (*count)--;
+
+            if (!VSMathUtilEmitLexToken(tree, &stack[*count])) {
+                return NO;
+            }
+        }
+    }
+
+    stack[(*count)++] = *token;
+
+    return YES;
+}
+
+#pragma mark Constant Folding
+
+/**
+ *  Operand of a postfix stack being folded: the index of its first token in the folded stack, and its value if it is constant.
+ */
+typedef struct {
+    NSUInteger start;
+    BOOL isConstant;
+    double value;
+} VSMathFoldingOperand;
+
 #pragma mark -
 
 @implementation VSMathUtil
 
 #pragma mark Math Character Sets
 
-+ (NSCharacterSet *)numericCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:@"0123456789.,"]; }
-+ (NSCharacterSet *)functionCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:@"abcdfghijklmnopqrstuvwz₁₂_"]; }
-+ (NSCharacterSet *)operatorCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@", VS_M_SYMBOL_ADD, VS_M_SYMBOL_SUBTRACT, VS_M_SYMBOL_MULTIPLY, VS_M_SYMBOL_MULTIPLY_ALTERNATE, VS_M_SYMBOL_DIVIDE, VS_M_SYMBOL_DIVIDE_ALTERNATE, VS_M_SYMBOL_EXPONENT, VS_M_SYMBOL_SCIENTIFIC_NOTATION, VS_M_SYMBOL_ROOT, VS_M_SYMBOL_CHOOSE, VS_M_SYMBOL_PICK, VS_M_SYMBOL_LEFT_SHIFT_BY, VS_M_SYMBOL_RIGHT_SHIFT_BY, VS_M_SYMBOL_AND, VS_M_SYMBOL_NAND, VS_M_SYMBOL_OR, VS_M_SYMBOL_NOR, VS_M_SYMBOL_XOR, VS_M_SYMBOL_XNOR]]; }
-+ (NSCharacterSet *)unaryPrefixOperatorCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@", VS_M_SYMBOL_NEGATIVE, VS_M_SYMBOL_SQUARE_ROOT, VS_M_SYMBOL_CUBE_ROOT]]; }
-+ (NSCharacterSet *)unaryPostfixOperatorCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@%@", VS_M_SYMBOL_FACTORIAL, VS_M_SYMBOL_PERCENT, VS_M_SYMBOL_SQUARE, VS_M_SYMBOL_CUBE]]; }
-+ (NSCharacterSet *)constantCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@", VS_M_SYMBOL_PI, VS_M_SYMBOL_EULER, VS_M_SYMBOL_RANDOM_NUMBER]]; }
-+ (NSCharacterSet *)variableCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@", VS_M_SYMBOL_X_VARIABLE, VS_M_SYMBOL_Y_VARIABLE]]; }
-+ (NSCharacterSet *)parenthesisCharacterSet { return [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@", VS_M_SYMBOL_LEFT_PARENTHESIS, VS_M_SYMBOL_RIGHT_PARENTHESIS]]; }
++ (NSCharacterSet *)numericCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:@"0123456789.,"];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)functionCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:@"abcdfghijklmnopqrstuvwz₁₂_"];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)operatorCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@%@", VS_M_SYMBOL_ADD, VS_M_SYMBOL_SUBTRACT, VS_M_SYMBOL_MULTIPLY, VS_M_SYMBOL_MULTIPLY_ALTERNATE, VS_M_SYMBOL_DIVIDE, VS_M_SYMBOL_DIVIDE_ALTERNATE, VS_M_SYMBOL_EXPONENT, VS_M_SYMBOL_SCIENTIFIC_NOTATION, VS_M_SYMBOL_ROOT, VS_M_SYMBOL_CHOOSE, VS_M_SYMBOL_PICK, VS_M_SYMBOL_LEFT_SHIFT_BY, VS_M_SYMBOL_RIGHT_SHIFT_BY, VS_M_SYMBOL_AND, VS_M_SYMBOL_NAND, VS_M_SYMBOL_OR, VS_M_SYMBOL_NOR, VS_M_SYMBOL_XOR, VS_M_SYMBOL_XNOR]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)unaryPrefixOperatorCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@", VS_M_SYMBOL_NEGATIVE, VS_M_SYMBOL_SQUARE_ROOT, VS_M_SYMBOL_CUBE_ROOT]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)unaryPostfixOperatorCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@%@", VS_M_SYMBOL_FACTORIAL, VS_M_SYMBOL_PERCENT, VS_M_SYMBOL_SQUARE, VS_M_SYMBOL_CUBE]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)constantCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@%@", VS_M_SYMBOL_PI, VS_M_SYMBOL_EULER, VS_M_SYMBOL_RANDOM_NUMBER]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)variableCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@", VS_M_SYMBOL_X_VARIABLE, VS_M_SYMBOL_Y_VARIABLE]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
+
++ (NSCharacterSet *)parenthesisCharacterSet {
+    static NSCharacterSet *characterSet = nil;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        characterSet = [NSCharacterSet characterSetWithCharactersInString:[NSString stringWithFormat:@"%@%@", VS_M_SYMBOL_LEFT_PARENTHESIS, VS_M_SYMBOL_RIGHT_PARENTHESIS]];
+#if !__has_feature(objc_arc)
+        [characterSet retain];
+#endif
+    });
+
+    return characterSet;
+}
 
 #pragma mark Bitwise Operations
 
@@ -548,6 +901,20 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     return [VSMathUtil evaluateOperation:operationType angleMode:angleMode operandX:operand operandY:NAN];
 }
 
++ (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operand:(double)operand options:(VSMathEvaluationOptions)options {
+    return [VSMathUtil evaluateOperation:operationType angleMode:angleMode operandX:operand operandY:NAN options:options];
+}
+
++ (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operandX:(double)operandX operandY:(double)operandY options:(VSMathEvaluationOptions)options {
+    // Only operations affected by the options deviate from the default evaluation.
+    if (((options & VSMathEvaluationOptionFastMath) && vs_op_isapprox((vs_op_t)operationType)) ||
+        ((options & VSMathEvaluationOptionFastArithmetic) && vs_op_isarith((vs_op_t)operationType))) {
+        return vs_op_evalm((vs_op_t)operationType, (vs_angle_t)angleMode, (int)options, operandX, operandY);
+    }
+
+    return [VSMathUtil evaluateOperation:operationType angleMode:angleMode operandX:operandX operandY:operandY];
+}
+
 + (double)evaluateOperation:(VSMathOperationType)operationType angleMode:(VSMathAngleModeType)angleMode operandX:(double)operandX operandY:(double)operandY {
     double result = NAN;
 
@@ -555,36 +922,28 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
         case VSMathOperationTypeAdd: {
             if (isnan(operandX)) return NAN;
             if (isnan(operandY)) return NAN;
-            NSDecimalNumber *x = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandX];
-            NSDecimalNumber *y = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandY];
-            result = [[x decimalNumberByAdding:y] doubleValue];
+            result = decadd(operandX, operandY);
             break;
         }
 
         case VSMathOperationTypeSubtract: {
             if (isnan(operandX)) return NAN;
             if (isnan(operandY)) return NAN;
-            NSDecimalNumber *x = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandX];
-            NSDecimalNumber *y = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandY];
-            result = [[x decimalNumberBySubtracting:y] doubleValue];
+            result = decsub(operandX, operandY);
             break;
         }
 
         case VSMathOperationTypeMultiply: {
             if (isnan(operandX)) return NAN;
             if (isnan(operandY)) return NAN;
-            NSDecimalNumber *x = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandX];
-            NSDecimalNumber *y = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandY];
-            result = [[x decimalNumberByMultiplyingBy:y] doubleValue];
+            result = decmul(operandX, operandY);
             break;
         }
 
         case VSMathOperationTypeDivide: {
             if (isnan(operandX)) return NAN;
             if (isnan(operandY)) return NAN;
-            NSDecimalNumber *x = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandX];
-            NSDecimalNumber *y = (NSDecimalNumber *)[NSDecimalNumber numberWithDouble:operandY];
-            result = [[x decimalNumberByDividingBy:y] doubleValue];
+            result = decdiv(operandX, operandY);
             break;
         }
 
@@ -976,9 +1335,17 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
         return nil;
     }
 
+    return [VSMathUtil tokensInInfixExpression:infixExpression lexerConfiguration:[VSMathLexerConfiguration lexerConfigurationWithCustomVariableSets:customVariableSets]];
+}
+
++ (NSArray *)tokensInInfixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    if (infixExpression == nil || infixExpression.length <= 0) {
+        return nil;
+    }
+
     NSMutableArray *tokens = [[NSMutableArray alloc] init];
 
-    if ([VSMathUtil parseInfixExpressionIntoTokens:tokens infixExpression:infixExpression customVariableSets:customVariableSets]) {
+    if ([VSMathUtil parseInfixExpressionIntoTokens:tokens infixExpression:infixExpression lexerConfiguration:lexerConfiguration]) {
 #if !__has_feature(objc_arc)
         return [tokens autorelease];
 #else
@@ -993,6 +1360,10 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (BOOL)parseInfixExpressionIntoTokens:(NSMutableArray *)tokens infixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets {
+    return [VSMathUtil parseInfixExpressionIntoTokens:tokens infixExpression:infixExpression lexerConfiguration:[VSMathLexerConfiguration lexerConfigurationWithCustomVariableSets:customVariableSets]];
+}
+
++ (BOOL)parseInfixExpressionIntoTokens:(NSMutableArray *)tokens infixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
     if (tokens == nil) {
         return NO;
     }
@@ -1002,8 +1373,8 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
         return NO;
     }
 
-    unsigned long range = 1;
-    unsigned long length = infixExpression.length;
+    CFStringRef string = (__bridge CFStringRef)infixExpression;
+    CFIndex length = CFStringGetLength(string);
 
     if (length <= 0) {
         [tokens removeAllObjects];
@@ -1014,61 +1385,27 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
         [tokens removeAllObjects];
     }
 
-    // Begin scanning the expression to capture individual tokens.
-    for (int i = 0; i < length; i++) {
-        BOOL shouldRecordNow = YES;
-        unichar key = [infixExpression characterAtIndex:i];
-        unichar nextKey = (i+1 < length) ? [infixExpression characterAtIndex:i+1] : 0;
-
-        // Ignore white space.
-        if (key == ' ') {
-            continue;
-        }
+    UniChar *buffer = NULL;
+    const UniChar *characters = VSMathUtilCharactersOfString(string, length, &buffer);
+    vs_lex_token_t *lexTokens = (vs_lex_token_t *)malloc(length * sizeof(vs_lex_token_t));
 
-        // Check custom character sets.
-        if (customVariableSets != nil) {
-            unsigned long arrlen = customVariableSets.count;
+    if (characters == NULL || lexTokens == NULL) {
+        free(buffer);
+        free(lexTokens);
 
-            if (arrlen > 0) {
-                for (int j = 0; j < arrlen; j++) {
-                    if (![VSMathUtil _validateCustomVariableSet:customVariableSets[j]]) {
-                        continue;
-                    }
-
-                    NSDictionary *dictionary = (NSDictionary *)customVariableSets[j];
-                    NSCharacterSet *characterSet = (NSCharacterSet *)[dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
-                    unsigned long maxRange = [(NSNumber *)[dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_MAX_RANGE] unsignedLongValue];
-
-                    if (maxRange <= 1) {
-                        continue;
-                    }
-                    else {
-                        if (((i + 1) < length) && ([characterSet characterIsMember:key] && [characterSet characterIsMember:nextKey] && (range < maxRange))) {
-                            range++;
-                            shouldRecordNow = NO;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Check if current char and next char is of character set: numeric/function/variable, if so increase the capture range until a token can be recorded.
-        if ((i+1 < length) &&
-            (([[VSMathUtil numericCharacterSet] characterIsMember:key] && [[VSMathUtil numericCharacterSet] characterIsMember:nextKey]) ||
-             ([[VSMathUtil functionCharacterSet] characterIsMember:key] && [[VSMathUtil functionCharacterSet] characterIsMember:nextKey]))) {
-            shouldRecordNow = NO;
-            range++;
-        }
-
-        if (shouldRecordNow) {
-            NSString *stringToken = [infixExpression substringWithRange:NSMakeRange(i - range + 1, range)];
+        return NO;
+    }
 
-            [tokens addObject:stringToken];
+    size_t numberOfTokens = vs_lex_tokenize(characters, length, lexerConfiguration.sets, lexerConfiguration.numberOfSets, [VSMathUtil _lexerSymbols], lexTokens);
 
-            range = 1;
-        }
+    // Symbols are interned so that later lookups resolve them by address.
+    for (size_t i = 0; i < numberOfTokens; i++) {
+        [tokens addObject:VSMathUtilStringOfLexToken(&lexTokens[i], infixExpression)];
     }
 
+    free(buffer);
+    free(lexTokens);
+
     if (tokens.count <= 0) {
         return NO;
     }
@@ -1077,6 +1414,56 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 }
 
+/**
+ *  @private
+ *
+ *  Gets the symbol table of all math symbols, which lets the lexer resolve symbols and their token types without creating strings.
+ *
+ *  @return The symbol table, NULL if out of memory.
+ */
++ (const vs_lex_symtab_t *)_lexerSymbols {
+    static vs_lex_symtab_t *symbols = NULL;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        symbols = vs_lex_symtab_alloc(VSMathSymbolTypeMaxTypes);
+
+        for (int i = 0; (symbols != NULL) && (i < VSMathSymbolTypeMaxTypes); i++) {
+            CFStringRef symbol = (__bridge CFStringRef)[VSMathUtil symbolWithType:(VSMathSymbolType)i];
+
+            if (symbol == NULL) {
+                continue;
+            }
+
+            UniChar *buffer = NULL;
+            CFIndex length = CFStringGetLength(symbol);
+            const UniChar *characters = VSMathUtilCharactersOfString(symbol, length, &buffer);
+
+            if (characters != NULL) {
+                vs_lex_symtab_add(symbols, characters, length, i, VSMathSymbolDescriptorOfSymbolType((VSMathSymbolType)i)->tokenType);
+            }
+
+            free(buffer);
+        }
+    });
+
+    return symbols;
+}
+
+/**
+ *  @private
+ *
+ *  Converts a lexer token to its postfix stack token, for postfix stacks assembled outside of the shunting-yard algorithm of this class.
+ *
+ *  @param token
+ *  @param source Expression which the token was lexed from.
+ *
+ *  @return The postfix stack token.
+ */
++ (id)_objectOfLexToken:(const vs_lex_token_t *)token source:(NSString *)source {
+    return VSMathUtilObjectOfLexToken(token, source);
+}
+
 + (double)doubleFromToken:(id)token {
     VSMathTokenType tokenType = [VSMathUtil typeOfToken:token];
 
@@ -1138,14 +1525,60 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (NSArray *)postfixStackFromInfixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets {
+    return [VSMathUtil _postfixStackFromInfixExpression:infixExpression customVariableSets:customVariableSets lexerConfiguration:nil];
+}
+
++ (NSArray *)postfixStackFromInfixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    return [VSMathUtil _postfixStackFromInfixExpression:infixExpression customVariableSets:lexerConfiguration.customVariableSets lexerConfiguration:lexerConfiguration];
+}
+
+/**
+ *  @private
+ *
+ *  Converts a string math expression in infix notation to postfix notation (RPN), looking it up in the postfix stack cache first. The
+ *  lexer configuration is only compiled from the custom variable sets on a cache miss, unless specified.
+ *
+ *  @param infixExpression
+ *  @param customVariableSets
+ *  @param lexerConfiguration Lexer configuration of the custom variable sets, nil to compile it when needed.
+ *
+ *  @return The corresponding postfix notation, nil if anything goes wrong.
+ */
++ (NSArray *)_postfixStackFromInfixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    vs_cache_t *cache = [VSMathUtil _postfixStackCache];
+    NSMutableArray *characterSets = nil;
+    NSData *key = nil;
+
+    if (cache != NULL && infixExpression != nil) {
+        characterSets = [NSMutableArray array];
+        key = [VSMathUtil _postfixStackCacheKeyWithInfixExpression:infixExpression customVariableSets:customVariableSets characterSets:characterSets];
+    }
+
+    if (key != nil) {
+        NSArray *entry = CFBridgingRelease(vs_cache_get(cache, key.bytes, key.length));
+
+        if (entry != nil) {
+            return entry[0];
+        }
+    }
+
+    if (lexerConfiguration == nil) {
+        lexerConfiguration = [VSMathLexerConfiguration lexerConfigurationWithCustomVariableSets:customVariableSets];
+    }
+
     NSMutableArray *postfixStack = [[NSMutableArray alloc] init];
 
-    if ([VSMathUtil parseInfixExpressionIntoPostfixStack:postfixStack infixExpression:infixExpression customVariableSets:customVariableSets]) {
-#if !__has_feature(objc_arc)
-        return [postfixStack autorelease];
-#else
-        return postfixStack;
-#endif
+    if ([VSMathUtil parseInfixExpressionIntoPostfixStack:postfixStack infixExpression:infixExpression lexerConfiguration:lexerConfiguration]) {
+        NSArray *output = [NSArray arrayWithArray:postfixStack];
+
+        vs_dealloc(postfixStack);
+
+        // The entry keeps the character sets identified in the key alive, so that their addresses cannot be reused by other sets.
+        if (key != nil) {
+            vs_cache_put(cache, key.bytes, key.length, (__bridge const void *)@[output, characterSets]);
+        }
+
+        return output;
     }
     else {
         vs_dealloc(postfixStack);
@@ -1154,60 +1587,207 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 }
 
++ (unsigned long long)postfixStackCacheHitCount {
+    return vs_cache_hits([VSMathUtil _postfixStackCache]);
+}
+
++ (unsigned long long)postfixStackCacheMissCount {
+    return vs_cache_misses([VSMathUtil _postfixStackCache]);
+}
+
++ (void)clearPostfixStackCache {
+    vs_cache_clear([VSMathUtil _postfixStackCache]);
+}
+
+/**
+ *  @private
+ *
+ *  Gets the shared postfix stack cache.
+ *
+ *  @return The cache, NULL if caching is disabled.
+ */
++ (vs_cache_t *)_postfixStackCache {
+    static vs_cache_t *cache = NULL;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        cache = vs_cache_alloc(VS_M_POSTFIX_STACK_CACHE_CAPACITY, CFRetain, CFRelease);
+    });
+
+    return cache;
+}
+
+/**
+ *  @private
+ *
+ *  Generates the postfix stack cache key of an infix expression: its UTF-8 bytes followed by the character set and max range of every
+ *  valid custom variable set, in the order they are checked by the parser. Immutable character sets are identified by their address,
+ *  which the cache entry keeps alive, and mutable ones by their contents, so that mutating a set after caching cannot return a stale
+ *  postfix stack.
+ *
+ *  @param infixExpression
+ *  @param customVariableSets
+ *  @param characterSets      Receives the character sets identified in the key.
+ *
+ *  @return The key, nil if the expression cannot be cached.
+ */
++ (NSData *)_postfixStackCacheKeyWithInfixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets characterSets:(NSMutableArray *)characterSets {
+    const char *expression = infixExpression.UTF8String;
+
+    if (expression == NULL) {
+        return nil;
+    }
+
+    NSMutableData *key = [NSMutableData dataWithBytes:expression length:strlen(expression) + 1];
+
+    if (customVariableSets != nil) {
+        if (![customVariableSets isKindOfClass:[NSArray class]]) {
+            return nil;
+        }
+
+        for (id customVariableSet in customVariableSets) {
+            if (![VSMathLexerConfiguration validateCustomVariableSet:customVariableSet]) {
+                continue;
+            }
+
+            NSCharacterSet *characterSet = [(NSDictionary *)customVariableSet objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
+            NSCharacterSet *snapshot = [characterSet copy];
+            unsigned long maxRange = [(NSNumber *)[(NSDictionary *)customVariableSet objectForKey:VS_M_DICTIONARY_PROPERTY_MAX_RANGE] unsignedLongValue];
+
+            // Copying an immutable character set returns the same instance.
+            if (snapshot == characterSet) {
+                uint8_t form = 0;
+                uintptr_t address = (uintptr_t)(__bridge void *)characterSet;
+
+                [key appendBytes:&form length:sizeof(form)];
+                [key appendBytes:&address length:sizeof(address)];
+                [characterSets addObject:characterSet];
+            }
+            else {
+                uint8_t form = 1;
+                NSData *bitmap = snapshot.bitmapRepresentation;
+                NSUInteger length = bitmap.length;
+
+                [key appendBytes:&form length:sizeof(form)];
+                [key appendBytes:&length length:sizeof(length)];
+                [key appendData:bitmap];
+            }
+
+            [key appendBytes:&maxRange length:sizeof(maxRange)];
+
+            vs_dealloc(snapshot);
+        }
+    }
+
+    return key;
+}
+
 + (BOOL)parseInfixExpressionIntoPostfixStack:(NSMutableArray *)postfixStack infixExpression:(NSString *)infixExpression {
     return [VSMathUtil parseInfixExpressionIntoPostfixStack:postfixStack infixExpression:infixExpression customVariableSets:nil];
 }
 
 + (BOOL)parseInfixExpressionIntoPostfixStack:(NSMutableArray *)postfixStack infixExpression:(NSString *)infixExpression customVariableSets:(NSArray *)customVariableSets {
+    return [VSMathUtil parseInfixExpressionIntoPostfixStack:postfixStack infixExpression:infixExpression lexerConfiguration:[VSMathLexerConfiguration lexerConfigurationWithCustomVariableSets:customVariableSets]];
+}
+
++ (BOOL)parseInfixExpressionIntoPostfixStack:(NSMutableArray *)postfixStack infixExpression:(NSString *)infixExpression lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
     if (postfixStack == nil) {
         return NO;
     }
 
-    // Parse expression into tokens.
-    NSArray *tokens = [VSMathUtil tokensInInfixExpression:infixExpression customVariableSets:customVariableSets];
+    CFStringRef string = (__bridge CFStringRef)infixExpression;
+    CFIndex length = (infixExpression != nil) ? CFStringGetLength(string) : 0;
 
-    if (tokens == nil || tokens.count <= 0) {
+    if (length <= 0) {
         [postfixStack removeAllObjects];
 
         return NO;
     }
 
-    NSString *currToken = nil;
-    NSString *prevToken = nil;
+    // Lex the expression into one buffer of tokens pointing into its characters. The same buffer holds the operator stack, which never
+    // exceeds 2 entries per token (the token itself and an inserted multiplier).
+    UniChar *buffer = NULL;
+    const UniChar *characters = VSMathUtilCharactersOfString(string, length, &buffer);
+    vs_lex_token_t *tokens = (vs_lex_token_t *)malloc(3 * length * sizeof(vs_lex_token_t));
+    vs_ast_t tree;
 
-    NSMutableArray *stack = [[NSMutableArray alloc] init];
+    if ((characters == NULL) || (tokens == NULL) || !vs_ast_init(&tree, 2 * length)) {
+        free(buffer);
+        free(tokens);
 
-    unsigned long arrlen = tokens.count;
+        [postfixStack removeAllObjects];
 
-    for (int i = 0; i < arrlen; i++) {
-        currToken = (NSString *)tokens[i];
+        return NO;
+    }
+
+    vs_lex_token_t *stack = tokens + length;
+    NSUInteger stackCount = 0;
+    size_t numberOfTokens = vs_lex_tokenize(characters, length, lexerConfiguration.sets, lexerConfiguration.numberOfSets, [VSMathUtil _lexerSymbols], tokens);
+    BOOL succeeded = (numberOfTokens > 0);
+
+    // Build the expression tree in a single pass.
+    for (size_t i = 0; succeeded && (i < numberOfTokens); i++) {
+        const vs_lex_token_t *prevToken = (i > 0) ? &tokens[i - 1] : NULL;
 
         // Try to process the token.
-        if (![VSMathUtil _processShuntingYardToken:currToken andPreviousToken:prevToken stack:stack output:postfixStack customVariableSets:customVariableSets contentAware:YES]) {
-            vs_dealloc(stack);
+        succeeded = [VSMathUtil _processShuntingYardToken:&tokens[i] andPreviousToken:prevToken characters:characters stack:stack count:&stackCount tree:&tree lexerConfiguration:lexerConfiguration contentAware:YES];
+    }
 
-            [postfixStack removeAllObjects];
+    // Pop remaining stack into the tree, stripping out useless left parenthesis symbols.
+    while (succeeded && (stackCount > 0)) {
+        stackCount--;
 
-            return NO;
+        if (stack[stackCount].symbol != VSMathSymbolTypeLeftParenthesis) {
+            succeeded = VSMathUtilEmitLexToken(&tree, &stack[stackCount]);
         }
+    }
 
-        prevToken = currToken;
+    if (succeeded) {
+        succeeded = [VSMathUtil _appendExpressionTree:&tree source:infixExpression toPostfixStack:postfixStack];
     }
 
-    // Pop remaining stack onto output.
-    while (stack.count > 0) {
-        [postfixStack addObject:stack.lastObject];
-        [stack removeLastObject];
+    if (!succeeded) {
+        [postfixStack removeAllObjects];
     }
 
-    // Strip out useless left parenthesis symbols.
-    NSString *leftParenthesisSymbol = [VSMathUtil symbolWithType:VSMathSymbolTypeLeftParenthesis];
+    vs_ast_free(&tree);
+    free(buffer);
+    free(tokens);
 
-    while ([postfixStack containsObject:leftParenthesisSymbol]) {
-        [postfixStack removeObjectAtIndex:[postfixStack indexOfObject:leftParenthesisSymbol]];
+    return succeeded;
+}
+
+/**
+ *  @private
+ *
+ *  Appends the postfix notation of an expression tree to a postfix stack.
+ *
+ *  @param tree
+ *  @param source       Source expression of the lexer tokens of the tree.
+ *  @param postfixStack
+ *
+ *  @return YES if successful, NO if out of memory.
+ */
++ (BOOL)_appendExpressionTree:(const vs_ast_t *)tree source:(NSString *)source toPostfixStack:(NSMutableArray *)postfixStack {
+    size_t *order = (size_t *)malloc(((tree->count > 0) ? tree->count : 1) * sizeof(size_t));
+
+    if (order == NULL) {
+        return NO;
+    }
+
+    size_t n = vs_ast_postfix(tree, order);
+
+    if (n == VS_AST_NONE) {
+        free(order);
+
+        return NO;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        [postfixStack addObject:VSMathUtilObjectOfLexToken(&tree->nodes[order[i]].token, source)];
     }
 
-    vs_dealloc(stack);
+    free(order);
 
     return YES;
 }
@@ -1219,196 +1799,224 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (BOOL)processShuntingYardToken:(id)token stack:(NSMutableArray *)stack output:(NSMutableArray *)output customVariableSets:(NSArray *)customVariableSets {
-    return [VSMathUtil _processShuntingYardToken:token andPreviousToken:nil stack:stack output:output customVariableSets:customVariableSets contentAware:NO];
+    return [VSMathUtil processShuntingYardToken:token stack:stack output:output lexerConfiguration:[VSMathLexerConfiguration lexerConfigurationWithCustomVariableSets:customVariableSets]];
+}
+
++ (BOOL)processShuntingYardToken:(id)token stack:(NSMutableArray *)stack output:(NSMutableArray *)output lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    if ((token == nil) || (stack == nil) || (output == nil)) {
+        return NO;
+    }
+
+    if (![token isKindOfClass:[NSString class]] && ![token isKindOfClass:[NSNumber class]]) {
+        return NO;
+    }
+
+    // Lay the stack out as lexer tokens of a single source string followed by the token. The lexer stack has room for the token and a
+    // copy of the original entries, so that unchanged entries keep their objects.
+    NSUInteger arrlen = stack.count;
+    NSMutableString *source = [NSMutableString string];
+    vs_lex_token_t *lexTokens = (vs_lex_token_t *)malloc((2 * arrlen + 3) * sizeof(vs_lex_token_t));
+    vs_ast_t tree;
+
+    if (lexTokens == NULL) {
+        return NO;
+    }
+
+    if (!vs_ast_init(&tree, arrlen + 1)) {
+        free(lexTokens);
+
+        return NO;
+    }
+
+    vs_lex_token_t *lexToken = &lexTokens[0];
+    vs_lex_token_t *lexStack = &lexTokens[1];
+    vs_lex_token_t *lexOriginals = &lexTokens[arrlen + 3];
+
+    for (NSUInteger i = 0; i <= arrlen; i++) {
+        id object = (i < arrlen) ? stack[i] : token;
+        vs_lex_token_t *t = (i < arrlen) ? &lexStack[i] : lexToken;
+
+        t->offset = source.length;
+        t->length = 0;
+
+        if ([object isKindOfClass:[NSString class]]) {
+            [source appendString:(NSString *)object];
+            t->length = [(NSString *)object length];
+        }
+    }
+
+    UniChar *buffer = NULL;
+    const UniChar *characters = VSMathUtilCharactersOfString((__bridge CFStringRef)source, source.length, &buffer);
+
+    if (characters == NULL) {
+        vs_ast_free(&tree);
+        free(lexTokens);
+
+        return NO;
+    }
+
+    for (NSUInteger i = 0; i <= arrlen; i++) {
+        id object = (i < arrlen) ? stack[i] : token;
+        vs_lex_token_t *t = (i < arrlen) ? &lexStack[i] : lexToken;
+
+        if ([object isKindOfClass:[NSString class]]) {
+            vs_lex_classify(t, characters, [VSMathUtil _lexerSymbols]);
+        }
+        else {
+            t->kind = [object isKindOfClass:[NSNumber class]] ? VS_LEX_KIND_NUMERIC : VS_LEX_KIND_UNKNOWN;
+            t->symbol = VS_LEX_SYMBOL_UNKNOWN;
+            t->value = [object isKindOfClass:[NSNumber class]] ? [(NSNumber *)object doubleValue] : NAN;
+        }
+    }
+
+    memcpy(lexOriginals, lexStack, arrlen * sizeof(vs_lex_token_t));
+
+    NSUInteger count = arrlen;
+    BOOL succeeded = [VSMathUtil _processShuntingYardToken:lexToken andPreviousToken:NULL characters:characters stack:lexStack count:&count tree:&tree lexerConfiguration:lexerConfiguration contentAware:NO];
+
+    // Output the tokens popped into the tree, even if processing failed afterwards.
+    if (![VSMathUtil _appendExpressionTree:&tree source:source toPostfixStack:output]) {
+        succeeded = NO;
+    }
+
+    // Write the lexer stack back, keeping the objects of the entries which were not popped.
+    NSUInteger kept = 0;
+
+    while ((kept < arrlen) && (kept < count) && (memcmp(&lexStack[kept], &lexOriginals[kept], sizeof(vs_lex_token_t)) == 0)) {
+        kept++;
+    }
+
+    [stack removeObjectsInRange:NSMakeRange(kept, arrlen - kept)];
+
+    for (NSUInteger i = kept; i < count; i++) {
+        [stack addObject:VSMathUtilObjectOfLexToken(&lexStack[i], source)];
+    }
+
+    vs_ast_free(&tree);
+    free(buffer);
+    free(lexTokens);
+
+    return succeeded;
 }
 
 /**
  *  @private
  *
- *  Processes token and allocates them to the stack according to shunting-yard rules, with the option to
- *  specify custom variable sets. Setting contentAware as true means each token is processed separately independent
- *  of each other. This process only fails under 3 conditions:
+ *  Processes a lexer token and allocates it to the stack according to shunting-yard rules, with the option to specify a lexer
+ *  configuration of custom variable sets. Tokens leaving the stack are appended to the expression tree, in postfix order. Setting
+ *  contentAware as true means each token is processed separately independent of each other. This process only fails under 3
+ *  conditions:
  *      1. Token is recorded as numeric but the operand is invalid (i.e. 1.2.3.4.5.6)
  *      2. Token is a right parenthesis, but no left parenthesis is found on the stack, hence parenthesis mismatch.
  *      3. Token is unrecognized.
  *
  *  @param token
- *  @param prevToken
- *  @param stack
- *  @param output
- *  @param customVariableSets
+ *  @param prevToken
+ *  @param characters         Characters of the source expression.
+ *  @param stack              Operator stack, must have room for 2 more entries.
+ *  @param count              Number of entries of the operator stack.
+ *  @param tree
+ *  @param lexerConfiguration
  *  @param isContentAware
  *
  *  @return YES if everything went fine, NO if anything went wrong.
  */
-+ (BOOL)_processShuntingYardToken:(id)token andPreviousToken:(id)prevToken stack:(NSMutableArray *)stack output:(NSMutableArray *)output customVariableSets:(NSArray *)customVariableSets contentAware:(BOOL)isContentAware {
-    if ((token == nil) || (stack == nil) || (output == nil)) {
++ (BOOL)_processShuntingYardToken:(const vs_lex_token_t *)token andPreviousToken:(const vs_lex_token_t *)prevToken characters:(const UniChar *)characters stack:(vs_lex_token_t *)stack count:(NSUInteger *)count tree:(vs_ast_t *)tree lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration contentAware:(BOOL)isContentAware {
+    if ((token == NULL) || (stack == NULL) || (count == NULL) || (tree == NULL)) {
         return NO;
     }
 
-    VSMathTokenType tokenType = [VSMathUtil typeOfTokenSubset:token];
-    VSMathTokenType stackTopTokenType = (stack.count > 0) ? [VSMathUtil typeOfTokenSubset:stack.lastObject] : VSMathTokenTypeUnknown;
-
-    switch (tokenType) {
-        case VSMathTokenTypeNumeric: {
-            if ([token isKindOfClass:[NSString class]]) {
-                NSNumber *number = [VSNumberUtil numberFromString:token];
-
-                if (number == nil) {
-                    return NO;
-                }
-                else {
-                    if (isContentAware) {
-                        [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
-                    }
-
-                    [output addObject:number]; // push number to output
-                }
-            }
-            else {
-                if (isContentAware) {
-                    [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
-                }
-
-                [output addObject:token]; // push number to output
-            }
-
-            break;
-        }
+    BOOL isLinkable = isContentAware && [VSMathUtil _validateLinkableToken:prevToken characters:characters lexerConfiguration:lexerConfiguration];
 
-        case VSMathTokenTypeVariable:
-        case VSMathTokenTypeConstant: {
-            if (isContentAware) {
-                [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
+    switch (token->kind) {
+        // Numbers were parsed by the lexer, malformed ones (i.e. 1.2.3.4.5.6) are of an unhandled kind.
+        case VS_LEX_KIND_NUMERIC:
+        case VS_LEX_KIND_VARIABLE:
+        case VS_LEX_KIND_CONSTANT: {
+            if (isLinkable && ![VSMathUtil _insertMultiplierOnStack:stack count:count tree:tree]) {
+                return NO;
             }
 
-            [output addObject:token]; // push variable/constant to output
-            break;
+            return VSMathUtilEmitLexToken(tree, token); // push number/variable/constant to output
         }
 
-        case VSMathTokenTypeUnaryPostfixOperator: {
-            [output addObject:token]; // push unary postfix operator to output
-            break;
+        case VS_LEX_KIND_UNARY_POSTFIX_OPERATOR: {
+            return VSMathUtilEmitLexToken(tree, token); // push unary postfix operator to output
         }
 
-        case VSMathTokenTypeUnaryPrefixOperator:
-        case VSMathTokenTypeFunction: {
+        case VS_LEX_KIND_UNARY_PREFIX_OPERATOR:
+        case VS_LEX_KIND_FUNCTION: {
             // Check if this negative sign should behave like a minus sign.
-            if (isContentAware && ([VSMathUtil typeOfSymbol:token] == VSMathSymbolTypeNegative) && [VSMathUtil _validateLinkableToken:prevToken customVariableSets:customVariableSets]) {
-                if (stackTopTokenType == VSMathTokenTypeOperator || stackTopTokenType == VSMathTokenTypeUnaryPrefixOperator || stackTopTokenType == VSMathTokenTypeFunction) {
-                    while (([VSMathUtil precedenceOfSymbol:stack.lastObject] >= [VSMathUtil precedenceOfSymbol:VS_M_SYMBOL_SUBTRACT]) ||
-                           ([VSMathUtil typeOfTokenSubset:stack.lastObject] == VSMathTokenTypeFunction)) {
-                        [output addObject:stack.lastObject];
-                        [stack removeLastObject];
-                    }
-                }
+            if (isLinkable && (token->symbol == VSMathSymbolTypeNegative)) {
+                vs_lex_token_t subtract = VSMathUtilLexTokenOfSymbolType(VSMathSymbolTypeSubtract);
 
-                [stack addObject:VS_M_SYMBOL_SUBTRACT];
+                return VSMathUtilPushLexOperator(&subtract, stack, count, tree);
             }
-            else {
-                if (isContentAware) {
-                    [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
-                }
 
-                [stack addObject:token]; // push unary prefix operators/functions to stack
+            if (isLinkable && ![VSMathUtil _insertMultiplierOnStack:stack count:count tree:tree]) {
+                return NO;
             }
 
-            break;
+            stack[(*count)++] = *token; // push unary prefix operators/functions to stack
+
+            return YES;
         }
 
-        case VSMathTokenTypeOperator: {
+        case VS_LEX_KIND_OPERATOR: {
             // Check if this minus sign should behave like a negative sign.
-            if (isContentAware && ([VSMathUtil typeOfSymbol:token] == VSMathSymbolTypeSubtract) && ![VSMathUtil _validateLinkableToken:prevToken customVariableSets:customVariableSets]) {
-                [stack addObject:VS_M_SYMBOL_NEGATIVE];
-            }
-            else {
-                if (stackTopTokenType == VSMathTokenTypeOperator || stackTopTokenType == VSMathTokenTypeUnaryPrefixOperator || stackTopTokenType == VSMathTokenTypeFunction) {
-                    // If left-associative.
-                    if ([VSMathUtil operatorAssociativeTypeOfSymbol:token] == VSMathOperatorAssociativeTypeLeft) {
-                        while (([VSMathUtil precedenceOfSymbol:stack.lastObject] >= [VSMathUtil precedenceOfSymbol:token]) ||
-                               ([VSMathUtil typeOfTokenSubset:stack.lastObject] == VSMathTokenTypeFunction)) {
-                            [output addObject:stack.lastObject];
-                            [stack removeLastObject];
-                        }
-                    }
-                    // If right-associative.
-                    else if ([VSMathUtil operatorAssociativeTypeOfSymbol:token] == VSMathOperatorAssociativeTypeRight) {
-                        while (([VSMathUtil precedenceOfSymbol:stack.lastObject] > [VSMathUtil precedenceOfSymbol:token]) ||
-                               ([VSMathUtil typeOfTokenSubset:stack.lastObject] == VSMathTokenTypeFunction)) {
-                            [output addObject:stack.lastObject];
-                            [stack removeLastObject];
-                        }
-                    }
-                }
+            if (isContentAware && !isLinkable && (token->symbol == VSMathSymbolTypeSubtract)) {
+                stack[(*count)++] = VSMathUtilLexTokenOfSymbolType(VSMathSymbolTypeNegative);
 
-                [stack addObject:token];
+                return YES;
             }
 
-            break;
+            return VSMathUtilPushLexOperator(token, stack, count, tree);
         }
 
-        case VSMathTokenTypeParenthesis: {
-            if ([VSMathUtil typeOfSymbol:token] == VSMathSymbolTypeLeftParenthesis) {
-                if (isContentAware) {
-                    [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
+        case VS_LEX_KIND_PARENTHESIS: {
+            if (token->symbol == VSMathSymbolTypeLeftParenthesis) {
+                if (isLinkable && ![VSMathUtil _insertMultiplierOnStack:stack count:count tree:tree]) {
+                    return NO;
                 }
 
-                [stack addObject:token]; // push left-paren to stack
+                stack[(*count)++] = *token; // push left-paren to stack
             }
-            else if ([VSMathUtil typeOfSymbol:token] == VSMathSymbolTypeRightParenthesis) {
+            else if (token->symbol == VSMathSymbolTypeRightParenthesis) {
                 // While stacktop is not left-paren, pop stacktop to ouptut.
-                while ([VSMathUtil typeOfSymbol:stack.lastObject] != VSMathSymbolTypeLeftParenthesis) {
-                    if (stack.count > 0) {
-                        [output addObject:stack.lastObject];
-                        [stack removeLastObject];
-                    }
-                    // Since stack count has reached 0 and there is still no left parenthesis found, there is a misbalance between left and right parenthesis, operation failed.
-                    else {
+                while ((*count > 0) && (stack[*count - 1].symbol != VSMathSymbolTypeLeftParenthesis)) {
+                    (*count)--;
+
+                    if (!VSMathUtilEmitLexToken(tree, &stack[*count])) {
                         return NO;
                     }
                 }
 
-                // Pop stacktop (should be left-paren).
-                if ([VSMathUtil typeOfSymbol:(NSString *)stack.lastObject] == VSMathSymbolTypeLeftParenthesis) {
-                    [stack removeLastObject];
-                }
-                // If no left-paren found, paren mis-match, return error.
-                else {
+                // Since stack count has reached 0 and there is still no left parenthesis found, there is a misbalance between left and right parenthesis, operation failed.
+                if (*count == 0) {
                     return NO;
                 }
 
+                // Pop stacktop (left-paren).
+                (*count)--;
+
                 // Evaluate to see if stacktop is now a function and pop to output if it is.
-                if ((stack.count > 0) && ([VSMathUtil typeOfTokenSubset:stack.lastObject] == VSMathTokenTypeFunction)) {
-                    [output addObject:stack.lastObject];
-                    [stack removeLastObject];
+                if ((*count > 0) && (stack[*count - 1].kind == VS_LEX_KIND_FUNCTION)) {
+                    (*count)--;
+
+                    return VSMathUtilEmitLexToken(tree, &stack[*count]);
                 }
             }
 
-            break;
+            return YES;
         }
 
-        case VSMathTokenTypeUnknown: {
-            if (customVariableSets != nil) {
-                unsigned long arrlen = customVariableSets.count;
-
-                for (int i = 0; i < arrlen; i++) {
-                    if (![VSMathUtil _validateCustomVariableSet:customVariableSets[i]]) {
-                        continue;
-                    }
-
-                    NSDictionary *dictionary = (NSDictionary *)customVariableSets[i];
-                    NSCharacterSet *characterSet = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
-                    NSCharacterSet *tokenSet = [NSCharacterSet characterSetWithCharactersInString:token];
-
-                    if ([characterSet isSupersetOfSet:tokenSet]) {
-                        if (isContentAware) {
-                            [VSMathUtil _insertMultiplierAfterLinkableToken:prevToken stack:stack output:output customVariableSets:customVariableSets];
-                        }
-
-                        [output addObject:token];
-                        return YES;
-                    }
+        case VS_LEX_KIND_UNKNOWN: {
+            if ([lexerConfiguration isCustomVariableWithCharacters:characters + token->offset length:token->length]) {
+                if (isLinkable && ![VSMathUtil _insertMultiplierOnStack:stack count:count tree:tree]) {
+                    return NO;
                 }
+
+                return VSMathUtilEmitLexToken(tree, token);
             }
 
             return NO;
@@ -1418,128 +2026,63 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
             return NO;
         }
     }
-
-    return YES;
 }
 
 /**
  *  @private
  *
- *  Inserts a multiplier after a linkable token (i.e. 2sin(90) == 2*sin(90)).
+ *  Inserts an implicit multiplier after a linkable token (i.e. 2sin(90) == 2*sin(90)).
  *
- *  @param token
  *  @param stack
- *  @param output
- *  @param customVariableSets
+ *  @param count
+ *  @param tree
  *
- *  @return YES if successful, NO otherwise.
+ *  @return YES if successful, NO if out of memory.
  */
-+ (BOOL)_insertMultiplierAfterLinkableToken:(id)token stack:(NSMutableArray *)stack output:(NSMutableArray *)output customVariableSets:(NSArray *)customVariableSets; {
-    if ([VSMathUtil _validateLinkableToken:token customVariableSets:customVariableSets]) {
-        return [VSMathUtil processShuntingYardToken:VS_M_SYMBOL_MULTIPLY stack:stack output:output customVariableSets:customVariableSets];
-    }
-    else {
-        return NO;
-    }
++ (BOOL)_insertMultiplierOnStack:(vs_lex_token_t *)stack count:(NSUInteger *)count tree:(vs_ast_t *)tree {
+    vs_lex_token_t multiplier = VSMathUtilLexTokenOfSymbolType(VSMathSymbolTypeMultiply);
+
+    return VSMathUtilPushLexOperator(&multiplier, stack, count, tree);
 }
 
 /**
  *  @private
  *
- *  Verifies that a given token is product linkable (i.e. 3x = 3*x, meaning that 3 is linkable). Option
- *  to specify custom linkable variable sets.
+ *  Verifies that a given lexer token is product linkable (i.e. 3x = 3*x, meaning that 3 is linkable). Option
+ *  to specify a lexer configuration of custom linkable variable sets.
  *
  *  @param token
- *  @param customVariableSets
+ *  @param characters
+ *  @param lexerConfiguration
  *
  *  @return YES if linkable, NO otherwise.
  */
-+ (BOOL)_validateLinkableToken:(id)token customVariableSets:(NSArray *)customVariableSets {
-    if (token == nil) {
++ (BOOL)_validateLinkableToken:(const vs_lex_token_t *)token characters:(const UniChar *)characters lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    if (token == NULL) {
         return NO;
     }
 
-    if ([token isKindOfClass:[NSNumber class]]) {
+    if (token->kind == VS_LEX_KIND_NUMERIC) {
         return YES;
     }
-    else if ([token isKindOfClass:[NSString class]]) {
-        VSMathTokenType tokenType = [VSMathUtil typeOfToken:token];
-        VSMathSymbolType symbolType = [VSMathUtil typeOfSymbol:token];
-        NSCharacterSet *tokenSet = [NSCharacterSet characterSetWithCharactersInString:token];
-
-        if (tokenType == VSMathTokenTypeNumeric) {
-            return YES;
-        }
-
-        if (customVariableSets != nil) {
-            unsigned long arrlen = customVariableSets.count;
-
-            for (int i = 0; i < arrlen; i++) {
-                if (![VSMathUtil _validateCustomVariableSet:customVariableSets[i]]) {
-                    continue;
-                }
-
-                NSDictionary *dictionary = (NSDictionary *)customVariableSets[i];
-                NSCharacterSet *characterSet = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
-
-                if ([characterSet isSupersetOfSet:tokenSet]) {
-                    return YES;
-                }
-            }
-        }
-
-        switch (symbolType) {
-            case VSMathSymbolTypeXVariable:
-            case VSMathSymbolTypeYVariable:
-            case VSMathSymbolTypeRightParenthesis:
-            case VSMathSymbolTypeFactorial:
-            case VSMathSymbolTypePercent:
-            case VSMathSymbolTypePi:
-            case VSMathSymbolTypeEuler:
-                return YES;
-
-            default:
-                return NO;
-        }
-    }
-    else {
-        return NO;
-    }
-}
-
-/**
- *  @private
- *
- *  Verifies that a custom variable set is valid. A custom variable sets is defined by a NSDictionary object
- *  containing a "characterSet" key (an NSCharacterSet object) and a "maxRange" key (an NSNumber object,
- *  indicating the max character length of the token of associated type).
- *
- *  @param customVariableSet
- *
- *  @return YES if valid, NO otherwise.
- */
-+ (BOOL)_validateCustomVariableSet:(id)customVariableSet {
-    if (customVariableSet == nil) {
-        return NO;
-    }
 
-    if (![customVariableSet isKindOfClass:[NSDictionary class]]) {
-        return NO;
+    if ([lexerConfiguration isCustomVariableWithCharacters:characters + token->offset length:token->length]) {
+        return YES;
     }
 
-    NSDictionary *dictionary = (NSDictionary *)customVariableSet;
-    id characterSet = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_CHARACTER_SET];
-    id maxRange = [dictionary objectForKey:VS_M_DICTIONARY_PROPERTY_MAX_RANGE];
-
-    if ((characterSet == nil) || ![characterSet isKindOfClass:[NSCharacterSet class]]) {
-        return NO;
-    }
+    switch (token->symbol) {
+        case VSMathSymbolTypeXVariable:
+        case VSMathSymbolTypeYVariable:
+        case VSMathSymbolTypeRightParenthesis:
+        case VSMathSymbolTypeFactorial:
+        case VSMathSymbolTypePercent:
+        case VSMathSymbolTypePi:
+        case VSMathSymbolTypeEuler:
+            return YES;
 
-    if ((maxRange == nil) || ![maxRange isKindOfClass:[NSNumber class]]) {
-        return NO;
+        default:
+            return NO;
     }
-
-    return YES;
 }
 
 /**
@@ -1574,13 +2117,17 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (NSArray *)postfixStackByTruncatingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap {
+    return [VSMathUtil postfixStackByTruncatingPostfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap options:VSMathEvaluationOptionNone];
+}
+
++ (NSArray *)postfixStackByTruncatingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options {
     if ((postfixStack == nil) || (postfixStack.count <= 0)) {
         return nil;
     }
 
     NSMutableArray *truncatedPostfixStack = [[NSMutableArray alloc] init];
 
-    if ([VSMathUtil truncatePostfixStackIntoPostfixStack:truncatedPostfixStack postfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap]) {
+    if ([VSMathUtil truncatePostfixStackIntoPostfixStack:truncatedPostfixStack postfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap options:options]) {
 #if !__has_feature(objc_arc)
         return [truncatedPostfixStack autorelease];
 #else
@@ -1622,6 +2169,10 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (BOOL)truncatePostfixStackIntoPostfixStack:(NSMutableArray *)truncatedPostfixStack postfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap; {
+    return [VSMathUtil truncatePostfixStackIntoPostfixStack:truncatedPostfixStack postfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap options:VSMathEvaluationOptionNone];
+}
+
++ (BOOL)truncatePostfixStackIntoPostfixStack:(NSMutableArray *)truncatedPostfixStack postfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options {
     if (truncatedPostfixStack == nil) {
         return NO;
     }
@@ -1673,7 +2224,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
                 }
 
                 double tempOperand = [VSMathUtil doubleFromToken:[VSMathUtil _popNumericTokenOnStack:truncatedPostfixStack]];
-                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operand:tempOperand];
+                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operand:tempOperand options:options];
 
                 [truncatedPostfixStack addObject:[NSNumber numberWithDouble:tempResult]];
                 break;
@@ -1687,7 +2238,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
                 }
 
                 double tempOperand = [VSMathUtil doubleFromToken:[VSMathUtil _popNumericTokenOnStack:truncatedPostfixStack]];
-                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operand:tempOperand];
+                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operand:tempOperand options:options];
 
                 [truncatedPostfixStack addObject:[NSNumber numberWithDouble:tempResult]];
                 break;
@@ -1701,7 +2252,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 
                 double tempOperand = [VSMathUtil doubleFromToken:[VSMathUtil _popNumericTokenOnStack:truncatedPostfixStack]];
                 double stackOperand = [VSMathUtil doubleFromToken:[VSMathUtil _popNumericTokenOnStack:truncatedPostfixStack]];
-                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operandX:stackOperand operandY:tempOperand];
+                double tempResult = [VSMathUtil evaluateOperation:[VSMathUtil operationTypeOfSymbol:token] angleMode:angleMode operandX:stackOperand operandY:tempOperand options:options];
 
                 [truncatedPostfixStack addObject:[NSNumber numberWithDouble:tempResult]];
                 break;
@@ -1881,6 +2432,120 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 }
 
+#pragma mark RPN Optimization
+
++ (NSArray *)postfixStackByFoldingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode variables:(NSSet *)variables {
+    return [VSMathUtil postfixStackByFoldingPostfixStack:postfixStack angleMode:angleMode variables:variables tokenMap:nil options:VSMathEvaluationOptionNone];
+}
+
++ (NSArray *)postfixStackByFoldingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode variables:(NSSet *)variables tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options {
+    if ((postfixStack == nil) || (postfixStack.count <= 0)) {
+        return nil;
+    }
+
+    NSUInteger arrlen = postfixStack.count;
+    VSMathFoldingOperand *operands = (VSMathFoldingOperand *)malloc(arrlen * sizeof(VSMathFoldingOperand));
+
+    if (operands == NULL) {
+        return nil;
+    }
+
+    NSMutableArray *foldedPostfixStack = [[NSMutableArray alloc] initWithCapacity:arrlen];
+    NSUInteger count = 0;
+
+    for (id token in postfixStack) {
+        VSMathTokenType tokenType = [VSMathUtil typeOfToken:token];
+        VSMathFoldingOperand operand = { foldedPostfixStack.count, NO, NAN };
+        int arity = 0;
+
+        switch (tokenType) {
+            case VSMathTokenTypeNumeric: {
+                operand.isConstant = YES;
+                operand.value = [VSMathUtil doubleFromToken:token];
+                break;
+            }
+
+            case VSMathTokenTypeConstant: {
+                // The random number is drawn on every evaluation.
+                operand.isConstant = ([VSMathUtil typeOfSymbol:token] != VSMathSymbolTypeRandomNumber);
+                operand.value = [VSMathUtil doubleFromToken:token];
+                break;
+            }
+
+            case VSMathTokenTypeUnaryPrefixOperator:
+            case VSMathTokenTypeUnaryPostfixOperator:
+            case VSMathTokenTypeFunction: {
+                arity = 1;
+                break;
+            }
+
+            case VSMathTokenTypeOperator: {
+                arity = 2;
+                break;
+            }
+
+            case VSMathTokenTypeParenthesis: {
+                // Ignore, as if they never existed.
+                continue;
+            }
+
+            default: {
+                // Variables and custom variables are replaced by their values unless they vary.
+                id replacementToken = ((tokenMap != nil) && ![variables containsObject:token]) ? [tokenMap objectForKey:token] : nil;
+
+                if (replacementToken != nil) {
+                    operand.isConstant = YES;
+                    operand.value = [replacementToken isKindOfClass:[NSNumber class]] ? [(NSNumber *)replacementToken doubleValue] : [VSMathUtil doubleFromToken:replacementToken];
+                }
+
+                break;
+            }
+        }
+
+        if (arity > 0) {
+            // Operands missing from malformed stacks are left out, so that the operation is kept symbolic.
+            NSUInteger n = MIN((NSUInteger)arity, count);
+            BOOL isConstant = (n == (NSUInteger)arity);
+
+            for (NSUInteger i = count - n; i < count; i++) {
+                isConstant = isConstant && operands[i].isConstant;
+            }
+
+            if (n > 0) {
+                operand.start = operands[count - n].start;
+            }
+
+            if (isConstant) {
+                VSMathOperationType operationType = [VSMathUtil operationTypeOfSymbol:token];
+
+                operand.isConstant = YES;
+
+                if (arity == 1) {
+                    operand.value = [VSMathUtil evaluateOperation:operationType angleMode:angleMode operand:operands[count - 1].value options:options];
+                }
+                else {
+                    operand.value = [VSMathUtil evaluateOperation:operationType angleMode:angleMode operandX:operands[count - 2].value operandY:operands[count - 1].value options:options];
+                }
+
+                [foldedPostfixStack removeObjectsInRange:NSMakeRange(operand.start, foldedPostfixStack.count - operand.start)];
+            }
+
+            count -= n;
+        }
+
+        [foldedPostfixStack addObject:(operand.isConstant ? [NSNumber numberWithDouble:operand.value] : token)];
+        operands[count++] = operand;
+    }
+
+    free(operands);
+
+#if !__has_feature(objc_arc)
+    return [foldedPostfixStack autorelease];
+#else
+    return foldedPostfixStack;
+#endif
+}
+
 #pragma mark Expression Evaluation
 
 + (NSNumber *)evaluateInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode {
@@ -1891,12 +2556,20 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     return [VSMathUtil evaluatePostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression customVariableSets:customVariableSets] angleMode:angleMode tokenMap:tokenMap];
 }
 
++ (NSNumber *)evaluateInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap lexerConfiguration:(VSMathLexerConfiguration *)lexerConfiguration {
+    return [VSMathUtil evaluatePostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression lexerConfiguration:lexerConfiguration] angleMode:angleMode tokenMap:tokenMap];
+}
+
 + (NSNumber *)evaluatePostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode {
     return [VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:nil];
 }
 
 + (NSNumber *)evaluatePostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap {
-    NSArray *truncatedRPN = [VSMathUtil postfixStackByTruncatingPostfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap];
+    return [VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap options:VSMathEvaluationOptionNone];
+}
+
++ (NSNumber *)evaluatePostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode tokenMap:(NSDictionary *)tokenMap options:(VSMathEvaluationOptions)options {
+    NSArray *truncatedRPN = [VSMathUtil postfixStackByTruncatingPostfixStack:postfixStack angleMode:angleMode tokenMap:tokenMap options:options];
 
     if (truncatedRPN == nil) {
         return nil;
@@ -1940,32 +2613,63 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (NSArray *)samplesFromLinearSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples {
-    NSMutableArray *samples = [[NSMutableArray alloc] init];
+    return [VSMathUtil samplesFromLinearSamplingPostfixStack:postfixStack angleMode:angleMode xMin:xMin xMax:xMax numberOfSamples:numberOfSamples options:VSMathEvaluationOptionNone];
+}
+
++ (NSArray *)samplesFromLinearSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples options:(VSMathEvaluationOptions)options {
+    return [VSMathUtil samplesFromLinearSamplingPostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression] angleMode:angleMode xMin:xMin xMax:xMax numberOfSamples:numberOfSamples options:options];
+}
+
++ (NSArray *)samplesFromLinearSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax numberOfSamples:(int)numberOfSamples options:(VSMathEvaluationOptions)options {
+    // Fold the subexpressions independent of x, then compile once and evaluate the whole range as a column instead of re-evaluating the
+    // postfix stack per sample.
+    NSArray *foldedPostfixStack = [VSMathUtil postfixStackByFoldingPostfixStack:postfixStack angleMode:angleMode variables:[NSSet setWithObject:VS_M_SYMBOL_X_VARIABLE] tokenMap:nil options:options];
+    VSCompiledExpression *expression = [VSCompiledExpression compiledExpressionWithPostfixStack:foldedPostfixStack angleMode:angleMode options:options];
 
-    // Determine the ranges.
-    double xStep = (xMax - xMin) / numberOfSamples;
+    // Check for syntax error.
+    if (expression == nil) return nil;
 
-    for (int i = 0; i < numberOfSamples; i++) {
-        double x = xMin + (xStep * i);
-        NSNumber *output = [VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:x], [VSMathUtil symbolWithType:VSMathSymbolTypeXVariable], nil]];
+    NSUInteger count = (numberOfSamples > 0) ? (NSUInteger)numberOfSamples : 0;
+    NSMutableArray *samples = [[NSMutableArray alloc] initWithCapacity:count];
 
-        // Check for syntax error.
-        if (output == nil) {
+    if (count > 0) {
+        double *xs = (double *)malloc(sizeof(double) * count * 2);
+
+        if (xs == NULL) {
             vs_dealloc(samples);
 
             return nil;
         }
 
-        double y = [VSMathUtil doubleFromToken:output];
+        double *ys = xs + count;
+
+        // Determine the ranges.
+        double xStep = (xMax - xMin) / numberOfSamples;
+
+        for (NSUInteger i = 0; i < count; i++) {
+            xs[i] = xMin + (xStep * i);
+        }
+
+        // Check for unbound custom variables.
+        if ([expression evaluateWithXValues:xs results:ys count:count] != VSCompiledExpressionStatusTypeSuccess) {
+            free(xs);
+            vs_dealloc(samples);
+
+            return nil;
+        }
 
-        CGPoint sample = CGPointMake(x, y);
+        for (NSUInteger i = 0; i < count; i++) {
+            CGPoint sample = CGPointMake(xs[i], ys[i]);
 
 #if ! TARGET_OS_MAC
-        [samples addObject:[NSValue valueWithCGPoint:sample]];
+            [samples addObject:[NSValue valueWithCGPoint:sample]];
 #else
-        [samples addObject:[NSValue valueWithBytes:&sample objCType:@encode(CGPoint)]];
-    }
+            [samples addObject:[NSValue valueWithBytes:&sample objCType:@encode(CGPoint)]];
 #endif
+        }
+
+        free(xs);
+    }
 
 #if !__has_feature(objc_arc)
     return [samples autorelease];
@@ -1979,6 +2683,38 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (NSArray *)samplesFromAdaptiveSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth {
+    return [VSMathUtil samplesFromAdaptiveSamplingPostfixStack:postfixStack angleMode:angleMode xMin:xMin xMax:xMax tolerance:tolerance depth:depth options:VSMathEvaluationOptionNone];
+}
+
++ (NSArray *)samplesFromAdaptiveSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth options:(VSMathEvaluationOptions)options {
+    return [VSMathUtil samplesFromAdaptiveSamplingPostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression] angleMode:angleMode xMin:xMin xMax:xMax tolerance:tolerance depth:depth options:options];
+}
+
++ (NSArray *)samplesFromAdaptiveSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth options:(VSMathEvaluationOptions)options {
+    // Fold the subexpressions independent of x, then compile once so that repeated subexpressions are evaluated once per sample.
+    NSArray *foldedPostfixStack = [VSMathUtil postfixStackByFoldingPostfixStack:postfixStack angleMode:angleMode variables:[NSSet setWithObject:VS_M_SYMBOL_X_VARIABLE] tokenMap:nil options:options];
+    VSCompiledExpression *expression = [VSCompiledExpression compiledExpressionWithPostfixStack:foldedPostfixStack angleMode:angleMode options:options];
+
+    // Check for syntax error.
+    if (expression == nil) return nil;
+
+    return [VSMathUtil _samplesFromAdaptiveSamplingExpression:expression xMin:xMin xMax:xMax tolerance:tolerance depth:depth];
+}
+
+/**
+ *  @private
+ *
+ *  Samples a compiled math expression adaptively. See VSMathUtil::samplesFromAdaptiveSamplingPostfixStack:angleMode:xMin:xMax:tolerance:depth:.
+ *
+ *  @param expression
+ *  @param xMin
+ *  @param xMax
+ *  @param tolerance
+ *  @param depth
+ *
+ *  @return An array of samples.
+ */
++ (NSArray *)_samplesFromAdaptiveSamplingExpression:(VSCompiledExpression *)expression xMin:(double)xMin xMax:(double)xMax tolerance:(double)tolerance depth:(int)depth {
     if (isnan(tolerance) || tolerance <= 0.0) tolerance = DBL_EPSILON;
 
     double xa  = xMin;
@@ -1986,11 +2722,11 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     double xc  = xMax;
     double xab = xa + (xb - xa) / 2;
     double xbc = xb + (xc - xb) / 2;
-    double ya  = [[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:xa], VS_M_SYMBOL_X_VARIABLE, nil]] doubleValue];
-    double yb  = [[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:xb], VS_M_SYMBOL_X_VARIABLE, nil]] doubleValue];
-    double yc  = [[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:xc], VS_M_SYMBOL_X_VARIABLE, nil]] doubleValue];
-    double yab = [[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:xab], VS_M_SYMBOL_X_VARIABLE, nil]] doubleValue];
-    double ybc = [[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:xbc], VS_M_SYMBOL_X_VARIABLE, nil]] doubleValue];
+    double ya  = [expression evaluateWithX:xa y:NAN status:NULL];
+    double yb  = [expression evaluateWithX:xb y:NAN status:NULL];
+    double yc  = [expression evaluateWithX:xc y:NAN status:NULL];
+    double yab = [expression evaluateWithX:xab y:NAN status:NULL];
+    double ybc = [expression evaluateWithX:xbc y:NAN status:NULL];
 
     CGPoint p1 = CGPointMake(xa, ya);
     CGPoint p2 = CGPointMake(xab, yab);
@@ -2055,9 +2791,9 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 
     // Refinements needed.
-    NSMutableArray *leftSamples = [NSMutableArray arrayWithArray:[VSMathUtil samplesFromAdaptiveSamplingPostfixStack:postfixStack angleMode:angleMode xMin:xa xMax:xb tolerance:tolerance*2 depth:depth-1]];
+    NSMutableArray *leftSamples = [NSMutableArray arrayWithArray:[VSMathUtil _samplesFromAdaptiveSamplingExpression:expression xMin:xa xMax:xb tolerance:tolerance*2 depth:depth-1]];
     [leftSamples removeLastObject];
-    NSArray *rightSamples = [VSMathUtil samplesFromAdaptiveSamplingPostfixStack:postfixStack angleMode:angleMode xMin:xb xMax:xc tolerance:tolerance*2 depth:depth-1];
+    NSArray *rightSamples = [VSMathUtil _samplesFromAdaptiveSamplingExpression:expression xMin:xb xMax:xc tolerance:tolerance*2 depth:depth-1];
 
     return [leftSamples arrayByAddingObjectsFromArray:rightSamples];
 }
@@ -2067,8 +2803,23 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (NSArray *)samplesFromCustomSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance {
+    return [VSMathUtil samplesFromCustomSamplingPostfixStack:postfixStack angleMode:angleMode xMin:xMin xMax:xMax yMin:yMin yMax:yMax tolerance:tolerance options:VSMathEvaluationOptionNone];
+}
+
++ (NSArray *)samplesFromCustomSamplingInfixExpression:(NSString *)infixExpression angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance options:(VSMathEvaluationOptions)options {
+    return [VSMathUtil samplesFromCustomSamplingPostfixStack:[VSMathUtil postfixStackFromInfixExpression:infixExpression] angleMode:angleMode xMin:xMin xMax:xMax yMin:yMin yMax:yMax tolerance:tolerance options:options];
+}
+
++ (NSArray *)samplesFromCustomSamplingPostfixStack:(NSArray *)postfixStack angleMode:(VSMathAngleModeType)angleMode xMin:(double)xMin xMax:(double)xMax yMin:(double)yMin yMax:(double)yMax tolerance:(double)tolerance options:(VSMathEvaluationOptions)options {
     if (isnan(tolerance)) tolerance = FLT_EPSILON;
 
+    // Fold the subexpressions independent of x, then compile once so that repeated subexpressions are evaluated once per sample.
+    NSArray *foldedPostfixStack = [VSMathUtil postfixStackByFoldingPostfixStack:postfixStack angleMode:angleMode variables:[NSSet setWithObject:VS_M_SYMBOL_X_VARIABLE] tokenMap:nil options:options];
+    VSCompiledExpression *expression = [VSCompiledExpression compiledExpressionWithPostfixStack:foldedPostfixStack angleMode:angleMode options:options];
+
+    // Check for syntax error.
+    if (expression == nil) return nil;
+
     NSMutableArray *samples = [[NSMutableArray alloc] init];
 
     double x     = xMin;
@@ -2077,7 +2828,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     double currY = NAN;
 
     while (x < xMax) {
-        currY = [VSMathUtil doubleFromToken:[VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:[NSDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithDouble:x], VS_M_SYMBOL_X_VARIABLE, nil]]];
+        currY = [expression evaluateWithX:x y:NAN status:NULL];
 
         if ((xStep > tolerance) && fisbounded(currY, yMin, yMax) && !fisbounded(prevY, yMin, yMax)) {
             x -= xStep;
@@ -2152,7 +2903,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (int)precedenceOfSymbolType:(VSMathSymbolType)symbolType {
-    return [VSMathUtil precedenceOfOperationType:[VSMathUtil operationTypeOfSymbolType:symbolType]];
+    return VSMathSymbolDescriptorOfSymbolType(symbolType)->precedence;
 }
 
 + (int)precedenceOfOperationType:(VSMathOperationType)operationType {
@@ -2207,7 +2958,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (VSMathOperatorAssociativeType)operatorAssociativeTypeOfSymbolType:(VSMathSymbolType)symbolType {
-    return [VSMathUtil operatorAssociativeTypeOfOperationType:[VSMathUtil operationTypeOfSymbolType:symbolType]];
+    return VSMathSymbolDescriptorOfSymbolType(symbolType)->associativeType;
 }
 
 + (VSMathOperatorAssociativeType)operatorAssociativeTypeOfOperationType:(VSMathOperationType)operationType {
@@ -2244,11 +2995,11 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (VSMathOperatorUnaryType)operatorUnaryTypeOfSymbol:(NSString *)symbol {
-    return [VSMathUtil operatorUnaryTypeOfOperationType:[VSMathUtil operationTypeOfSymbol:symbol]];
+    return [VSMathUtil operatorUnaryTypeOfSymbolType:[VSMathUtil typeOfSymbol:symbol]];
 }
 
 + (VSMathOperatorUnaryType)operatorUnaryTypeOfSymbolType:(VSMathSymbolType)symbolType {
-    return [VSMathUtil operatorUnaryTypeOfOperationType:[VSMathUtil operationTypeOfSymbolType:symbolType]];
+    return VSMathSymbolDescriptorOfSymbolType(symbolType)->unaryType;
 }
 
 + (VSMathOperatorUnaryType)operatorUnaryTypeOfOperationType:(VSMathOperationType)operationType {
@@ -2289,6 +3040,14 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
     }
 }
 
++ (int)arityOfSymbol:(NSString *)symbol {
+    return [VSMathUtil arityOfSymbolType:[VSMathUtil typeOfSymbol:symbol]];
+}
+
++ (int)arityOfSymbolType:(VSMathSymbolType)symbolType {
+    return VSMathSymbolDescriptorOfSymbolType(symbolType)->arity;
+}
+
 #pragma mark Enum Translations
 
 + (VSMathTokenType)typeOfToken:(id)token {
@@ -2299,78 +3058,10 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
         return VSMathTokenTypeNumeric;
     }
     else if ([token isKindOfClass:[NSString class]]) {
-        if (([token isEqualToString:VS_M_SYMBOL_ADD]) ||
-            ([token isEqualToString:VS_M_SYMBOL_SUBTRACT]) ||
-            ([token isEqualToString:VS_M_SYMBOL_MULTIPLY]) ||
-            ([token isEqualToString:VS_M_SYMBOL_MULTIPLY_ALTERNATE]) ||
-            ([token isEqualToString:VS_M_SYMBOL_DIVIDE]) ||
-            ([token isEqualToString:VS_M_SYMBOL_DIVIDE_ALTERNATE]) ||
-            ([token isEqualToString:VS_M_SYMBOL_EXPONENT]) ||
-            ([token isEqualToString:VS_M_SYMBOL_ROOT]) ||
-            ([token isEqualToString:VS_M_SYMBOL_MODULO]) ||
-            ([token isEqualToString:VS_M_SYMBOL_SCIENTIFIC_NOTATION]) ||
-            ([token isEqualToString:VS_M_SYMBOL_CHOOSE]) ||
-            ([token isEqualToString:VS_M_SYMBOL_PICK]) ||
-            ([token isEqualToString:VS_M_SYMBOL_ADD]) ||
-            ([token isEqualToString:VS_M_SYMBOL_LEFT_SHIFT_BY]) ||
-            ([token isEqualToString:VS_M_SYMBOL_RIGHT_SHIFT_BY]) ||
-            ([token isEqualToString:VS_M_SYMBOL_AND]) ||
-            ([token isEqualToString:VS_M_SYMBOL_NAND]) ||
-            ([token isEqualToString:VS_M_SYMBOL_OR]) ||
-            ([token isEqualToString:VS_M_SYMBOL_NOR]) ||
-            ([token isEqualToString:VS_M_SYMBOL_XOR]) ||
-            ([token isEqualToString:VS_M_SYMBOL_XNOR])) {
-            return VSMathTokenTypeOperator;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_NEGATIVE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_SQUARE_ROOT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_CUBE_ROOT])) {
-            return VSMathTokenTypeUnaryPrefixOperator;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_SQUARE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_CUBE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_FACTORIAL])) {
-            return VSMathTokenTypeUnaryPostfixOperator;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_SINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_COSINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_TANGENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_SINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_COSINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_TANGENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_HYPERBOLIC_SINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_HYPERBOLIC_COSINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_HYPERBOLIC_TANGENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_SINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_COSINE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_TANGENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_NATURAL_LOGARITHM]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_LOGARITHM_10]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_LOGARITHM_2]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_ABSOLUTE_VALUE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_PERCENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_LEFT_SHIFT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_RIGHT_SHIFT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_LEFT_ROTATE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_RIGHT_ROTATE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_ONES_COMPLEMENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_TWOS_COMPLEMENT]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_FLIP_WORD]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_FLIP_BYTE])) {
-            return VSMathTokenTypeFunction;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_LEFT_PARENTHESIS]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_RIGHT_PARENTHESIS])) {
-            return VSMathTokenTypeParenthesis;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_PI]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_RANDOM_NUMBER]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_EULER])) {
-            return VSMathTokenTypeConstant;
-        }
-        else if (([token isEqualToString:VS_M_SYMBOL_X_VARIABLE]) ||
-                 ([token isEqualToString:VS_M_SYMBOL_Y_VARIABLE])) {
-            return VSMathTokenTypeVariable;
+        VSMathSymbolType symbolType = [VSMathUtil typeOfSymbol:token];
+
+        if (symbolType != VSMathSymbolTypeUnknown) {
+            return VSMathSymbolDescriptorOfSymbolType(symbolType)->tokenType;
         }
         else if ([VSNumberUtil numberFromString:token] != nil) {
             return VSMathTokenTypeNumeric;
@@ -2392,35 +3083,20 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 
     if (tokenType == VSMathTokenTypeUnknown) {
         if ([tokenSubset isKindOfClass:[NSString class]]) {
-            NSCharacterSet *cs = [NSCharacterSet characterSetWithCharactersInString:(NSString *)tokenSubset];
+            CFStringRef string = (__bridge CFStringRef)tokenSubset;
+            CFIndex length = CFStringGetLength(string);
+            UniChar *buffer = NULL;
+            const UniChar *characters = VSMathUtilCharactersOfString(string, length, &buffer);
 
-            if ([[VSMathUtil numericCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeNumeric;
-            }
-            else if ([[VSMathUtil functionCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeFunction;
-            }
-            else if ([[VSMathUtil operatorCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeOperator;
-            }
-            else if ([[VSMathUtil unaryPostfixOperatorCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeUnaryPostfixOperator;
-            }
-            else if ([[VSMathUtil unaryPrefixOperatorCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeUnaryPrefixOperator;
-            }
-            else if ([[VSMathUtil constantCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeConstant;
-            }
-            else if ([[VSMathUtil parenthesisCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeParenthesis;
-            }
-            else if ([[VSMathUtil variableCharacterSet] isSupersetOfSet:cs]) {
-                return VSMathTokenTypeVariable;
-            }
-            else {
+            if (characters == NULL) {
                 return VSMathTokenTypeUnknown;
             }
+
+            int classes = vs_lex_classes(characters, length);
+
+            free(buffer);
+
+            return (VSMathTokenType)vs_lex_kind(classes);
         }
         else {
             return VSMathTokenTypeUnknown;
@@ -2497,67 +3173,38 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (VSMathSymbolType)typeOfSymbol:(NSString *)symbol {
-    if      (symbol == nil)                                                   return VSMathSymbolTypeUnknown;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_EQUAL])                      return VSMathSymbolTypeEqual;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_ADD])                        return VSMathSymbolTypeAdd;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_SUBTRACT])                   return VSMathSymbolTypeSubtract;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_MULTIPLY])                   return VSMathSymbolTypeMultiply;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_MULTIPLY_ALTERNATE])         return VSMathSymbolTypeMultiplyAlternate;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_DIVIDE])                     return VSMathSymbolTypeDivide;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_DIVIDE_ALTERNATE])           return VSMathSymbolTypeDivideAlternate;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_EXPONENT])                   return VSMathSymbolTypeExponent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_ROOT])                       return VSMathSymbolTypeRoot;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_SCIENTIFIC_NOTATION])        return VSMathSymbolTypeScientificNotation;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_CHOOSE])                     return VSMathSymbolTypeChoose;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_PICK])                       return VSMathSymbolTypePick;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_NEGATIVE])                   return VSMathSymbolTypeNegative;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_SQUARE])                     return VSMathSymbolTypeSquare;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_SQUARE_ROOT])                return VSMathSymbolTypeSquareRoot;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_CUBE_ROOT])                  return VSMathSymbolTypeCubeRoot;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_CUBE])                       return VSMathSymbolTypeCube;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_PERCENT])                    return VSMathSymbolTypePercent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_MODULO])                     return VSMathSymbolTypeModulo;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_FACTORIAL])                  return VSMathSymbolTypeFactorial;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_SINE])                       return VSMathSymbolTypeSine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_COSINE])                     return VSMathSymbolTypeCosine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_TANGENT])                    return VSMathSymbolTypeTangent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_SINE])               return VSMathSymbolTypeInverseSine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_COSINE])             return VSMathSymbolTypeInverseCosine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_TANGENT])            return VSMathSymbolTypeInverseTangent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_HYPERBOLIC_SINE])            return VSMathSymbolTypeHyperbolicSine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_HYPERBOLIC_COSINE])          return VSMathSymbolTypeHyperbolicCosine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_HYPERBOLIC_TANGENT])         return VSMathSymbolTypeHyperbolicTangent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_SINE])    return VSMathSymbolTypeInverseHyperbolicSine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_COSINE])  return VSMathSymbolTypeInverseHyperbolicCosine;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_INVERSE_HYPERBOLIC_TANGENT]) return VSMathSymbolTypeInverseHyperbolicTangent;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_NATURAL_LOGARITHM])          return VSMathSymbolTypeNaturalLogarithm;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LOGARITHM_10])               return VSMathSymbolTypeLogarithm10;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LOGARITHM_2])                return VSMathSymbolTypeLogarithm2;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_ABSOLUTE_VALUE])             return VSMathSymbolTypeAbsoluteValue;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LEFT_PARENTHESIS])           return VSMathSymbolTypeLeftParenthesis;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_RIGHT_PARENTHESIS])          return VSMathSymbolTypeRightParenthesis;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LEFT_SHIFT])                 return VSMathSymbolTypeLeftShift;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LEFT_SHIFT_BY])              return VSMathSymbolTypeLeftShiftBy;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_RIGHT_SHIFT])                return VSMathSymbolTypeRightShift;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_RIGHT_SHIFT_BY])             return VSMathSymbolTypeRightShiftBy;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_LEFT_ROTATE])                return VSMathSymbolTypeLeftRotate;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_RIGHT_ROTATE])               return VSMathSymbolTypeRightRotate;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_ONES_COMPLEMENT])            return VSMathSymbolTypeOnesComplement;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_TWOS_COMPLEMENT])            return VSMathSymbolTypeTwosComplement;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_FLIP_WORD])                  return VSMathSymbolTypeFlipWord;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_FLIP_BYTE])                  return VSMathSymbolTypeFlipByte;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_AND])                        return VSMathSymbolTypeAnd;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_NAND])                       return VSMathSymbolTypeNand;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_OR])                         return VSMathSymbolTypeOr;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_NOR])                        return VSMathSymbolTypeNor;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_XOR])                        return VSMathSymbolTypeXor;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_XNOR])                       return VSMathSymbolTypeXnor;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_PI])                         return VSMathSymbolTypePi;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_EULER])                      return VSMathSymbolTypeEuler;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_RANDOM_NUMBER])              return VSMathSymbolTypeRandomNumber;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_X_VARIABLE])                 return VSMathSymbolTypeXVariable;
-    else if ([symbol isEqualToString:VS_M_SYMBOL_Y_VARIABLE])                 return VSMathSymbolTypeYVariable;
-    else                                                                      return VSMathSymbolTypeUnknown;
+    static CFDictionaryRef symbolInstances = NULL;
+    static CFDictionaryRef symbolStrings = NULL;
+    static dispatch_once_t predicate;
+
+    if (symbol == nil) {
+        return VSMathSymbolTypeUnknown;
+    }
+
+    // Tokens interned by the tokenizer are the VS_M_SYMBOL_* instances themselves, found by address without comparing strings.
+    dispatch_once(&predicate, ^{
+        CFMutableDictionaryRef instances = CFDictionaryCreateMutable(kCFAllocatorDefault, VSMathSymbolTypeMaxTypes, NULL, NULL);
+        CFMutableDictionaryRef strings = CFDictionaryCreateMutable(kCFAllocatorDefault, VSMathSymbolTypeMaxTypes, &kCFTypeDictionaryKeyCallBacks, NULL);
+
+        for (int i = 0; i < VSMathSymbolTypeMaxTypes; i++) {
+            const void *key = (__bridge const void *)[VSMathUtil symbolWithType:(VSMathSymbolType)i];
+
+            CFDictionarySetValue(instances, key, (const void *)(intptr_t)i);
+            CFDictionarySetValue(strings, key, (const void *)(intptr_t)i);
+        }
+
+        symbolInstances = instances;
+        symbolStrings = strings;
+    });
+
+    const void *value = NULL;
+
+    if (CFDictionaryGetValueIfPresent(symbolInstances, (__bridge const void *)symbol, &value) ||
+        CFDictionaryGetValueIfPresent(symbolStrings, (__bridge const void *)symbol, &value)) {
+        return (VSMathSymbolType)(intptr_t)value;
+    }
+
+    return VSMathSymbolTypeUnknown;
 }
 
 + (VSMathOperationType)operationTypeOfSymbol:(NSString *)symbol {
@@ -2565,66 +3212,7 @@ NSString *NSStringFromVSMathTokenType(VSMathTokenType type) {
 }
 
 + (VSMathOperationType)operationTypeOfSymbolType:(VSMathSymbolType)symbolType {
-    switch (symbolType) {
-        case VSMathSymbolTypeEqual:                    return VSMathOperationTypeEqual;
-        case VSMathSymbolTypeAdd:                      return VSMathOperationTypeAdd;
-        case VSMathSymbolTypeSubtract:                 return VSMathOperationTypeSubtract;
-        case VSMathSymbolTypeMultiply:                 return VSMathOperationTypeMultiply;
-        case VSMathSymbolTypeMultiplyAlternate:        return VSMathOperationTypeMultiply;
-        case VSMathSymbolTypeDivide:                   return VSMathOperationTypeDivide;
-        case VSMathSymbolTypeDivideAlternate:          return VSMathOperationTypeDivide;
-        case VSMathSymbolTypeModulo:                   return VSMathOperationTypeModulo;
-        case VSMathSymbolTypeExponent:                 return VSMathOperationTypeExponent;
-        case VSMathSymbolTypeRoot:                     return VSMathOperationTypeRoot;
-        case VSMathSymbolTypeScientificNotation:       return VSMathOperationTypeScientificNotation;
-        case VSMathSymbolTypeChoose:                   return VSMathOperationTypeChoose;
-        case VSMathSymbolTypePick:                     return VSMathOperationTypePick;
-        case VSMathSymbolTypeNegative:                 return VSMathOperationTypeNegative;
-        case VSMathSymbolTypeSquare:                   return VSMathOperationTypeSquare;
-        case VSMathSymbolTypeSquareRoot:               return VSMathOperationTypeSquareRoot;
-        case VSMathSymbolTypeCube:                     return VSMathOperationTypeCube;
-        case VSMathSymbolTypeCubeRoot:                 return VSMathOperationTypeCubeRoot;
-        case VSMathSymbolTypePercent:                  return VSMathOperationTypePercent;
-        case VSMathSymbolTypeFactorial:                return VSMathOperationTypeFactorial;
-        case VSMathSymbolTypeSine:                     return VSMathOperationTypeSine;
-        case VSMathSymbolTypeCosine:                   return VSMathOperationTypeCosine;
-        case VSMathSymbolTypeTangent:                  return VSMathOperationTypeTangent;
-        case VSMathSymbolTypeInverseSine:              return VSMathOperationTypeInverseSine;
-        case VSMathSymbolTypeInverseCosine:            return VSMathOperationTypeInverseCosine;
-        case VSMathSymbolTypeInverseTangent:           return VSMathOperationTypeInverseTangent;
-        case VSMathSymbolTypeHyperbolicSine:           return VSMathOperationTypeHyperbolicSine;
-        case VSMathSymbolTypeHyperbolicCosine:         return VSMathOperationTypeHyperbolicCosine;
-        case VSMathSymbolTypeHyperbolicTangent:        return VSMathOperationTypeHyperbolicTangent;
-        case VSMathSymbolTypeInverseHyperbolicSine:    return VSMathOperationTypeInverseHyperbolicSine;
-        case VSMathSymbolTypeInverseHyperbolicCosine:  return VSMathOperationTypeInverseHyperbolicCosine;
-        case VSMathSymbolTypeInverseHyperbolicTangent: return VSMathOperationTypeInverseHyperbolicTangent;
-        case VSMathSymbolTypeNaturalLogarithm:         return VSMathOperationTypeNaturalLogarithm;
-        case VSMathSymbolTypeLogarithm10:              return VSMathOperationTypeLogarithm10;
-        case VSMathSymbolTypeLogarithm2:               return VSMathOperationTypeLogarithm2;
-        case VSMathSymbolTypeAbsoluteValue:            return VSMathOperationTypeAbsoluteValue;
-        case VSMathSymbolTypeLeftParenthesis:          return VSMathOperationTypeLeftParenthesis;
-        case VSMathSymbolTypeRightParenthesis:         return VSMathOperationTypeRightParenthesis;
-        case VSMathSymbolTypePi:                       return VSMathOperationTypePi;
-        case VSMathSymbolTypeEuler:                    return VSMathOperationTypeEuler;
-        case VSMathSymbolTypeRandomNumber:             return VSMathOperationTypeRandomNumber;
-        case VSMathSymbolTypeLeftShift:                return VSMathOperationTypeLeftShift;
-        case VSMathSymbolTypeLeftShiftBy:              return VSMathOperationTypeLeftShiftBy;
-        case VSMathSymbolTypeRightShift:               return VSMathOperationTypeRightShift;
-        case VSMathSymbolTypeRightShiftBy:             return VSMathOperationTypeRightShiftBy;
-        case VSMathSymbolTypeLeftRotate:               return VSMathOperationTypeRoL;
-        case VSMathSymbolTypeRightRotate:              return VSMathOperationTypeRoR;
-        case VSMathSymbolTypeOnesComplement:           return VSMathOperationTypeOnesComplement;
-        case VSMathSymbolTypeTwosComplement:           return VSMathOperationTypeTwosComplement;
-        case VSMathSymbolTypeFlipByte:                 return VSMathOperationTypeFlipByte;
-        case VSMathSymbolTypeFlipWord:                 return VSMathOperationTypeFlipWord;
-        case VSMathSymbolTypeAnd:                      return VSMathOperationTypeAnd;
-        case VSMathSymbolTypeNand:                     return VSMathOperationTypeNand;
-        case VSMathSymbolTypeOr:                       return VSMathOperationTypeOr;
-        case VSMathSymbolTypeNor:                      return VSMathOperationTypeNor;
-        case VSMathSymbolTypeXor:                      return VSMathOperationTypeXor;
-        case VSMathSymbolTypeXnor:                     return VSMathOperationTypeXnor;
-        default:                                       return VSMathOperationTypeUnknown;
-    }
+    return VSMathSymbolDescriptorOfSymbolType(symbolType)->operationType;
 }
 
 + (VSMathSymbolType)symbolTypeOfOperationType:(VSMathOperationType)operationType {
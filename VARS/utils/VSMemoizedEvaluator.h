@@ -0,0 +1,81 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  Stateful evaluator of a compiled expression which only recomputes what depends on changed variables.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "VSCompiledExpression.h"
+
+/**
+ *  Evaluator of a compiled expression which records the variables every subexpression depends on and caches their values between
+ *  evaluations. Each evaluation only recomputes the subexpressions depending on variables whose values changed since the previous one,
+ *  so sweeping f(x, y) over a grid with x fixed along each row costs the y-dependent part of the expression per sample rather than the
+ *  whole expression (see vs_expr_memo_eval()). Results are identical to those of the compiled expression. Evaluators are not thread
+ *  safe: use one evaluator per thread.
+ */
+@interface VSMemoizedEvaluator : NSObject
+
+#pragma mark Properties
+
+/**
+ *  Compiled expression evaluated by this evaluator, with its angle mode and evaluation options.
+ */
+@property (nonatomic, readonly) VSCompiledExpression *compiledExpression;
+
+#pragma mark Instantiation
+
+/**
+ *  Creates an evaluator of the specified compiled expression.
+ *
+ *  @param compiledExpression
+ *
+ *  @return VSMemoizedEvaluator instance, nil if the expression is nil or out of memory.
+ */
++ (instancetype)memoizedEvaluatorWithCompiledExpression:(VSCompiledExpression *)compiledExpression;
+
+/**
+ *  Initializes an evaluator of the specified compiled expression.
+ *
+ *  @param compiledExpression
+ *
+ *  @return VSMemoizedEvaluator instance, nil if the expression is nil or out of memory.
+ */
+- (instancetype)initWithCompiledExpression:(VSCompiledExpression *)compiledExpression;
+
+#pragma mark Evaluation
+
+/**
+ *  Evaluates the expression with the x and y variables, recomputing only the subexpressions depending on the variables which changed
+ *  since the previous evaluation. Custom variables are reported as unbound. This method does not allocate memory.
+ *
+ *  @param x
+ *  @param y
+ *  @param status Optional pointer to receive the evaluation status.
+ *
+ *  @return The evaluated double value, NAN if evaluation failed.
+ */
+- (double)evaluateWithX:(double)x y:(double)y status:(VSCompiledExpressionStatusType *)status;
+
+/**
+ *  Evaluates the expression with the specified variable values, indexed by slot, recomputing only the subexpressions depending on the
+ *  variables which changed since the previous evaluation. See VSCompiledExpression::evaluateWithVariables:count:status:. This method does
+ *  not allocate memory.
+ *
+ *  @param variables Variable values indexed by slot, may be NULL if count is 0.
+ *  @param count     Number of values in variables.
+ *  @param status    Optional pointer to receive the evaluation status.
+ *
+ *  @return The evaluated double value, NAN if evaluation failed.
+ */
+- (double)evaluateWithVariables:(const double *)variables count:(NSUInteger)count status:(VSCompiledExpressionStatusType *)status;
+
+/**
+ *  Discards all cached values, so that the next evaluation recomputes the whole expression.
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,109 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import "vsexpr.h"
+#import "vsmem.h"
+
+#import "VSMemoizedEvaluator.h"
+
+/**
+ *  Compiled expression internals which evaluators are built on.
+ */
+@interface VSCompiledExpression (VSMemoizedEvaluator)
+
+- (const vs_expr_t *)_compiledExpression;
+
+@end
+
+@interface VSMemoizedEvaluator () {
+    vs_expr_memo_t *_memo;
+}
+
+@end
+
+#pragma mark -
+
+@implementation VSMemoizedEvaluator
+
+#pragma mark Instantiation
+
++ (instancetype)memoizedEvaluatorWithCompiledExpression:(VSCompiledExpression *)compiledExpression {
+    VSMemoizedEvaluator *memoizedEvaluator = [[VSMemoizedEvaluator alloc] initWithCompiledExpression:compiledExpression];
+
+#if !__has_feature(objc_arc)
+    return [memoizedEvaluator autorelease];
+#else
+    return memoizedEvaluator;
+#endif
+}
+
+- (instancetype)initWithCompiledExpression:(VSCompiledExpression *)compiledExpression {
+    self = [super init];
+
+    if (self == nil) {
+        return nil;
+    }
+
+    _memo = (compiledExpression != nil) ? vs_expr_memo_alloc([compiledExpression _compiledExpression]) : NULL;
+
+    if (_memo == NULL) {
+#if !__has_feature(objc_arc)
+        [self release];
+#endif
+        return nil;
+    }
+
+    // The memoized state refers to the C expression owned by the compiled expression, which must outlive it.
+#if !__has_feature(objc_arc)
+    _compiledExpression = [compiledExpression retain];
+#else
+    _compiledExpression = compiledExpression;
+#endif
+
+    return self;
+}
+
+- (void)dealloc {
+    vs_expr_memo_free(_memo);
+    _memo = NULL;
+
+    vs_dealloc(_compiledExpression);
+
+#if !__has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+#pragma mark Evaluation
+
+- (double)evaluateWithX:(double)x y:(double)y status:(VSCompiledExpressionStatusType *)status {
+    double variables[2] = { x, y };
+
+    return [self evaluateWithVariables:variables count:2 status:status];
+}
+
+- (double)evaluateWithVariables:(const double *)variables count:(NSUInteger)count status:(VSCompiledExpressionStatusType *)status {
+    int s;
+    double o = vs_expr_memo_eval(_memo, (vs_angle_t)_compiledExpression.angleMode, (int)_compiledExpression.options, variables, count, &s);
+
+    if (status != NULL) {
+        switch (s) {
+            case VS_EXPR_OK:       *status = VSCompiledExpressionStatusTypeSuccess;         break;
+            case VS_EXPR_EUNBOUND: *status = VSCompiledExpressionStatusTypeUnboundVariable; break;
+            default:               *status = VSCompiledExpressionStatusTypeUnknown;         break;
+        }
+    }
+
+    return o;
+}
+
+- (void)reset {
+    vs_expr_memo_reset(_memo);
+}
+
+@end
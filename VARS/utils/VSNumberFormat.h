@@ -0,0 +1,153 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  Numeric format specifier compiled once for formatting many numbers.
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Immutable number format built once from a printf style numeric format specifier (i.e. VS_N_NUMERIC_FORMAT_DOUBLE), an exponent
+ *  symbol and a NAN symbol. The specifier must contain exactly one conversion (d, i, o, u, x, X, f, F, e, E, g, G, a or A) with optional
+ *  flags, width, precision and length modifier, and may be surrounded by text where % is escaped as %%. Length modifiers are ignored:
+ *  integer conversions always take a long long and floating-point conversions a double, values of the other type being converted.
+ *  Plain %g specifiers with a precision of at most 17 are formatted by vs_num_format() (see
+ *  VSStringUtil::stringFromDouble:numericFormatSpecifier:exponentSymbol:NANSymbol:), other specifiers by snprintf(). The exponent
+ *  marker of e, E, g and G conversions is written as the exponent symbol, integer conversions and the text around the conversion
+ *  being left as is, and NAN values are written as the NAN symbol. Bulk methods format arrays of numbers into a single buffer, so that
+ *  exporting or rendering many values takes one allocation rather than one string per value. Number formats are thread safe.
+ */
+@interface VSNumberFormat : NSObject
+
+#pragma mark Properties
+
+/**
+ *  Numeric format specifier of this format.
+ */
+@property (nonatomic, readonly) NSString *numericFormatSpecifier;
+
+/**
+ *  Symbol written in place of the e of scientific notation.
+ */
+@property (nonatomic, readonly) NSString *exponentSymbol;
+
+/**
+ *  Symbol written for NAN values.
+ */
+@property (nonatomic, readonly) NSString *NANSymbol;
+
+/**
+ *  Precision of the numeric format specifier, 0 if not specified (see VSNumberUtil::precisionFromNumericFormatSpecifier:).
+ */
+@property (nonatomic, readonly) unsigned int precision;
+
+#pragma mark Instantiation
+
+/**
+ *  Creates a number format with the default exponent and NAN symbols (VS_M_SYMBOL_SCIENTIFIC_NOTATION and VS_M_SYMBOL_NAN).
+ *
+ *  @param numericFormatSpecifier Specifier, VS_N_NUMERIC_FORMAT_DOUBLE if nil.
+ *
+ *  @return VSNumberFormat instance, nil if the specifier is not supported.
+ */
++ (instancetype)numberFormatWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier;
+
+/**
+ *  Creates a number format.
+ *
+ *  @param numericFormatSpecifier Specifier, VS_N_NUMERIC_FORMAT_DOUBLE if nil.
+ *  @param exponentSymbol         Exponent symbol, VS_M_SYMBOL_SCIENTIFIC_NOTATION if nil.
+ *  @param NANSymbol              NAN symbol, VS_M_SYMBOL_NAN if nil.
+ *
+ *  @return VSNumberFormat instance, nil if the specifier is not supported.
+ */
++ (instancetype)numberFormatWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier exponentSymbol:(NSString *)exponentSymbol NANSymbol:(NSString *)NANSymbol;
+
+/**
+ *  Initializes a number format.
+ *
+ *  @param numericFormatSpecifier Specifier, VS_N_NUMERIC_FORMAT_DOUBLE if nil.
+ *  @param exponentSymbol         Exponent symbol, VS_M_SYMBOL_SCIENTIFIC_NOTATION if nil.
+ *  @param NANSymbol              NAN symbol, VS_M_SYMBOL_NAN if nil.
+ *
+ *  @return VSNumberFormat instance, nil if the specifier is not supported.
+ */
+- (instancetype)initWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier exponentSymbol:(NSString *)exponentSymbol NANSymbol:(NSString *)NANSymbol;
+
+#pragma mark Formatting
+
+/**
+ *  Formats a double value.
+ *
+ *  @param aDouble
+ *
+ *  @return The formatted string.
+ */
+- (NSString *)stringFromDouble:(double)aDouble;
+
+/**
+ *  Formats a long long value.
+ *
+ *  @param aLongLong
+ *
+ *  @return The formatted string.
+ */
+- (NSString *)stringFromLongLong:(long long)aLongLong;
+
+#pragma mark Bulk Formatting
+
+/**
+ *  Formats double values into a single UTF-8 buffer, separated by the specified separator.
+ *
+ *  @param doubles
+ *  @param count     Number of values.
+ *  @param separator Separator between values, none if nil.
+ *  @param offsets   Optional array of count + 1 byte offsets to receive the start of each value, followed by the length of the buffer.
+ *
+ *  @return UTF-8 data without null character, nil if out of memory.
+ */
+- (NSData *)UTF8DataFromDoubles:(const double *)doubles count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets;
+
+/**
+ *  Formats long long values into a single UTF-8 buffer, separated by the specified separator.
+ *
+ *  @param longLongs
+ *  @param count     Number of values.
+ *  @param separator Separator between values, none if nil.
+ *  @param offsets   Optional array of count + 1 byte offsets to receive the start of each value, followed by the length of the buffer.
+ *
+ *  @return UTF-8 data without null character, nil if out of memory.
+ */
+- (NSData *)UTF8DataFromLongLongs:(const long long *)longLongs count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets;
+
+/**
+ *  Formats double values into a single string backed by one UTF-16 buffer, separated by the specified separator.
+ *
+ *  @param doubles
+ *  @param count     Number of values.
+ *  @param separator Separator between values, none if nil.
+ *  @param offsets   Optional array of count + 1 character offsets to receive the start of each value, followed by the length of the
+ *                   string.
+ *
+ *  @return The formatted string, nil if out of memory.
+ */
+- (NSString *)stringFromDoubles:(const double *)doubles count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets;
+
+/**
+ *  Formats long long values into a single string backed by one UTF-16 buffer, separated by the specified separator.
+ *
+ *  @param longLongs
+ *  @param count     Number of values.
+ *  @param separator Separator between values, none if nil.
+ *  @param offsets   Optional array of count + 1 character offsets to receive the start of each value, followed by the length of the
+ *                   string.
+ *
+ *  @return The formatted string, nil if out of memory.
+ */
+- (NSString *)stringFromLongLongs:(const long long *)longLongs count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets;
+
+@end
@@ -0,0 +1,588 @@
+/**
+ *  VARS
+ *  (c) VARIANTE <http://variante.io>
+ *
+ *  This software is released under the MIT License:
+ *  http://www.opensource.org/licenses/mit-license.php
+ */
+
+#import <limits.h>
+#import <math.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+
+#import "vsmath.h"
+#import "vsmem.h"
+#import "vsnum.h"
+
+#import "VSNumberFormat.h"
+#import "VSNumberUtil.h"
+
+/**
+ *  Kinds of compiled specifiers: any conversion formatted by snprintf(), plain %g formatted by vs_num_format(), or plain %d.
+ */
+#define VS_NUMBER_FORMAT_KIND_PRINTF   0
+#define VS_NUMBER_FORMAT_KIND_SHORTEST 1
+#define VS_NUMBER_FORMAT_KIND_DECIMAL  2
+
+/**
+ *  Max size of a C format string compiled from a specifier, and of the symbols.
+ */
+#define VS_NUMBER_FORMAT_SIZE 128
+
+/**
+ *  Size of the stack buffer which a single value is formatted into, larger values are formatted into a temporary heap buffer.
+ */
+#define VS_NUMBER_FORMAT_BUFFER_SIZE 128
+
+/**
+ *  Compiled numeric format specifier.
+ */
+typedef struct {
+    int kind;
+    int floating;
+    int exponential;
+    size_t prefix;
+    size_t suffix;
+    int digits;
+    unsigned int precision;
+    char format[VS_NUMBER_FORMAT_SIZE];
+    char exponent[VS_NUMBER_FORMAT_SIZE];
+    char nan[VS_NUMBER_FORMAT_SIZE];
+} VSNumberFormatSpec;
+
+/**
+ *  Appends a character to a compiled format string.
+ *
+ *  @param format
+ *  @param k      Pointer to the length of the format string.
+ *  @param c
+ *
+ *  @return 1 if the character fits, 0 otherwise.
+ */
+static int VSNumberFormatAppend(char *format, size_t *k, char c) {
+    if (*k + 1 >= VS_NUMBER_FORMAT_SIZE) return 0;
+
+    format[(*k)++] = c;
+
+    return 1;
+}
+
+/**
+ *  Compiles a numeric format specifier into a C format string taking a long long for integer conversions and a double otherwise.
+ *
+ *  @param specifier UTF-8 specifier.
+ *  @param spec      Compiled specifier to receive the format string, kind and precision.
+ *
+ *  @return 1 if the specifier is supported, 0 otherwise.
+ */
+static int VSNumberFormatCompile(const char *specifier, VSNumberFormatSpec *spec) {
+    const char *c = specifier;
+    size_t k = 0;
+    int plain = 1;
+
+    // Text before the conversion, %% being written as a single %.
+    spec->prefix = 0;
+    spec->suffix = 0;
+
+    while ((*c != 0) && !((c[0] == '%') && (c[1] != '%'))) {
+        if (*c == '%') {
+            if (!VSNumberFormatAppend(spec->format, &k, *c++)) return 0;
+        }
+
+        if (!VSNumberFormatAppend(spec->format, &k, *c++)) return 0;
+
+        spec->prefix++;
+        plain = 0;
+    }
+
+    if (*c++ != '%') return 0;
+    if (!VSNumberFormatAppend(spec->format, &k, '%')) return 0;
+
+    // Flags, width and precision are kept as is, a 0 flag alone has no effect.
+    const char *flags = c;
+    int width = 0;
+    int precise = 0;
+    unsigned int precision = 0;
+
+    while ((*c == '-') || (*c == '+') || (*c == ' ') || (*c == '#') || (*c == '0') || (*c == '\'')) {
+        if (*c != '0') plain = 0;
+        c++;
+    }
+
+    while ((*c >= '0') && (*c <= '9')) {
+        width = 1;
+        c++;
+    }
+
+    if (*c == '.') {
+        precise = 1;
+        c++;
+
+        while ((*c >= '0') && (*c <= '9')) {
+            if (precision < 1000) precision = (precision * 10) + (unsigned int)(*c - '0');
+            c++;
+        }
+    }
+
+    while (flags < c) {
+        if (!VSNumberFormatAppend(spec->format, &k, *flags++)) return 0;
+    }
+
+    while ((*c == 'h') || (*c == 'l') || (*c == 'L') || (*c == 'q') || (*c == 'j') || (*c == 'z') || (*c == 't')) c++;
+
+    if ((*c == 0) || (strchr("diouxXfFeEgGaA", *c) == NULL)) return 0;
+
+    char conversion = *c++;
+
+    spec->floating = (strchr("fFeEgGaA", conversion) != NULL);
+    spec->exponential = (strchr("eEgG", conversion) != NULL);
+
+    if (!spec->floating) {
+        if (!VSNumberFormatAppend(spec->format, &k, 'l')) return 0;
+        if (!VSNumberFormatAppend(spec->format, &k, 'l')) return 0;
+    }
+
+    if (!VSNumberFormatAppend(spec->format, &k, conversion)) return 0;
+
+    // Text after the conversion.
+    while (*c != 0) {
+        if (*c == '%') {
+            if (c[1] != '%') return 0;
+            if (!VSNumberFormatAppend(spec->format, &k, *c++)) return 0;
+        }
+
+        if (!VSNumberFormatAppend(spec->format, &k, *c++)) return 0;
+
+        spec->suffix++;
+        plain = 0;
+    }
+
+    spec->format[k] = 0;
+    spec->precision = precise ? precision : 0;
+    spec->kind = VS_NUMBER_FORMAT_KIND_PRINTF;
+
+    if (plain && !width && (conversion == 'g') && (!precise || (precision <= 17))) {
+        spec->kind = VS_NUMBER_FORMAT_KIND_SHORTEST;
+        spec->digits = !precise ? 6 : ((precision == 0) ? 1 : (int)precision);
+    }
+    else if (plain && !width && !precise && ((conversion == 'd') || (conversion == 'i'))) {
+        spec->kind = VS_NUMBER_FORMAT_KIND_DECIMAL;
+    }
+
+    return 1;
+}
+
+/**
+ *  Copies a formatted value into a buffer of limited size like snprintf(), writing its exponent marker as the exponent symbol.
+ *
+ *  @param c
+ *  @param n        Length of the value in bytes.
+ *  @param x        Index of the exponent marker, n or more if none.
+ *  @param exponent Exponent symbol, NULL to copy the exponent marker as is.
+ *  @param o
+ *  @param size     Size of the buffer in bytes.
+ *
+ *  @return The length of the whole value, excluding the null character.
+ */
+static size_t VSNumberFormatCopy(const char *c, size_t n, size_t x, const char *exponent, char *o, size_t size) {
+    size_t k = 0;
+    size_t e = (exponent != NULL) ? strlen(exponent) : 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const char *s = ((exponent != NULL) && (i == x)) ? exponent : (c + i);
+        size_t m = ((exponent != NULL) && (i == x)) ? e : 1;
+
+        for (size_t j = 0; j < m; j++, k++) {
+            if (k + 1 < size) o[k] = s[j];
+        }
+    }
+
+    if (size > 0) o[(k < size) ? k : (size - 1)] = 0;
+
+    return k;
+}
+
+/**
+ *  Formats a value with snprintf() into a buffer of limited size, writing the exponent marker of e, E, g and G conversions as the
+ *  exponent symbol. The marker is the only e or E of the converted number, the literal text around it being left as is.
+ *
+ *  @param spec
+ *  @param d    Value of floating-point conversions.
+ *  @param l    Value of integer conversions.
+ *  @param o
+ *  @param size Size of the buffer in bytes.
+ *
+ *  @return The length of the whole value, excluding the null character.
+ */
+static size_t VSNumberFormatPrint(const VSNumberFormatSpec *spec, double d, long long l, char *o, size_t size) {
+    char buffer[VS_NUMBER_FORMAT_BUFFER_SIZE];
+    char *b = buffer;
+    int n = spec->floating ? snprintf(b, sizeof(buffer), spec->format, d) : snprintf(b, sizeof(buffer), spec->format, l);
+
+    if (n < 0) return VSNumberFormatCopy("", 0, 0, NULL, o, size);
+
+    // Fixed notation of large doubles, i.e. %f of DBL_MAX, or wide fields.
+    if ((size_t)n >= sizeof(buffer)) {
+        b = malloc((size_t)n + 1);
+
+        if (b == NULL) return VSNumberFormatCopy("", 0, 0, NULL, o, size);
+
+        if (spec->floating) {
+            snprintf(b, (size_t)n + 1, spec->format, d);
+        }
+        else {
+            snprintf(b, (size_t)n + 1, spec->format, l);
+        }
+    }
+
+    size_t x = (size_t)n;
+
+    if (spec->exponential && (spec->prefix + spec->suffix <= (size_t)n)) {
+        for (size_t i = spec->prefix; i < (size_t)n - spec->suffix; i++) {
+            if ((b[i] == 'e') || (b[i] == 'E')) x = i;
+        }
+    }
+
+    size_t k = VSNumberFormatCopy(b, (size_t)n, x, spec->exponent, o, size);
+
+    if (b != buffer) free(b);
+
+    return k;
+}
+
+/**
+ *  Formats a long long value in decimal into a buffer of limited size.
+ *
+ *  @param l
+ *  @param o
+ *  @param size Size of the buffer in bytes.
+ *
+ *  @return The length of the whole value, excluding the null character.
+ */
+static size_t VSNumberFormatDecimal(long long l, char *o, size_t size) {
+    char buffer[VS_NUM_FORMATU_SIZE + 1];
+    unsigned long long u = (l < 0) ? (0 - (unsigned long long)l) : (unsigned long long)l;
+
+    buffer[0] = '-';
+
+    size_t n = vs_num_formatu(u, 10, 0, NULL, buffer + 1, sizeof(buffer) - 1);
+
+    return (l < 0) ? VSNumberFormatCopy(buffer, n + 1, 0, NULL, o, size) : VSNumberFormatCopy(buffer + 1, n, 0, NULL, o, size);
+}
+
+/**
+ *  Formats a double value into a buffer of limited size like snprintf().
+ *
+ *  @param spec
+ *  @param d
+ *  @param o
+ *  @param size Size of the buffer in bytes.
+ *
+ *  @return The length of the whole value, excluding the null character.
+ */
+static size_t VSNumberFormatWriteDouble(const VSNumberFormatSpec *spec, double d, char *o, size_t size) {
+    if (isnan(d)) {
+        return VSNumberFormatCopy(spec->nan, strlen(spec->nan), 0, NULL, o, size);
+    }
+    else if (spec->kind == VS_NUMBER_FORMAT_KIND_SHORTEST) {
+        return vs_num_format(d, spec->digits, spec->exponent, spec->nan, o, size);
+    }
+    else if (spec->floating) {
+        return VSNumberFormatPrint(spec, d, 0, o, size);
+    }
+    else {
+        // Integer conversions of doubles truncate toward 0 and saturate.
+        long long l = (d >= 0x1p63) ? LLONG_MAX : ((d <= -0x1p63) ? LLONG_MIN : (long long)d);
+
+        return (spec->kind == VS_NUMBER_FORMAT_KIND_DECIMAL) ? VSNumberFormatDecimal(l, o, size) : VSNumberFormatPrint(spec, 0, l, o, size);
+    }
+}
+
+/**
+ *  Formats a long long value into a buffer of limited size like snprintf().
+ *
+ *  @param spec
+ *  @param l
+ *  @param o
+ *  @param size Size of the buffer in bytes.
+ *
+ *  @return The length of the whole value, excluding the null character.
+ */
+static size_t VSNumberFormatWriteLongLong(const VSNumberFormatSpec *spec, long long l, char *o, size_t size) {
+    if (spec->kind == VS_NUMBER_FORMAT_KIND_DECIMAL) {
+        return VSNumberFormatDecimal(l, o, size);
+    }
+    else if (spec->floating) {
+        return VSNumberFormatWriteDouble(spec, (double)l, o, size);
+    }
+    else {
+        return VSNumberFormatPrint(spec, 0, l, o, size);
+    }
+}
+
+/**
+ *  Decodes UTF-8 into UTF-16, replacing invalid sequences with U+FFFD. UTF-16 never takes more code units than UTF-8 takes bytes.
+ *
+ *  @param c
+ *  @param n Length in bytes.
+ *  @param o Buffer of at least n code units.
+ *
+ *  @return The number of code units written.
+ */
+static size_t VSNumberFormatWiden(const char *c, size_t n, unichar *o) {
+    const unsigned char *u = (const unsigned char *)c;
+    size_t k = 0;
+
+    for (size_t i = 0; i < n;) {
+        uint32_t p = u[i];
+        size_t m = (p < 0x80) ? 1 : ((p >= 0xf0) && (p < 0xf5)) ? 4 : (p >= 0xe0) ? 3 : (p >= 0xc2) ? 2 : 0;
+
+        if (m > 1) p &= (0xff >> (m + 1));
+
+        for (size_t j = 1; (j < m) && (m != 0); j++) {
+            if ((i + j >= n) || ((u[i + j] & 0xc0) != 0x80)) {
+                m = 0;
+            }
+            else {
+                p = (p << 6) | (u[i + j] & 0x3f);
+            }
+        }
+
+        if ((m == 0) || ((m == 3) && ((p < 0x800) || ((p >= 0xd800) && (p < 0xe000)))) || ((m == 4) && ((p < 0x10000) || (p > 0x10ffff)))) {
+            o[k++] = 0xfffd;
+            i++;
+        }
+        else if (p >= 0x10000) {
+            o[k++] = (unichar)(0xd800 + ((p - 0x10000) >> 10));
+            o[k++] = (unichar)(0xdc00 + ((p - 0x10000) & 0x3ff));
+            i += m;
+        }
+        else {
+            o[k++] = (unichar)p;
+            i += m;
+        }
+    }
+
+    return k;
+}
+
+/**
+ *  Formats double or long long values, whichever array is set, into a single heap buffer of UTF-8 or UTF-16 code units separated by
+ *  a separator. The buffer is allocated for typical lengths and only grows for longer values.
+ *
+ *  @param spec
+ *  @param doubles
+ *  @param longLongs
+ *  @param count
+ *  @param separator UTF-8 separator.
+ *  @param wide      1 for UTF-16, 0 for UTF-8.
+ *  @param offsets   Optional array of count + 1 offsets in code units.
+ *  @param length    Pointer to receive the length of the buffer in code units.
+ *
+ *  @return The buffer, NULL if out of memory.
+ */
+static void *VSNumberFormatWriteValues(const VSNumberFormatSpec *spec, const double *doubles, const long long *longLongs, NSUInteger count,
+                                       const char *separator, int wide, NSUInteger *offsets, size_t *length) {
+    size_t unit = wide ? sizeof(unichar) : sizeof(char);
+    size_t separatorLength = strlen(separator);
+    size_t capacity = (count * (24 + separatorLength)) + 1;
+    size_t k = 0;
+    char *o = malloc(capacity * unit);
+
+    if (o == NULL) return NULL;
+
+    for (NSUInteger i = 0; i < count; i++) {
+        char buffer[VS_NUMBER_FORMAT_BUFFER_SIZE];
+        char *b = buffer;
+        size_t n = (doubles != NULL) ? VSNumberFormatWriteDouble(spec, doubles[i], b, sizeof(buffer)) :
+                                       VSNumberFormatWriteLongLong(spec, longLongs[i], b, sizeof(buffer));
+
+        if (n >= sizeof(buffer)) {
+            b = malloc(n + 1);
+
+            if (b == NULL) {
+                free(o);
+                return NULL;
+            }
+
+            if (doubles != NULL) {
+                VSNumberFormatWriteDouble(spec, doubles[i], b, n + 1);
+            }
+            else {
+                VSNumberFormatWriteLongLong(spec, longLongs[i], b, n + 1);
+            }
+        }
+
+        // UTF-8 bytes bound the number of UTF-16 code units.
+        if (k + n + separatorLength + 1 > capacity) {
+            size_t grown = 2 * capacity;
+
+            while (k + n + separatorLength + 1 > grown) grown *= 2;
+
+            char *g = realloc(o, grown * unit);
+
+            if (g == NULL) {
+                if (b != buffer) free(b);
+
+                free(o);
+                return NULL;
+            }
+
+            o = g;
+            capacity = grown;
+        }
+
+        if ((i > 0) && (separatorLength > 0)) {
+            k += wide ? VSNumberFormatWiden(separator, separatorLength, (unichar *)o + k) : (memcpy(o + k, separator, separatorLength), separatorLength);
+        }
+
+        if (offsets != NULL) offsets[i] = k;
+
+        k += wide ? VSNumberFormatWiden(b, n, (unichar *)o + k) : (memcpy(o + k, b, n), n);
+
+        if (b != buffer) free(b);
+    }
+
+    if (offsets != NULL) offsets[count] = k;
+
+    *length = k;
+
+    return o;
+}
+
+#pragma mark -
+
+@interface VSNumberFormat () {
+    VSNumberFormatSpec _spec;
+}
+
+@end
+
+#pragma mark -
+
+@implementation VSNumberFormat
+
+#pragma mark Instantiation
+
++ (instancetype)numberFormatWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier {
+    return [VSNumberFormat numberFormatWithNumericFormatSpecifier:numericFormatSpecifier exponentSymbol:nil NANSymbol:nil];
+}
+
++ (instancetype)numberFormatWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier exponentSymbol:(NSString *)exponentSymbol NANSymbol:(NSString *)NANSymbol {
+    VSNumberFormat *numberFormat = [[VSNumberFormat alloc] initWithNumericFormatSpecifier:numericFormatSpecifier exponentSymbol:exponentSymbol NANSymbol:NANSymbol];
+
+#if !__has_feature(objc_arc)
+    return [numberFormat autorelease];
+#else
+    return numberFormat;
+#endif
+}
+
+- (instancetype)initWithNumericFormatSpecifier:(NSString *)numericFormatSpecifier exponentSymbol:(NSString *)exponentSymbol NANSymbol:(NSString *)NANSymbol {
+    self = [super init];
+
+    if (self == nil) {
+        return nil;
+    }
+
+    if (numericFormatSpecifier == nil) numericFormatSpecifier = VS_N_NUMERIC_FORMAT_DOUBLE;
+    if (exponentSymbol == nil) exponentSymbol = VS_M_SYMBOL_SCIENTIFIC_NOTATION;
+    if (NANSymbol == nil) NANSymbol = VS_M_SYMBOL_NAN;
+
+    const char *e = exponentSymbol.UTF8String;
+    const char *nan = NANSymbol.UTF8String;
+
+    if (!VSNumberFormatCompile(numericFormatSpecifier.UTF8String, &_spec) || (strlen(e) >= VS_NUMBER_FORMAT_SIZE) || (strlen(nan) >= VS_NUMBER_FORMAT_SIZE)) {
+#if !__has_feature(objc_arc)
+        [self release];
+#endif
+        return nil;
+    }
+
+    strcpy(_spec.exponent, e);
+    strcpy(_spec.nan, nan);
+
+    _numericFormatSpecifier = [numericFormatSpecifier copy];
+    _exponentSymbol = [exponentSymbol copy];
+    _NANSymbol = [NANSymbol copy];
+
+    return self;
+}
+
+- (void)dealloc {
+    vs_dealloc(_numericFormatSpecifier);
+    vs_dealloc(_exponentSymbol);
+    vs_dealloc(_NANSymbol);
+
+#if !__has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+#pragma mark Properties
+
+- (unsigned int)precision {
+    return _spec.precision;
+}
+
+#pragma mark Formatting
+
+- (NSString *)stringFromDouble:(double)aDouble {
+    if (isnan(aDouble)) return _NANSymbol;
+
+    return [self stringFromDoubles:&aDouble count:1 separator:nil offsets:NULL];
+}
+
+- (NSString *)stringFromLongLong:(long long)aLongLong {
+    return [self stringFromLongLongs:&aLongLong count:1 separator:nil offsets:NULL];
+}
+
+#pragma mark Bulk Formatting
+
+- (NSData *)UTF8DataFromDoubles:(const double *)doubles count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets {
+    size_t length = 0;
+    void *buffer = VSNumberFormatWriteValues(&_spec, doubles, NULL, count, (separator != nil) ? separator.UTF8String : "", 0, offsets, &length);
+
+    return (buffer != NULL) ? [NSData dataWithBytesNoCopy:buffer length:length freeWhenDone:YES] : nil;
+}
+
+- (NSData *)UTF8DataFromLongLongs:(const long long *)longLongs count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets {
+    size_t length = 0;
+    void *buffer = VSNumberFormatWriteValues(&_spec, NULL, longLongs, count, (separator != nil) ? separator.UTF8String : "", 0, offsets, &length);
+
+    return (buffer != NULL) ? [NSData dataWithBytesNoCopy:buffer length:length freeWhenDone:YES] : nil;
+}
+
+- (NSString *)stringFromDoubles:(const double *)doubles count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets {
+    size_t length = 0;
+    void *buffer = VSNumberFormatWriteValues(&_spec, doubles, NULL, count, (separator != nil) ? separator.UTF8String : "", 1, offsets, &length);
+
+    if (buffer == NULL) return nil;
+
+    NSString *string = [[NSString alloc] initWithCharactersNoCopy:buffer length:length freeWhenDone:YES];
+
+#if !__has_feature(objc_arc)
+    return [string autorelease];
+#else
+    return string;
+#endif
+}
+
+- (NSString *)stringFromLongLongs:(const long long *)longLongs count:(NSUInteger)count separator:(NSString *)separator offsets:(NSUInteger *)offsets {
+    size_t length = 0;
+    void *buffer = VSNumberFormatWriteValues(&_spec, NULL, longLongs, count, (separator != nil) ? separator.UTF8String : "", 1, offsets, &length);
+
+    if (buffer == NULL) return nil;
+
+    NSString *string = [[NSString alloc] initWithCharactersNoCopy:buffer length:length freeWhenDone:YES];
+
+#if !__has_feature(objc_arc)
+    return [string autorelease];
+#else
+    return string;
+#endif
+}
+
+@end
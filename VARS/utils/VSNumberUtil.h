@@ -124,8 +124,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an NSNumber value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, a default one will be generated locally. The default
- *  locale is "en_US".
+ *  If no NSNumberFormatter instance is specified, the string is parsed with the separators of the default
+ *  locale "en_US" by vs_num_parse(), which rounds correctly without creating any formatter or locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -135,18 +135,20 @@ NS_ROOT_CLASS @interface VSNumberUtil
 + (NSNumber *)numberFromString:(NSString *)aString numberFormatter:(NSNumberFormatter *)aNumberFormatter;
 
 /**
- *  Reads and returns a double value from an NSString.
+ *  Reads and returns a float value from an NSString.
  *
  *  @param aString
  *
- *  @return The corresponding double value if valid, NAN if invalid.
+ *  @return The corresponding float value if valid, NAN if invalid.
  */
 + (float)floatFromString:(NSString *)aString;
 
 /**
  *  Reads and returns a float value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtof_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, the string is parsed with the separators of the default
+ *  locale "en_US" by vs_num_parse() instead, like doubleFromString:, and the double is rounded to float.
+ *  Unlike fstrtonumf(), leading whitespace and hexadecimal literals are invalid (" 1" and "0x10" give NAN),
+ *  and grouping separators are skipped ("1,5" gives 15).
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -166,8 +168,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns a double value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtod_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, the string is parsed with the separators of the default
+ *  locale "en_US" by vs_num_parse() instead.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -187,8 +189,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an int value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtol_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lstrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -208,8 +210,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns a long value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtol_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lstrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -229,8 +231,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns a long long value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtoll_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, llstrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -250,8 +252,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an unsigned char value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtoul_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lustrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -281,8 +283,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an unsigned short value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtoul_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lustrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -312,8 +314,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an unsigned int value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtoul_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lustrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
@@ -343,8 +345,8 @@ NS_ROOT_CLASS @interface VSNumberUtil
 
 /**
  *  Reads and returns an unsigned long value from an NSString using the specified NSNumberFormatter instance.
- *  If no NSNumberFormatter instance is specified, the strtoul_l from stdlib will be used instead with
- *  LC_GLOBAL_LOCALE.
+ *  If no NSNumberFormatter instance is specified, lustrtonum() from VARS will be used instead, which does not
+ *  depend on the locale.
  *
  *  @param aString
  *  @param aNumberFormatter
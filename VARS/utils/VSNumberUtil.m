@@ -8,6 +8,7 @@
 
 #import "vsmath.h"
 #import "vsmem.h"
+#import "vsnum.h"
 
 #import "VSMathUtil.h"
 #import "VSNumberUtil.h"
@@ -18,6 +19,30 @@
  */
 static NSNumberFormatter *NUMBER_FORMATTER;
 
+/**
+ *  Max length of strings parsed by VSNumberUtilParseString() without allocating memory.
+ */
+#define VS_M_NUMBER_BUFFER_LENGTH 64
+
+/**
+ *  Parses a string with the separators of the default locale, see vs_num_parse().
+ *
+ *  @param aString
+ *  @param value   Pointer to receive the parsed value.
+ *
+ *  @return YES if the string is a number, NO otherwise.
+ */
+static BOOL VSNumberUtilParseString(NSString *aString, double *value) {
+    char buffer[VS_M_NUMBER_BUFFER_LENGTH];
+    const char *characters = buffer;
+
+    if (!CFStringGetCString((__bridge CFStringRef)aString, buffer, VS_M_NUMBER_BUFFER_LENGTH, kCFStringEncodingUTF8)) {
+        characters = aString.UTF8String;
+    }
+
+    return (characters != NULL) && vs_num_parse(characters, strlen(characters), VS_NUM_DECIMAL_SEPARATOR, VS_NUM_GROUPING_SEPARATOR, value);
+}
+
 #pragma mark -
 
 NSString *NSStringFromVSNumberSystemType(VSNumberSystemType type) {
@@ -119,19 +144,11 @@ NSString *NSStringFromVSBinaryDigitType(VSBinaryDigitType type) {
         // Do nothing.
     }
     else if (aNumberFormatter == nil) {
-        if ([[aString lowercaseString] isEqualToString:[VS_M_SYMBOL_NAN lowercaseString]]) {
-            number = [NSNumber numberWithDouble:NAN];
-        }
-        else {
-            // Somehow grouping separators invalidates the numeric value in the string, remove them.
-            aString = [aString stringByReplacingOccurrencesOfString:[VSNumberUtil globalNumberFormatterWithDefaultLocale].groupingSeparator withString:@""];
-
-            number = [[VSNumberUtil globalNumberFormatterWithDefaultLocale] numberFromString:aString];
+        double value;
 
-            // Double check.
-            if (number != nil) {
-                number = [NSNumber numberWithDouble:[VSNumberUtil doubleFromString:aString]];
-            }
+        // Validated and parsed at once, NAN included.
+        if (VSNumberUtilParseString(aString, &value)) {
+            number = [NSNumber numberWithDouble:value];
         }
     }
     else {
@@ -158,7 +175,9 @@ NSString *NSStringFromVSBinaryDigitType(VSBinaryDigitType type) {
         return NAN;
     }
     else if (aNumberFormatter == nil) {
-        return fstrtonumf([aString UTF8String]);
+        double value;
+
+        return VSNumberUtilParseString(aString, &value) ? (float)value : NAN;
     }
     else {
         NSNumber *number = [aNumberFormatter numberFromString:aString];
@@ -181,7 +200,9 @@ NSString *NSStringFromVSBinaryDigitType(VSBinaryDigitType type) {
         return NAN;
     }
     else if (aNumberFormatter == nil) {
-        return fstrtonum([aString UTF8String]);
+        double value;
+
+        return VSNumberUtilParseString(aString, &value) ? value : NAN;
     }
     else {
         NSNumber *number = [aNumberFormatter numberFromString:aString];
@@ -91,7 +91,8 @@ NS_ROOT_CLASS @interface VSStringUtil
 + (NSString *)stringFromComparisonResult:(NSComparisonResult)comparisonResult;
 
 /**
- *  Converts a double value to a string using the default "%0.15g" numeric format specifier.
+ *  Converts a double value to a string using the default "%0.16g" numeric format specifier, see
+ *  stringFromDouble:numericFormatSpecifier:exponentSymbol:NANSymbol:.
  *
  *  @param aDouble
  *
@@ -100,7 +101,9 @@ NS_ROOT_CLASS @interface VSStringUtil
 + (NSString *)stringFromDouble:(double)aDouble;
 
 /**
- *  Converts a double value to a string with the specified numberic format and optional string representation of NAN.
+ *  Converts a double value to a string with the specified numberic format and optional string representation of NAN. The default
+ *  "%0.16g" format is written by vs_num_format() without locale, as the shortest decimal which parses back to the same double if it has
+ *  at most 16 significant digits, and as %0.16g otherwise.
  *
  *  @param aDouble
  *  @param numericFormatSpecifier
@@ -348,6 +351,20 @@ NS_ROOT_CLASS @interface VSStringUtil
  */
 + (NSString *)stringFromUnsignedLongLong:(unsigned long long)anUnsignedLongLong numberSystem:(VSNumberSystemType)numberSystemType;
 
+/**
+ *  Converts an unsigned long long value to a string in the specified number system type, with digits grouped from the least
+ *  significant one (i.e. 1010 1100 in binary with groups of 4). Hexadecimal strings are uppercase and prefixed with
+ *  VS_N_HEXADECIMAL_PREFIX, which is not grouped. Strings are formatted by vs_num_formatu(), in time linear in the number of digits.
+ *
+ *  @param anUnsignedLongLong
+ *  @param numberSystemType
+ *  @param groupSize          Number of digits per group, 0 for no grouping.
+ *  @param groupingSeparator  Separator between groups, no grouping if nil or empty.
+ *
+ *  @return The NSString representation of the specified unsigned long long value in the specified number system type.
+ */
++ (NSString *)stringFromUnsignedLongLong:(unsigned long long)anUnsignedLongLong numberSystem:(VSNumberSystemType)numberSystemType groupSize:(NSUInteger)groupSize groupingSeparator:(NSString *)groupingSeparator;
+
 #pragma mark Character Encoding
 
 /**
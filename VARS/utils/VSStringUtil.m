@@ -10,6 +10,7 @@
 
 #import "vsmem.h"
 #import "vsmath.h"
+#import "vsnum.h"
 
 #import "VSMathUtil.h"
 #import "VSStringUtil.h"
@@ -119,6 +120,28 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
     if (isnan(aDouble)) {
         return NANSymbol;
     }
+    else if ([numericFormatSpecifier isEqualToString:VS_N_NUMERIC_FORMAT_DOUBLE]) {
+        // Same digits as %0.16g unless fewer digits parse back to the same double, written with the exponent symbol in a single pass.
+        char buffer[VS_NUM_FORMAT_SIZE + 32];
+        const char *e = exponentSymbol.UTF8String;
+        size_t n = vs_num_format(aDouble, 16, e, NULL, buffer, sizeof(buffer));
+
+        if (n < sizeof(buffer)) {
+            return [NSString stringWithUTF8String:buffer];
+        }
+
+        // Exponent symbol too long for the stack buffer.
+        char *b = malloc(n + 1);
+        NSString *string = nil;
+
+        if (b != NULL) {
+            vs_num_format(aDouble, 16, e, NULL, b, n + 1);
+            string = [NSString stringWithUTF8String:b];
+            free(b);
+        }
+
+        return string;
+    }
     else {
         return [[NSString stringWithFormat:numericFormatSpecifier, aDouble] stringByReplacingOccurrencesOfString:@"e" withString:exponentSymbol];
     }
@@ -246,46 +269,7 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
 }
 
 + (NSString *)stringFromUnsignedChar:(unsigned char)anUnsignedChar numberSystem:(VSNumberSystemType)numberSystemType {
-    switch (numberSystemType) {
-        case VSNumberSystemTypeHexadecimal: {
-            return [NSString stringWithFormat:@"%@%@", VS_N_HEXADECIMAL_PREFIX, [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_HEXADECIMAL, (unsigned long)anUnsignedChar]];
-        }
-
-        case VSNumberSystemTypeOctal: {
-            return [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_OCTAL, (unsigned long)anUnsignedChar];
-        }
-
-        case VSNumberSystemTypeBinary: {
-            NSString *output = @"";
-            NSString *buffer = @"";
-
-            unsigned long n = sizeof(unsigned int) * 8;
-
-            for (unsigned long i = 0; i < n; i++) {
-                unsigned int bit = (anUnsignedChar & 1);
-
-                buffer = [((bit) ? @"1" : @"0") stringByAppendingString:buffer];
-
-                if (bit) {
-                    output = [buffer stringByAppendingString:output];
-                    buffer = @"";
-                }
-
-                anUnsignedChar >>= 1;
-            }
-
-            if ([VSStringUtil stringIsNilOrBlank:output]) {
-                output = @"0";
-            }
-
-            return output;
-        }
-
-        case VSNumberSystemTypeDecimal:
-        default: {
-            return [VSStringUtil stringFromUnsignedChar:anUnsignedChar];
-        }
-    }
+    return [VSStringUtil stringFromUnsignedLongLong:(unsigned long long)anUnsignedChar numberSystem:numberSystemType groupSize:0 groupingSeparator:nil];
 }
 
 + (NSString *)stringFromUnsignedShort:(unsigned short)anUnsignedShort {
@@ -308,46 +292,7 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
 }
 
 + (NSString *)stringFromUnsignedShort:(unsigned short)anUnsignedShort numberSystem:(VSNumberSystemType)numberSystemType {
-    switch (numberSystemType) {
-        case VSNumberSystemTypeHexadecimal: {
-            return [NSString stringWithFormat:@"%@%@", VS_N_HEXADECIMAL_PREFIX, [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_HEXADECIMAL, (unsigned long)anUnsignedShort]];
-        }
-
-        case VSNumberSystemTypeOctal: {
-            return [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_OCTAL, (unsigned long)anUnsignedShort];
-        }
-
-        case VSNumberSystemTypeBinary: {
-            NSString *output = @"";
-            NSString *buffer = @"";
-
-            unsigned long n = sizeof(unsigned int) * 8;
-
-            for (unsigned long i = 0; i < n; i++) {
-                unsigned int bit = (anUnsignedShort & 1);
-
-                buffer = [((bit) ? @"1" : @"0") stringByAppendingString:buffer];
-
-                if (bit) {
-                    output = [buffer stringByAppendingString:output];
-                    buffer = @"";
-                }
-
-                anUnsignedShort >>= 1;
-            }
-
-            if ([VSStringUtil stringIsNilOrBlank:output]) {
-                output = @"0";
-            }
-
-            return output;
-        }
-
-        case VSNumberSystemTypeDecimal:
-        default: {
-            return [VSStringUtil stringFromUnsignedShort:anUnsignedShort];
-        }
-    }
+    return [VSStringUtil stringFromUnsignedLongLong:(unsigned long long)anUnsignedShort numberSystem:numberSystemType groupSize:0 groupingSeparator:nil];
 }
 
 + (NSString *)stringFromUnsignedInt:(unsigned int)anUnsignedInt {
@@ -370,46 +315,7 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
 }
 
 + (NSString *)stringFromUnsignedInt:(unsigned int)anUnsignedInt numberSystem:(VSNumberSystemType)numberSystemType {
-    switch (numberSystemType) {
-        case VSNumberSystemTypeHexadecimal: {
-            return [NSString stringWithFormat:@"%@%@", VS_N_HEXADECIMAL_PREFIX, [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_HEXADECIMAL, (unsigned long)anUnsignedInt]];
-        }
-
-        case VSNumberSystemTypeOctal: {
-            return [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_OCTAL, (unsigned long)anUnsignedInt];
-        }
-
-        case VSNumberSystemTypeBinary: {
-            NSString *output = @"";
-            NSString *buffer = @"";
-
-            unsigned long n = sizeof(unsigned int) * 8;
-
-            for (unsigned long i = 0; i < n; i++) {
-                unsigned int bit = (anUnsignedInt & 1);
-
-                buffer = [((bit) ? @"1" : @"0") stringByAppendingString:buffer];
-
-                if (bit) {
-                    output = [buffer stringByAppendingString:output];
-                    buffer = @"";
-                }
-
-                anUnsignedInt >>= 1;
-            }
-
-            if ([VSStringUtil stringIsNilOrBlank:output]) {
-                output = @"0";
-            }
-
-            return output;
-        }
-
-        case VSNumberSystemTypeDecimal:
-        default: {
-            return [VSStringUtil stringFromUnsignedInt:anUnsignedInt];
-        }
-    }
+    return [VSStringUtil stringFromUnsignedLongLong:(unsigned long long)anUnsignedInt numberSystem:numberSystemType groupSize:0 groupingSeparator:nil];
 }
 
 + (NSString *)stringFromUnsignedLong:(unsigned long)anUnsignedLong {
@@ -432,46 +338,7 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
 }
 
 + (NSString *)stringFromUnsignedLong:(unsigned long)anUnsignedLong numberSystem:(VSNumberSystemType)numberSystemType {
-    switch (numberSystemType) {
-        case VSNumberSystemTypeHexadecimal: {
-            return [NSString stringWithFormat:@"%@%@", VS_N_HEXADECIMAL_PREFIX, [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_HEXADECIMAL, anUnsignedLong]];
-        }
-
-        case VSNumberSystemTypeOctal: {
-            return [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_OCTAL, anUnsignedLong];
-        }
-
-        case VSNumberSystemTypeBinary: {
-            NSString *output = @"";
-            NSString *buffer = @"";
-
-            unsigned long n = sizeof(unsigned long) * 8;
-
-            for (unsigned long i = 0; i < n; i++) {
-                unsigned int bit = (anUnsignedLong & 1);
-
-                buffer = [((bit) ? @"1" : @"0") stringByAppendingString:buffer];
-
-                if (bit) {
-                    output = [buffer stringByAppendingString:output];
-                    buffer = @"";
-                }
-
-                anUnsignedLong >>= 1;
-            }
-
-            if ([VSStringUtil stringIsNilOrBlank:output]) {
-                output = @"0";
-            }
-
-            return output;
-        }
-
-        case VSNumberSystemTypeDecimal:
-        default: {
-            return [VSStringUtil stringFromUnsignedLong:anUnsignedLong];
-        }
-    }
+    return [VSStringUtil stringFromUnsignedLongLong:(unsigned long long)anUnsignedLong numberSystem:numberSystemType groupSize:0 groupingSeparator:nil];
 }
 
 + (NSString *)stringFromUnsignedLongLong:(unsigned long long)anUnsignedLongLong {
@@ -494,46 +361,48 @@ NSString *NSStringFromVSCharacterEncodingType(VSCharacterEncodingType type) {
 }
 
 + (NSString *)stringFromUnsignedLongLong:(unsigned long long)anUnsignedLongLong numberSystem:(VSNumberSystemType)numberSystemType {
-    switch (numberSystemType) {
-        case VSNumberSystemTypeHexadecimal: {
-            return [NSString stringWithFormat:@"%@%@", VS_N_HEXADECIMAL_PREFIX, [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_LONG_HEXADECIMAL, anUnsignedLongLong]];
-        }
-
-        case VSNumberSystemTypeOctal: {
-            return [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_UNSIGNED_LONG_LONG_OCTAL, anUnsignedLongLong];
-        }
-
-        case VSNumberSystemTypeBinary: {
-            NSString *output = @"";
-            NSString *buffer = @"";
-
-            unsigned long n = sizeof(unsigned long long) * 8;
-
-            for (unsigned long i = 0; i < n; i++) {
-                unsigned int bit = (anUnsignedLongLong & 1);
+    return [VSStringUtil stringFromUnsignedLongLong:anUnsignedLongLong numberSystem:numberSystemType groupSize:0 groupingSeparator:nil];
+}
 
-                buffer = [((bit) ? @"1" : @"0") stringByAppendingString:buffer];
++ (NSString *)stringFromUnsignedLongLong:(unsigned long long)anUnsignedLongLong numberSystem:(VSNumberSystemType)numberSystemType groupSize:(NSUInteger)groupSize groupingSeparator:(NSString *)groupingSeparator {
+    unsigned int radix;
 
-                if (bit) {
-                    output = [buffer stringByAppendingString:output];
-                    buffer = @"";
-                }
+    switch (numberSystemType) {
+        case VSNumberSystemTypeHexadecimal: radix = 16; break;
+        case VSNumberSystemTypeOctal:       radix = 8;  break;
+        case VSNumberSystemTypeBinary:      radix = 2;  break;
+        case VSNumberSystemTypeDecimal:
+        default:                            radix = 10; break;
+    }
 
-                anUnsignedLongLong >>= 1;
-            }
+    // Digits are written right to left in a single pass, the hexadecimal prefix ahead of them.
+    char buffer[VS_NUM_FORMATU_SIZE + 64];
+    const char *prefix = (radix == 16) ? VS_N_HEXADECIMAL_PREFIX.UTF8String : "";
+    const char *s = groupingSeparator.UTF8String;
+    unsigned int g = (groupSize > UINT_MAX) ? 0 : (unsigned int)groupSize;
+    size_t p = strlen(prefix);
 
-            if ([VSStringUtil stringIsNilOrBlank:output]) {
-                output = @"0";
-            }
+    if (p < sizeof(buffer)) {
+        memcpy(buffer, prefix, p);
 
-            return output;
+        if (vs_num_formatu(anUnsignedLongLong, radix, g, s, buffer + p, sizeof(buffer) - p) < sizeof(buffer) - p) {
+            return [NSString stringWithUTF8String:buffer];
         }
+    }
 
-        case VSNumberSystemTypeDecimal:
-        default: {
-            return [VSStringUtil stringFromUnsignedLongLong:anUnsignedLongLong];
-        }
+    // Grouping separator too long for the stack buffer.
+    size_t n = p + vs_num_formatu(anUnsignedLongLong, radix, g, s, NULL, 0);
+    char *b = malloc(n + 1);
+    NSString *string = nil;
+
+    if (b != NULL) {
+        memcpy(b, prefix, p);
+        vs_num_formatu(anUnsignedLongLong, radix, g, s, b + p, n + 1 - p);
+        string = [NSString stringWithUTF8String:b];
+        free(b);
     }
+
+    return string;
 }
 
 #pragma mark Character Encoding
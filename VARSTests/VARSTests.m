@@ -7,6 +7,39 @@
 //
 
 #import <XCTest/XCTest.h>
+#import <VARS/VARS.h>
+
+/**
+ *  Number of random cases per randomized test.
+ */
+#define VARS_TESTS_CASES 20000
+
+/**
+ *  Generates deterministic pseudo-random numbers (xorshift64), so that failures are reproducible.
+ *
+ *  @param state Pointer to the non-zero generator state, modified in place.
+ *
+ *  @return The next pseudo-random number.
+ */
+static uint64_t VARSTestsRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+/**
+ *  Verifies whether two double values are the same, NAN included.
+ *
+ *  @param a
+ *  @param b
+ *
+ *  @return YES if both are NAN or equal, NO otherwise.
+ */
+static BOOL VARSTestsIsSameDouble(double a, double b) {
+    return (isnan(a) && isnan(b)) || (a == b);
+}
 
 @interface VARSTests : XCTestCase
 
@@ -24,6 +57,189 @@
     [super tearDown];
 }
 
+#pragma mark Evaluation
+
+- (void)testCompiledEvaluationMatchesPostfixStackEvaluation {
+    NSArray *infixExpressions = @[
+        [NSString stringWithFormat:@"2*x^2+3*x%@1", VS_M_SYMBOL_SUBTRACT],
+        [NSString stringWithFormat:@"(x+1)/(x%@1)", VS_M_SYMBOL_SUBTRACT],
+        [NSString stringWithFormat:@"x/3+0.1*x%@0.2", VS_M_SYMBOL_SUBTRACT],
+        @"sin(x)*cos(x)+tan(x)",
+        @"(x+1)*(x+1)+sin(x+1)",
+        @"ln(abs(x)+1)*abs(x)^0.5"
+    ];
+    double xValues[81];
+    double results[81];
+    NSUInteger count = sizeof(xValues) / sizeof(xValues[0]);
+
+    for (NSUInteger i = 0; i < count; i++) {
+        xValues[i] = ((double)i - 40.0) / 8.0 + 0.1;
+    }
+
+    for (NSString *infixExpression in infixExpressions) {
+        for (VSMathAngleModeType angleMode = VSMathAngleModeTypeDegree; angleMode <= VSMathAngleModeTypeRadian; angleMode++) {
+            NSArray *postfixStack = [VSMathUtil postfixStackFromInfixExpression:infixExpression];
+            VSCompiledExpression *expression = [VSCompiledExpression compiledExpressionWithPostfixStack:postfixStack angleMode:angleMode];
+            VSCompiledExpression *fastExpression = [VSCompiledExpression compiledExpressionWithPostfixStack:postfixStack angleMode:angleMode options:VSMathEvaluationOptionFastArithmetic];
+            VSMemoizedEvaluator *evaluator = [VSMemoizedEvaluator memoizedEvaluatorWithCompiledExpression:expression];
+
+            XCTAssertNotNil(postfixStack, @"%@", infixExpression);
+            XCTAssertNotNil(expression, @"%@", infixExpression);
+            XCTAssertNotNil(evaluator, @"%@", infixExpression);
+
+            VSCompiledExpressionStatusType status = [expression evaluateWithXValues:xValues results:results count:count];
+
+            XCTAssertEqual(status, VSCompiledExpressionStatusTypeSuccess, @"%@", infixExpression);
+
+            for (NSUInteger i = 0; i < count; i++) {
+                double x = xValues[i];
+                NSNumber *number = [VSMathUtil evaluatePostfixStack:postfixStack angleMode:angleMode tokenMap:@{ VS_M_SYMBOL_X_VARIABLE: @(x) }];
+                double expected = (number == nil) ? NAN : number.doubleValue;
+                double compiled = [expression evaluateWithX:x y:NAN status:NULL];
+                double memoized = [evaluator evaluateWithX:x y:NAN status:NULL];
+                double fast = [fastExpression evaluateWithX:x y:NAN status:NULL];
+
+                XCTAssertTrue(VARSTestsIsSameDouble(compiled, expected), @"%@ at x = %.17g: %.17g != %.17g", infixExpression, x, compiled, expected);
+                XCTAssertTrue(VARSTestsIsSameDouble(results[i], expected), @"%@ at x = %.17g: %.17g != %.17g", infixExpression, x, results[i], expected);
+                XCTAssertTrue(VARSTestsIsSameDouble(memoized, expected), @"%@ at x = %.17g: %.17g != %.17g", infixExpression, x, memoized, expected);
+                XCTAssertTrue(VARSTestsIsSameDouble(fast, expected), @"%@ at x = %.17g: %.17g != %.17g", infixExpression, x, fast, expected);
+            }
+        }
+    }
+}
+
+#pragma mark Number Parsing
+
+- (void)testNumberParsingMatchesStrtod {
+    const char *edgeCases[] = {
+        "0.1", "9007199254740993", "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "1.7976931348623157e308", "1.7976931348623158e308", "123456789012345678901234567890", "1e-400", "1e400"
+    };
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    char buffer[96];
+
+    for (size_t i = 0; i < (sizeof(edgeCases) / sizeof(edgeCases[0])); i++) {
+        double value = NAN;
+
+        XCTAssertTrue(vs_num_parse(edgeCases[i], strlen(edgeCases[i]), NULL, NULL, &value), @"%s", edgeCases[i]);
+        XCTAssertEqual(value, strtod(edgeCases[i], NULL), @"%s", edgeCases[i]);
+    }
+
+    for (int i = 0; i < VARS_TESTS_CASES; i++) {
+        uint64_t bits = VARSTestsRandom(&state);
+        double value = NAN;
+
+        if (i & 1) {
+            // Random doubles, printed with up to 20 significant digits.
+            double n;
+
+            memcpy(&n, &bits, sizeof(n));
+
+            if (!isfinite(n)) continue;
+
+            snprintf(buffer, sizeof(buffer), "%.*e", (int)(VARSTestsRandom(&state) % 20), n);
+        }
+        else {
+            // Random mantissas of up to 40 digits, with any exponent.
+            int digits = 1 + (int)(VARSTestsRandom(&state) % 40);
+            int point = (int)(VARSTestsRandom(&state) % (uint64_t)(digits + 1));
+            int length = 0;
+
+            for (int j = 0; j < digits; j++) {
+                if ((j == point) && (j > 0)) buffer[length++] = '.';
+
+                buffer[length++] = (char)('0' + (VARSTestsRandom(&state) % 10));
+            }
+
+            snprintf(buffer + length, sizeof(buffer) - (size_t)length, "e%d", (int)(VARSTestsRandom(&state) % 640) - 330);
+        }
+
+        XCTAssertTrue(vs_num_parse(buffer, strlen(buffer), NULL, NULL, &value), @"%s", buffer);
+        XCTAssertEqual(value, strtod(buffer, NULL), @"%s", buffer);
+    }
+}
+
+#pragma mark Decimal Arithmetic
+
+- (void)testDecimalArithmeticMatchesNSDecimalNumber {
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (int i = 0; i < VARS_TESTS_CASES; i++) {
+        NSDecimalNumber *decimals[2];
+        double values[2];
+
+        // Random decimals of up to 15 significant digits, which vs_dec_fromd() converts exactly.
+        for (int j = 0; j < 2; j++) {
+            int digits = 1 + (int)(VARSTestsRandom(&state) % 15);
+            unsigned long long limit = 1;
+
+            for (int k = 0; k < digits; k++) limit *= 10;
+
+            unsigned long long mantissa = 1 + (VARSTestsRandom(&state) % (limit - 1));
+            int exponent = (int)(VARSTestsRandom(&state) % (uint64_t)(digits + 3));
+            BOOL isNegative = VARSTestsRandom(&state) & 1;
+
+            decimals[j] = [NSDecimalNumber decimalNumberWithMantissa:mantissa exponent:(short)-exponent isNegative:isNegative];
+            values[j] = isNegative ? -((double)mantissa / pow(10.0, exponent)) : ((double)mantissa / pow(10.0, exponent));
+        }
+
+        vs_dec_t x = vs_dec_fromd(values[0]);
+        vs_dec_t y = vs_dec_fromd(values[1]);
+        double results[4] = {
+            vs_dec_tod(vs_dec_add(x, y)),
+            vs_dec_tod(vs_dec_sub(x, y)),
+            vs_dec_tod(vs_dec_mul(x, y)),
+            vs_dec_tod(vs_dec_div(x, y))
+        };
+        NSDecimalNumber *expected[4] = {
+            [decimals[0] decimalNumberByAdding:decimals[1]],
+            [decimals[0] decimalNumberBySubtracting:decimals[1]],
+            [decimals[0] decimalNumberByMultiplyingBy:decimals[1]],
+            [decimals[0] decimalNumberByDividingBy:decimals[1]]
+        };
+
+        // NSDecimalNumber::doubleValue is not correctly rounded, unlike strtod().
+        for (int j = 0; j < 4; j++) {
+            XCTAssertEqual(results[j], strtod(expected[j].stringValue.UTF8String, NULL), @"%@, %@ (operation %d)", decimals[0], decimals[1], j);
+        }
+    }
+}
+
+- (void)testCompensatedArithmeticMatchesDecimalDisplay {
+    uint64_t state = 0xD1B54A32D192ED03ULL;
+
+    XCTAssertEqual(decfastadd(0.1, 0.2), decadd(0.1, 0.2));
+    XCTAssertEqual(decfastdiv(-149.0, 162.0), decdiv(-149.0, 162.0));
+    XCTAssertEqual(decfastdiv(538.5306, 679.3045), decdiv(538.5306, 679.3045));
+
+    for (int i = 0; i < VARS_TESTS_CASES; i++) {
+        double values[2];
+
+        // Short decimals as typed in the calculator, and arbitrary doubles as computed by the samplers.
+        for (int j = 0; j < 2; j++) {
+            if (i & 1) {
+                values[j] = ((double)(VARSTestsRandom(&state) % 100000000) - 50000000.0) / pow(10.0, (double)(VARSTestsRandom(&state) % 8));
+            }
+            else {
+                values[j] = ldexp((double)(VARSTestsRandom(&state) >> 11), (int)(VARSTestsRandom(&state) % 120) - 113);
+            }
+        }
+
+        double x = values[0];
+        double y = values[1];
+        double fast[4] = { decfastadd(x, y), decfastsub(x, y), decfastmul(x, y), decfastdiv(x, y) };
+        double decimal[4] = { decadd(x, y), decsub(x, y), decmul(x, y), decdiv(x, y) };
+
+        for (int j = 0; j < 4; j++) {
+            NSString *fastString = [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_DOUBLE, fast[j]];
+            NSString *decimalString = [NSString stringWithFormat:VS_N_NUMERIC_FORMAT_DOUBLE, decimal[j]];
+
+            XCTAssertEqualObjects(fastString, decimalString, @"%.17g, %.17g (operation %d)", x, y, j);
+            XCTAssertTrue(VARSTestsIsSameDouble(fast[j], decimal[j]), @"%.17g, %.17g (operation %d)", x, y, j);
+        }
+    }
+}
+
 - (void)testExample {
     // This is an example of a functional test case.
     // Use XCTAssert and related functions to verify your tests produce the correct results.